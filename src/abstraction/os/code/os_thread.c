@@ -43,6 +43,134 @@
  */
 
 #include "os_thread.h"
+#include "os_stdlib.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* include OS specific thread implementation			*/
 #include "code/os_thread.c"
+
+/* Parses a comma-separated list of numbers and ranges of numbers, e.g.
+ * "0-3,8", into a bitmask of nbits bits, number i being bit (i % 32)
+ * of mask[i / 32]. */
+static os_result
+os_threadParseIndexList (
+    const char *list,
+    os_uint32 *mask,
+    os_uint32 nbits)
+{
+    const char *p = list;
+
+    memset (mask, 0, (nbits / 32) * sizeof (*mask));
+    while (isspace ((unsigned char) *p)) {
+        p++;
+    }
+    if (*p == '\0' || os_strcasecmp (p, "any") == 0) {
+        return os_resultSuccess;
+    }
+    for (;;) {
+        unsigned long lo, hi, i;
+        char *end;
+
+        if (!isdigit ((unsigned char) *p)) {
+            return os_resultInvalid;
+        }
+        lo = hi = strtoul (p, &end, 10);
+        p = end;
+        if (*p == '-') {
+            p++;
+            if (!isdigit ((unsigned char) *p)) {
+                return os_resultInvalid;
+            }
+            hi = strtoul (p, &end, 10);
+            p = end;
+        }
+        if (lo > hi || hi >= nbits) {
+            return os_resultInvalid;
+        }
+        for (i = lo; i <= hi; i++) {
+            mask[i / 32] |= 1u << (i % 32);
+        }
+        while (isspace ((unsigned char) *p)) {
+            p++;
+        }
+        if (*p == '\0') {
+            return os_resultSuccess;
+        } else if (*p != ',') {
+            return os_resultInvalid;
+        }
+        p++;
+        while (isspace ((unsigned char) *p)) {
+            p++;
+        }
+    }
+}
+
+os_result
+os_threadAttrSetCpuAffinity (
+    os_threadAttr *threadAttr,
+    const char *cpus)
+{
+    os_uint32 mask[OS_THREAD_MAX_CPUS / 32];
+    os_result result;
+
+    assert (threadAttr != NULL);
+    assert (cpus != NULL);
+    if ((result = os_threadParseIndexList (cpus, mask, OS_THREAD_MAX_CPUS)) == os_resultSuccess) {
+        memcpy (threadAttr->cpuAffinity, mask, sizeof (threadAttr->cpuAffinity));
+    }
+    return result;
+}
+
+os_result
+os_threadAttrSetMemPolicy (
+    os_threadAttr *threadAttr,
+    const char *policy)
+{
+    static const struct { const char *name; os_threadMemPolicy policy; } policies[] = {
+        { "default", OS_MEMPOLICY_DEFAULT },
+        { "local", OS_MEMPOLICY_LOCAL },
+        { "bind", OS_MEMPOLICY_BIND },
+        { "preferred", OS_MEMPOLICY_PREFERRED },
+        { "interleave", OS_MEMPOLICY_INTERLEAVE }
+    };
+    os_uint32 mask[OS_THREAD_MAX_MEMNODES / 32];
+    const char *nodes;
+    size_t namelen, i;
+
+    assert (threadAttr != NULL);
+    assert (policy != NULL);
+    while (isspace ((unsigned char) *policy)) {
+        policy++;
+    }
+    nodes = strchr (policy, ':');
+    namelen = (nodes != NULL) ? (size_t) (nodes - policy) : strlen (policy);
+    while (namelen > 0 && isspace ((unsigned char) policy[namelen - 1])) {
+        namelen--;
+    }
+    for (i = 0; i < sizeof (policies) / sizeof (policies[0]); i++) {
+        if (strlen (policies[i].name) == namelen && os_strncasecmp (policy, policies[i].name, namelen) == 0) {
+            break;
+        }
+    }
+    if (i == sizeof (policies) / sizeof (policies[0])) {
+        return os_resultInvalid;
+    }
+    /* default and local take no nodes, the others require at least one */
+    if (policies[i].policy == OS_MEMPOLICY_DEFAULT || policies[i].policy == OS_MEMPOLICY_LOCAL) {
+        if (nodes != NULL) {
+            return os_resultInvalid;
+        }
+        memset (mask, 0, sizeof (mask));
+    } else if (nodes == NULL ||
+               os_threadParseIndexList (nodes + 1, mask, OS_THREAD_MAX_MEMNODES) != os_resultSuccess ||
+               (mask[0] == 0 && mask[1] == 0)) {
+        return os_resultInvalid;
+    }
+    threadAttr->memPolicy = policies[i].policy;
+    threadAttr->memNodes = ((os_uint64) mask[1] << 32) | mask[0];
+    return os_resultSuccess;
+}
@@ -28,6 +28,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 
 /** \brief Initialize thread attributes
  *
@@ -35,6 +36,8 @@
  *   (take the platforms default scheduling class, Time-sharing for
  *   non realtime platforms, Real-time for realtime platforms)
  * - Set \b procAttr->schedPriority to \b 0
+ * - Clear the CPU affinity and set the memory policy to
+ *   \b OS_MEMPOLICY_DEFAULT
  */
 void
 os_threadAttrInit (
@@ -43,4 +46,7 @@ os_threadAttrInit (
     assert (threadAttr != NULL);
     threadAttr->schedClass = OS_SCHED_DEFAULT;
     threadAttr->schedPriority = 0;
+    memset (threadAttr->cpuAffinity, 0, sizeof (threadAttr->cpuAffinity));
+    threadAttr->memPolicy = OS_MEMPOLICY_DEFAULT;
+    threadAttr->memNodes = 0;
 }
@@ -262,4 +262,32 @@ void os_mutexUnlock (os_mutex *mutex)
     abort();
 }
 
+/* The lock contention profiler is not supported on this platform, see
+ * HAVE_LKST for lock tracking on Darwin. */
+void os_mutexLockFrom (os_mutex *mutex, const void *site)
+{
+  OS_UNUSED_ARG (site);
+  os_mutexLock (mutex);
+}
+
+void os_mutexProfileSetRate (os_uint32 rate)
+{
+  OS_UNUSED_ARG (rate);
+}
+
+os_uint32 os_mutexProfileGetRate (void)
+{
+  return 0;
+}
+
+void os_mutexProfileWalk (os_mutexProfileAction action, void *arg)
+{
+  OS_UNUSED_ARG (action);
+  OS_UNUSED_ARG (arg);
+}
+
+void os_mutexProfileReport (void)
+{
+}
+
 #include <../common/code/os_mutex_attr.c>
@@ -204,6 +204,15 @@ OS_API void pa_fence_rel (void);
 
 #endif /* PA_HAVE_INLINE */
 
+/* SPIN HINT: tells the processor that the caller is polling a location
+   that another thread will modify; a full fence where there is nothing
+   better */
+#if defined __GNUC__ && (defined __i386 || defined __x86_64__)
+#define pa_spin_hint() __asm__ __volatile__ ("pause" ::: "memory")
+#else
+#define pa_spin_hint() pa_fence ()
+#endif
+
 #undef OS_API
 
 #if defined (__cplusplus)
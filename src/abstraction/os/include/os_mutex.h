@@ -32,6 +32,7 @@
 
 #include "os_if.h"
 #include "os_stdlib.h"
+#include "os_time.h"
 
 #if defined (__cplusplus)
 extern "C" {
@@ -174,6 +175,76 @@ os_mutexUnlock (
         _Inout_ os_mutex *mutex)
     __nonnull_all__;
 
+/** \brief Acquire the mutex on behalf of a caller
+ *
+ * Equivalent to os_mutexLock, but lock contention is attributed to site
+ * rather than to the immediate caller. Intended for wrappers around
+ * os_mutexLock that pass OS_MUTEX_CALLER() of their own caller.
+ */
+_Acquires_nonreentrant_lock_(&mutex->lock)
+OS_API void
+os_mutexLockFrom(
+        _Inout_ os_mutex *mutex,
+        _In_opt_ const void *site)
+    __nonnull((1));
+
+/** \brief The call site passed to os_mutexLockFrom, if the compiler can
+ *         provide it
+ */
+#if defined __GNUC__
+#define OS_MUTEX_CALLER() __builtin_return_address(0)
+#else
+#define OS_MUTEX_CALLER() NULL
+#endif
+
+/** \brief Lock contention statistics of a call site
+ *
+ * All acquisitions at the site that found the mutex locked are counted,
+ * 1 in rate of those are timed. Durations are in nanoseconds, the hold
+ * time is measured from the moment the waiting thread obtained the mutex.
+ */
+typedef struct os_mutexProfileSummary {
+    const void *site;           /* return address of the lock call */
+    const char *siteName;       /* symbolic form of site, NULL if unknown */
+    os_uint64 contended;        /* number of contended acquisitions */
+    os_uint64 sampled;          /* number of contended acquisitions timed */
+    os_duration waitTotal;
+    os_duration waitMax;
+    os_duration holdTotal;
+    os_duration holdMax;
+} os_mutexProfileSummary;
+
+typedef void (*os_mutexProfileAction)(const os_mutexProfileSummary *summary, void *arg);
+
+/** \brief Sets the lock contention profiling rate of this process
+ *
+ * 0 disables profiling, N times 1 in N contended acquisitions. When
+ * enabled, the results are also reported in the info log at exit.
+ * Profiling is not supported on all platforms.
+ */
+OS_API void
+os_mutexProfileSetRate(
+        os_uint32 rate);
+
+OS_API os_uint32
+os_mutexProfileGetRate(void);
+
+/** \brief Invokes action for every call site at which contention has been
+ *         recorded, in order of decreasing total wait time
+ *
+ * The summary is only valid for the duration of the call.
+ */
+OS_API void
+os_mutexProfileWalk(
+        _In_ os_mutexProfileAction action,
+        _In_opt_ void *arg)
+    __nonnull((1));
+
+/** \brief Reports the lock contention statistics in the info log
+ */
+OS_API void
+os_mutexProfileReport(void);
+
 /** \brief Set the default mutex attributes
  *
  * Postcondition:
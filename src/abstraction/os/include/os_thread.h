@@ -56,6 +56,9 @@ typedef enum os_threadMemoryIndex {
     OS_THREAD_PROCESS_INFO,
     OS_THREAD_STATE, /* Used for monitoring thread progress */
     OS_THREAD_STR_ERROR,
+    OS_THREAD_LATENCY_TRACE, /* Ring buffer of the kernel latency tracer */
+    OS_THREAD_MUTEX_PROFILE, /* Lock contention counters of the mutex profiler */
+    OS_THREAD_READER_TRIGGERS, /* DataReaders with a deferred data available trigger */
     OS_THREAD_MEM_ARRAY_SIZE /* Number of slots in Thread Private Memory */
 } os_threadMemoryIndex;
 
@@ -66,6 +69,27 @@ typedef os_os_threadId os_threadId;
 /** \brief Definition for a thread routine invoked on thread create. */
 typedef void *(*os_threadRoutine)(void*);
 
+/** \brief Highest CPU number + 1 that can be used in a thread CPU affinity */
+#define OS_THREAD_MAX_CPUS 1024
+
+/** \brief Highest NUMA node number + 1 that can be used in a thread memory policy */
+#define OS_THREAD_MAX_MEMNODES 64
+
+/** \brief Definition of the NUMA memory allocation policy of a thread
+ */
+typedef enum os_threadMemPolicy {
+    /** Leave the memory policy of the thread as inherited */
+    OS_MEMPOLICY_DEFAULT,
+    /** Allocate on the node of the CPU the thread runs on */
+    OS_MEMPOLICY_LOCAL,
+    /** Allocate only on the nodes in memNodes */
+    OS_MEMPOLICY_BIND,
+    /** Prefer the lowest-numbered node in memNodes */
+    OS_MEMPOLICY_PREFERRED,
+    /** Interleave allocations over the nodes in memNodes */
+    OS_MEMPOLICY_INTERLEAVE
+} os_threadMemPolicy;
+
 /** \brief Definition of the thread attributes
  */
 typedef struct os_threadAttr {
@@ -75,6 +99,14 @@ typedef struct os_threadAttr {
     os_int32            schedPriority;
     /** Specifies the thread stack size */
     os_uint32           stackSize;
+    /** Specifies the CPUs the thread may run on, CPU i corresponds to
+     *  bit (i % 32) of cpuAffinity[i / 32]; no bits set means the
+     *  thread may run on any CPU */
+    os_uint32           cpuAffinity[OS_THREAD_MAX_CPUS / 32];
+    /** Specifies the NUMA memory allocation policy of the thread */
+    os_threadMemPolicy  memPolicy;
+    /** Specifies the NUMA nodes for memPolicy, node i is bit i */
+    os_uint64           memNodes;
 } os_threadAttr;
 
 /** \brief Definition for hook callbacks */
@@ -240,6 +272,46 @@ os_threadAttrInit(
         os_threadAttr *threadAttr)
     __nonnull_all__;
 
+/** \brief Set the CPU affinity in the thread attributes from a string
+ *
+ * \b cpus is a comma-separated list of CPU numbers and ranges of CPU
+ * numbers, e.g. "0-3,8". An empty string or "any" clears the affinity.
+ *
+ * Possible Results:
+ * - assertion failure: threadAttr = NULL || cpus = NULL
+ * - returns os_resultSuccess if \b cpus is valid
+ * - returns os_resultInvalid if \b cpus is malformed or names a CPU
+ *   number of OS_THREAD_MAX_CPUS or higher, \b threadAttr unchanged
+ */
+OS_API os_result
+os_threadAttrSetCpuAffinity(
+        os_threadAttr *threadAttr,
+        const char *cpus)
+    __nonnull_all__;
+
+/** \brief Set the NUMA memory policy in the thread attributes from a string
+ *
+ * \b policy is one of "default", "local", or one of "bind", "preferred"
+ * and "interleave" followed by a colon and a list of NUMA node numbers
+ * in the same format as accepted by os_threadAttrSetCpuAffinity, e.g.
+ * "bind:0" or "interleave:0-1".
+ *
+ * The policy is applied by the thread itself as it starts, so memory
+ * it allocates and touches first is placed accordingly. It is silently
+ * ignored on platforms without NUMA support.
+ *
+ * Possible Results:
+ * - assertion failure: threadAttr = NULL || policy = NULL
+ * - returns os_resultSuccess if \b policy is valid
+ * - returns os_resultInvalid if \b policy is malformed, \b threadAttr
+ *   unchanged
+ */
+OS_API os_result
+os_threadAttrSetMemPolicy(
+        os_threadAttr *threadAttr,
+        const char *policy)
+    __nonnull_all__;
+
 
 /** \brief Definition for thread private memory destructor */
 typedef int (*os_threadPrivMemDestructor)(void* threadMem, void* userArg);
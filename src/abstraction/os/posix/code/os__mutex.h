@@ -25,4 +25,8 @@
 void os_mutexModuleInit(void);
 void os_mutexModuleExit(void);
 
+/* Ends a timed acquisition of mutex by the calling thread, for operations
+ * that release the mutex other than os_mutexUnlock. */
+void os__mutexProfileRelease(const os_mutex *mutex);
+
 #endif /* OS__MUTEX_H */
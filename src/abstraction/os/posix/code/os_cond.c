@@ -34,6 +34,7 @@
 #include "os_report.h"
 #include "os_abstract.h"
 #include "os__cond.h"
+#include "os__mutex.h"
 
 
 /** \brief The clock used in os_condTimedWait.
@@ -224,6 +225,8 @@ os_condWait (
     assert (cond != NULL);
     assert (mutex != NULL);
 
+    /* The mutex is released while waiting, which ends a timed hold. */
+    os__mutexProfileRelease(mutex);
 #ifdef OSPL_STRICT_MEM
     assert( cond->signature == OS_COND_MAGIC_SIG );
     assert( mutex->signature == OS_MUTEX_MAGIC_SIG );
@@ -274,6 +277,8 @@ os_condTimedWait (
     assert (mutex != NULL);
     assert (OS_DURATION_ISPOSITIVE(timeout));
 
+    os__mutexProfileRelease(mutex);
+
 #ifdef OSPL_STRICT_MEM
     assert( cond->signature == OS_COND_MAGIC_SIG );
     assert( mutex->signature == OS_MUTEX_MAGIC_SIG );
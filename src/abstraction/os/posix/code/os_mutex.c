@@ -33,6 +33,8 @@
 #include <string.h>
 #include "os_errno.h"
 
+#include "../posix/code/os_mutex_profile.c"
+
 static os_boolean ospl_mtx_prio_inherit = OS_FALSE;
 
 #if defined __GLIBC_PREREQ
@@ -188,6 +190,80 @@ os_mutexDestroy (
     }
 }
 
+#ifdef OSPL_STRICT_MEM
+#define OS__PTHREAD_MUTEX(m) (&(m)->mutex)
+#else
+#define OS__PTHREAD_MUTEX(m) (m)
+#endif
+
+/* Takes the mutex while profiling lock contention at site. */
+static int
+os__mutexLockProfiled (
+    os_mutex *mutex,
+    const void *site)
+{
+    struct os_mutexProfileThread *self;
+    os_timeM start;
+    int result;
+
+    if ((result = pthread_mutex_trylock (OS__PTHREAD_MUTEX(mutex))) != EBUSY) {
+        return result;
+    }
+    if ((self = os_mutexProfileSelf()) == NULL) {
+        return pthread_mutex_lock (OS__PTHREAD_MUTEX(mutex));
+    }
+    if (os_mutexProfileSample(self)) {
+        start = os_timeMGet();
+        if ((result = pthread_mutex_lock (OS__PTHREAD_MUTEX(mutex))) == 0) {
+            os_mutexProfileContended(self, mutex, site, &start);
+        }
+    } else {
+        if ((result = pthread_mutex_lock (OS__PTHREAD_MUTEX(mutex))) == 0) {
+            os_mutexProfileContended(self, mutex, site, NULL);
+        }
+    }
+    return result;
+}
+
+static int
+os__mutexLock (
+    os_mutex *mutex,
+    const void *site)
+{
+    assert (mutex != NULL);
+#ifdef OSPL_STRICT_MEM
+    assert(mutex->signature == OS_MUTEX_MAGIC_SIG && "Lock of invalid mutex");
+#endif
+    if (pa_ld32(&os_mutexProfileRate) == 0) {
+        return pthread_mutex_lock (OS__PTHREAD_MUTEX(mutex));
+    }
+    return os__mutexLockProfiled (mutex, site);
+}
+
+/** \brief Acquire the mutex
+ *
+ * \b os_mutexLockFrom calls \b pthread_mutex_lock to acquire
+ * the posix \b mutex. While lock contention is profiled the mutex
+ * is first tried with \b pthread_mutex_trylock, contention is
+ * attributed to \b site.
+ */
+void
+os_mutexLockFrom (
+    os_mutex *mutex,
+    const void *site)
+{
+    int result;
+
+    result = os__mutexLock (mutex, site);
+    if (result != 0) {
+        OS_REPORT(OS_FATAL,"os_mutexLock",0,
+                    "Operation failed: mutex 0x%"PA_PRIxADDR", result = %s",
+                    (os_address)mutex, strerror(result));
+        os_report_dumpStack(__FUNCTION__, __FILE__, __LINE__);
+        abort();
+    }
+}
+
 /** \brief Acquire the mutex
  *
  * \b os_mutexLock calls \b pthread_mutex_lock to acquire
@@ -198,13 +274,8 @@ os_mutexLock (
     os_mutex *mutex)
 {
     int result;
-    assert (mutex != NULL);
-#ifdef OSPL_STRICT_MEM
-    assert(mutex->signature == OS_MUTEX_MAGIC_SIG && "Lock of invalid mutex");
-    result = pthread_mutex_lock (&mutex->mutex);
-#else
-    result = pthread_mutex_lock (mutex);
-#endif
+
+    result = os__mutexLock (mutex, OS_MUTEX_CALLER());
     if (result != 0) {
         OS_REPORT(OS_FATAL,"os_mutexLock",0,
                     "Operation failed: mutex 0x%"PA_PRIxADDR", result = %s",
@@ -221,14 +292,7 @@ os_mutexLock_s (
     int result;
     os_result rv;
 
-    assert (mutex != NULL);
-
-#ifdef OSPL_STRICT_MEM
-    assert(mutex->signature == OS_MUTEX_MAGIC_SIG && "Lock of invalid mutex");
-    result = pthread_mutex_lock (&mutex->mutex);
-#else
-    result = pthread_mutex_lock (mutex);
-#endif
+    result = os__mutexLock (mutex, OS_MUTEX_CALLER());
 
     if (result == 0) {
         rv = os_resultSuccess;
@@ -290,6 +354,9 @@ os_mutexUnlock (
     int result;
 
     assert (mutex != NULL);
+    if (pa_ld32(&os_mutexProfileHeldCount) != 0) {
+        os__mutexProfileRelease(mutex);
+    }
 #ifdef OSPL_STRICT_MEM
     assert(mutex->signature == OS_MUTEX_MAGIC_SIG && "Unlock of invalid mutex");
     result = pthread_mutex_unlock (&mutex->mutex);
@@ -0,0 +1,448 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+/** \file os/posix/code/os_mutex_profile.c
+ *  \brief Lock contention profiler, included by os_mutex.c
+ *
+ * While the rate is non-zero os_mutexLock first tries to take the mutex.
+ * If that fails the acquisition is counted against the call site in
+ * counters private to the calling thread, and 1 in rate of them is timed:
+ * the time spent waiting for the mutex and the time it is held afterwards.
+ * Disabled, the overhead is a single load in os_mutexLock and in
+ * os_mutexUnlock.
+ */
+
+#include "os_atomics.h"
+#include "os_heap.h"
+#include "os_process.h"
+#include "os_thread.h"
+#include "os_time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#if defined __APPLE__ || defined __linux
+#include <execinfo.h>
+#define OS_MUTEX_PROFILE_SYMBOLS
+#endif
+
+/* Number of call sites a thread keeps counters for, must be a power of 2.
+ * Contention at sites beyond that is accounted to an unknown site. */
+#define OS_MUTEX_PROFILE_SITES (128u)
+
+/* Number of timed acquisitions a thread can hold at the same time. */
+#define OS_MUTEX_PROFILE_HELD (8u)
+
+struct os_mutexProfileSite {
+    const void *site;
+    os_uint64 contended;
+    os_uint64 sampled;
+    os_duration waitTotal;
+    os_duration waitMax;
+    os_duration holdTotal;
+    os_duration holdMax;
+};
+
+struct os_mutexProfileHeld {
+    const os_mutex *mutex;
+    struct os_mutexProfileSite *site;
+    os_timeM acquired;
+};
+
+/* Only the owning thread updates the counters. They are read without
+ * synchronisation when the statistics are collected, so a summary may miss
+ * the last few updates (or on 32-bit platforms see a torn 64-bit value),
+ * which is acceptable for a profile.
+ */
+struct os_mutexProfileThread {
+    struct os_mutexProfileThread *next;
+    os_uint32 busy;         /* set while the profiler itself takes locks */
+    os_uint32 count;        /* contended acquisitions, drives the sampling */
+    os_uint32 nheld;
+    struct os_mutexProfileHeld held[OS_MUTEX_PROFILE_HELD];
+    struct os_mutexProfileSite unknown;
+    struct os_mutexProfileSite sites[OS_MUTEX_PROFILE_SITES];
+};
+
+static pa_uint32_t os_mutexProfileRate = PA_UINT32_INIT(0);
+/* Number of timed acquisitions still held over all threads, os_mutexUnlock
+ * only looks for the mutex in the held list of the thread if non-zero. */
+static pa_uint32_t os_mutexProfileHeldCount = PA_UINT32_INIT(0);
+static pa_uint32_t os_mutexProfileAtExitSet = PA_UINT32_INIT(0);
+
+/* The registry is protected by a spinlock rather than an os_mutex so that
+ * it is never itself subject to profiling, in particular not while a thread
+ * is exiting. It is only taken when a thread starts or stops profiling and
+ * when the statistics are collected. */
+static pa_uint32_t os_mutexProfileRegistryLock = PA_UINT32_INIT(0);
+static struct os_mutexProfileThread *os_mutexProfileThreads = NULL;
+/* Accumulated counters of threads that have terminated. */
+static struct os_mutexProfileThread *os_mutexProfileRetired = NULL;
+
+static void
+os_mutexProfileRegistryTake(void)
+{
+    while (!pa_cas32(&os_mutexProfileRegistryLock, 0, 1)) {
+        (void)os_sleep(OS_DURATION_INIT(0, 1000));
+    }
+    pa_fence_acq();
+}
+
+static void
+os_mutexProfileRegistryRelease(void)
+{
+    pa_fence_rel();
+    pa_st32(&os_mutexProfileRegistryLock, 0);
+}
+
+static struct os_mutexProfileSite *
+os_mutexProfileSiteLookup(
+    struct os_mutexProfileThread *t,
+    const void *site)
+{
+    os_address h = ((os_address)site >> 2) * 2654435761u;
+    os_uint32 i, idx;
+
+    if (site == NULL) {
+        return &t->unknown;
+    }
+    for (i = 0; i < OS_MUTEX_PROFILE_SITES; i++) {
+        idx = (os_uint32)(h + i) & (OS_MUTEX_PROFILE_SITES - 1);
+        if (t->sites[idx].site == site) {
+            return &t->sites[idx];
+        } else if (t->sites[idx].site == NULL) {
+            t->sites[idx].site = site;
+            return &t->sites[idx];
+        }
+    }
+    return &t->unknown;
+}
+
+static void
+os_mutexProfileSiteMerge(
+    struct os_mutexProfileSite *dst,
+    const struct os_mutexProfileSite *src)
+{
+    dst->contended += src->contended;
+    dst->sampled += src->sampled;
+    dst->waitTotal += src->waitTotal;
+    dst->holdTotal += src->holdTotal;
+    if (src->waitMax > dst->waitMax) {
+        dst->waitMax = src->waitMax;
+    }
+    if (src->holdMax > dst->holdMax) {
+        dst->holdMax = src->holdMax;
+    }
+}
+
+/* Adds the counters of src to dst, the registry lock must be held. */
+static void
+os_mutexProfileThreadMerge(
+    struct os_mutexProfileThread *dst,
+    const struct os_mutexProfileThread *src)
+{
+    os_uint32 i;
+
+    for (i = 0; i < OS_MUTEX_PROFILE_SITES; i++) {
+        if (src->sites[i].contended != 0) {
+            os_mutexProfileSiteMerge(os_mutexProfileSiteLookup(dst, src->sites[i].site), &src->sites[i]);
+        }
+    }
+    os_mutexProfileSiteMerge(&dst->unknown, &src->unknown);
+}
+
+static struct os_mutexProfileThread *
+os_mutexProfileThreadNew(void)
+{
+    struct os_mutexProfileThread *t;
+
+    t = os_malloc(sizeof(*t));
+    memset(t, 0, sizeof(*t));
+    return t;
+}
+
+static int
+os_mutexProfileThreadExit(
+    void *threadMem,
+    void *arg)
+{
+    struct os_mutexProfileThread *t = *(struct os_mutexProfileThread **)threadMem;
+    struct os_mutexProfileThread **prev;
+
+    OS_UNUSED_ARG(arg);
+
+    os_mutexProfileRegistryTake();
+    for (prev = &os_mutexProfileThreads; *prev != t; prev = &(*prev)->next) {
+        assert(*prev != NULL);
+    }
+    *prev = t->next;
+    if (os_mutexProfileRetired == NULL) {
+        os_mutexProfileRetired = os_mutexProfileThreadNew();
+    }
+    os_mutexProfileThreadMerge(os_mutexProfileRetired, t);
+    os_mutexProfileRegistryRelease();
+    if (t->nheld != 0) {
+        pa_sub32(&os_mutexProfileHeldCount, t->nheld);
+    }
+    os_free(t);
+    return 0;
+}
+
+/* Returns the profiling state of the calling thread, or NULL if the
+ * acquisition must not be profiled. */
+static struct os_mutexProfileThread *
+os_mutexProfileSelf(void)
+{
+    struct os_mutexProfileThread **self, *t;
+
+    if ((self = os_threadMemGet(OS_THREAD_MUTEX_PROFILE)) != NULL) {
+        return (*self)->busy ? NULL : *self;
+    }
+    self = os_threadMemMalloc(OS_THREAD_MUTEX_PROFILE, sizeof(*self), os_mutexProfileThreadExit, NULL);
+    if (self == NULL) {
+        return NULL;
+    }
+    t = os_mutexProfileThreadNew();
+    *self = t;
+    os_mutexProfileRegistryTake();
+    t->next = os_mutexProfileThreads;
+    os_mutexProfileThreads = t;
+    os_mutexProfileRegistryRelease();
+    return t;
+}
+
+/* Returns whether the contended acquisition about to be made by t is timed. */
+static os_boolean
+os_mutexProfileSample(
+    struct os_mutexProfileThread *t)
+{
+    os_uint32 rate = pa_ld32(&os_mutexProfileRate);
+
+    return (rate != 0) && ((++t->count % rate) == 0);
+}
+
+/* Records a contended acquisition of mutex by t, if start is not NULL it is
+ * the time at which the thread started to wait for the mutex. */
+static void
+os_mutexProfileContended(
+    struct os_mutexProfileThread *t,
+    const os_mutex *mutex,
+    const void *site,
+    const os_timeM *start)
+{
+    struct os_mutexProfileSite *s = os_mutexProfileSiteLookup(t, site);
+    os_timeM now;
+    os_duration wait;
+
+    s->contended++;
+    if (start != NULL) {
+        now = os_timeMGet();
+        wait = os_timeMDiff(now, *start);
+        s->sampled++;
+        s->waitTotal += wait;
+        if (wait > s->waitMax) {
+            s->waitMax = wait;
+        }
+        if (t->nheld < OS_MUTEX_PROFILE_HELD) {
+            t->held[t->nheld].mutex = mutex;
+            t->held[t->nheld].site = s;
+            t->held[t->nheld].acquired = now;
+            t->nheld++;
+            pa_inc32(&os_mutexProfileHeldCount);
+        }
+    }
+}
+
+void
+os__mutexProfileRelease(
+    const os_mutex *mutex)
+{
+    struct os_mutexProfileThread **self, *t;
+    struct os_mutexProfileSite *s;
+    os_duration hold;
+    os_uint32 i;
+
+    if ((self = os_threadMemGet(OS_THREAD_MUTEX_PROFILE)) == NULL) {
+        return;
+    }
+    t = *self;
+    for (i = t->nheld; i-- > 0; ) {
+        if (t->held[i].mutex == mutex) {
+            s = t->held[i].site;
+            hold = os_timeMDiff(os_timeMGet(), t->held[i].acquired);
+            s->holdTotal += hold;
+            if (hold > s->holdMax) {
+                s->holdMax = hold;
+            }
+            t->nheld--;
+            memmove(&t->held[i], &t->held[i + 1], (t->nheld - i) * sizeof(t->held[0]));
+            pa_dec32(&os_mutexProfileHeldCount);
+            break;
+        }
+    }
+}
+
+static void
+os_mutexProfileAtExit(void)
+{
+    os_mutexProfileReport();
+}
+
+void
+os_mutexProfileSetRate(
+    os_uint32 rate)
+{
+    if ((rate != 0) && pa_cas32(&os_mutexProfileAtExitSet, 0, 1)) {
+        (void)os_procAtExit(os_mutexProfileAtExit);
+    }
+    pa_st32(&os_mutexProfileRate, rate);
+}
+
+os_uint32
+os_mutexProfileGetRate(void)
+{
+    return pa_ld32(&os_mutexProfileRate);
+}
+
+static int
+os_mutexProfileCompare(
+    const void *va,
+    const void *vb)
+{
+    const struct os_mutexProfileSite *a = va, *b = vb;
+
+    if (a->waitTotal != b->waitTotal) {
+        return (a->waitTotal > b->waitTotal) ? -1 : 1;
+    } else if (a->contended != b->contended) {
+        return (a->contended > b->contended) ? -1 : 1;
+    }
+    return 0;
+}
+
+static void
+os_mutexProfileWalkSite(
+    const struct os_mutexProfileSite *s,
+    os_mutexProfileAction action,
+    void *arg)
+{
+    os_mutexProfileSummary summary;
+#ifdef OS_MUTEX_PROFILE_SYMBOLS
+    char **names = NULL;
+#endif
+
+    summary.site = s->site;
+    summary.siteName = NULL;
+    summary.contended = s->contended;
+    summary.sampled = s->sampled;
+    summary.waitTotal = s->waitTotal;
+    summary.waitMax = s->waitMax;
+    summary.holdTotal = s->holdTotal;
+    summary.holdMax = s->holdMax;
+#ifdef OS_MUTEX_PROFILE_SYMBOLS
+    if ((summary.site != NULL) &&
+        ((names = backtrace_symbols((void * const *)&summary.site, 1)) != NULL)) {
+        summary.siteName = names[0];
+    }
+    action(&summary, arg);
+    free(names);
+#else
+    action(&summary, arg);
+#endif
+}
+
+void
+os_mutexProfileWalk(
+    os_mutexProfileAction action,
+    void *arg)
+{
+    struct os_mutexProfileThread *all, *t, **self;
+    os_uint32 i, n;
+
+    assert(action != NULL);
+
+    /* Locks taken by the action are not profiled. */
+    if ((self = os_threadMemGet(OS_THREAD_MUTEX_PROFILE)) != NULL) {
+        (*self)->busy++;
+    }
+
+    all = os_mutexProfileThreadNew();
+    os_mutexProfileRegistryTake();
+    if (os_mutexProfileRetired != NULL) {
+        os_mutexProfileThreadMerge(all, os_mutexProfileRetired);
+    }
+    for (t = os_mutexProfileThreads; t != NULL; t = t->next) {
+        os_mutexProfileThreadMerge(all, t);
+    }
+    os_mutexProfileRegistryRelease();
+
+    n = 0;
+    for (i = 0; i < OS_MUTEX_PROFILE_SITES; i++) {
+        if (all->sites[i].contended != 0) {
+            all->sites[n++] = all->sites[i];
+        }
+    }
+    qsort(all->sites, n, sizeof(all->sites[0]), os_mutexProfileCompare);
+    for (i = 0; i < n; i++) {
+        os_mutexProfileWalkSite(&all->sites[i], action, arg);
+    }
+    if (all->unknown.contended != 0) {
+        os_mutexProfileWalkSite(&all->unknown, action, arg);
+    }
+    os_free(all);
+
+    if (self != NULL) {
+        (*self)->busy--;
+    }
+}
+
+static void
+os_mutexProfileReportSite(
+    const os_mutexProfileSummary *summary,
+    void *arg)
+{
+    char addr[32];
+    const char *name = summary->siteName;
+
+    OS_UNUSED_ARG(arg);
+
+    if (name == NULL) {
+        if (summary->site != NULL) {
+            (void)snprintf(addr, sizeof(addr), "0x%"PA_PRIxADDR, (os_address)summary->site);
+            name = addr;
+        } else {
+            name = "unknown";
+        }
+    }
+    OS_REPORT(OS_INFO, "os_mutexProfileReport", 0,
+              "%s: %"PA_PRIu64" contended, %"PA_PRIu64" timed, "
+              "wait avg %.1f us max %.1f us, hold avg %.1f us max %.1f us",
+              name, summary->contended, summary->sampled,
+              (summary->sampled != 0) ? (double)summary->waitTotal / (double)summary->sampled / 1e3 : 0.0,
+              (double)summary->waitMax / 1e3,
+              (summary->sampled != 0) ? (double)summary->holdTotal / (double)summary->sampled / 1e3 : 0.0,
+              (double)summary->holdMax / 1e3);
+}
+
+void
+os_mutexProfileReport(void)
+{
+    OS_REPORT(OS_INFO, "os_mutexProfileReport", 0,
+              "Lock contention profile, sample rate %u:",
+              pa_ld32(&os_mutexProfileRate));
+    os_mutexProfileWalk(os_mutexProfileReportSite, NULL);
+}
@@ -48,11 +48,18 @@
 #endif
 #endif
 #include <limits.h>
+#ifdef __linux
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
 
 typedef struct {
     char *threadName;
     void *arguments;
     void *(*startRoutine)(void *);
+    os_uint32 cpuAffinity[OS_THREAD_MAX_CPUS / 32];
+    os_threadMemPolicy memPolicy;
+    os_uint64 memNodes;
 } os_threadContext;
 
 
@@ -307,6 +314,87 @@ os_threadExit (
     return;
 }
 
+#if defined __linux && defined SYS_set_mempolicy
+/* Modes of set_mempolicy(2), defined here to avoid a dependency on libnuma */
+#define OS_MPOL_PREFERRED 1
+#define OS_MPOL_BIND 2
+#define OS_MPOL_INTERLEAVE 3
+#endif
+
+/** \brief Apply the CPU affinity and NUMA memory policy to the calling thread
+ *
+ * Both are set from within the thread itself, before it runs the user
+ * routine, so that all memory the thread touches first is allocated
+ * according to its memory policy. Failures are reported as warnings,
+ * the thread continues without the placement.
+ */
+static void
+os_threadApplyPlacement (
+    const os_threadContext *context)
+{
+#ifdef __linux
+    cpu_set_t cpus;
+    os_uint32 i;
+    int nset = 0;
+
+    CPU_ZERO (&cpus);
+    for (i = 0; i < OS_THREAD_MAX_CPUS && i < CPU_SETSIZE; i++) {
+        if (context->cpuAffinity[i / 32] & (1u << (i % 32))) {
+            CPU_SET (i, &cpus);
+            nset++;
+        }
+    }
+    if (nset > 0) {
+        int result = pthread_setaffinity_np (pthread_self (), sizeof (cpus), &cpus);
+        if (result != 0) {
+            OS_REPORT (OS_WARNING, "os_threadCreate", 2,
+                         "pthread_setaffinity_np failed with error %d (%s) for thread '%s'",
+                         result, os_strError (result), context->threadName);
+        }
+    }
+#endif
+#if defined __linux && defined SYS_set_mempolicy
+    if (context->memPolicy != OS_MEMPOLICY_DEFAULT) {
+        unsigned long nodes[OS_THREAD_MAX_MEMNODES / (8 * sizeof (unsigned long))];
+        const unsigned long *nodesp = nodes;
+        unsigned long maxnode = OS_THREAD_MAX_MEMNODES + 1;
+        int mode;
+
+        memset (nodes, 0, sizeof (nodes));
+        for (i = 0; i < OS_THREAD_MAX_MEMNODES; i++) {
+            if (context->memNodes & ((os_uint64) 1 << i)) {
+                nodes[i / (8 * sizeof (unsigned long))] |= 1ul << (i % (8 * sizeof (unsigned long)));
+            }
+        }
+        switch (context->memPolicy) {
+            case OS_MEMPOLICY_LOCAL:
+                /* Preferred with an empty node set means local allocation */
+                mode = OS_MPOL_PREFERRED;
+                nodesp = NULL;
+                maxnode = 0;
+                break;
+            case OS_MEMPOLICY_BIND:
+                mode = OS_MPOL_BIND;
+                break;
+            case OS_MEMPOLICY_PREFERRED:
+                mode = OS_MPOL_PREFERRED;
+                break;
+            case OS_MEMPOLICY_INTERLEAVE:
+            default:
+                mode = OS_MPOL_INTERLEAVE;
+                break;
+        }
+        if (syscall (SYS_set_mempolicy, mode, nodesp, maxnode) != 0) {
+            int err = os_getErrno ();
+            OS_REPORT (OS_WARNING, "os_threadCreate", 2,
+                         "set_mempolicy failed with error %d (%s) for thread '%s'",
+                         err, os_strError (err), context->threadName);
+        }
+    }
+#endif
+    (void) context;
+}
+
 /** \brief Wrap thread start routine
  *
  * \b os_startRoutineWrapper wraps a threads starting routine.
@@ -338,6 +426,8 @@ os_startRoutineWrapper (
     /* allocate an array to store thread private memory references */
     os_threadMemInit ();
 
+    os_threadApplyPlacement (context);
+
     id = pthread_self();
     /* Call the start callback */
     if (os_threadCBs.startCb(id, os_threadCBs.startArg) == 0) {
@@ -486,6 +576,9 @@ os_threadCreate (
           os_strncpy (threadContext->threadName, name, strlen (name)+1);
           threadContext->startRoutine = start_routine;
           threadContext->arguments = arg;
+          memcpy (threadContext->cpuAffinity, tattr.cpuAffinity, sizeof (threadContext->cpuAffinity));
+          threadContext->memPolicy = tattr.memPolicy;
+          threadContext->memNodes = tattr.memNodes;
 
           /* start the thread */
           result = pthread_attr_setschedparam (&attr, &sched_param);
@@ -35,6 +35,8 @@
  *   (take the platforms default scheduling class, Time-sharing for
  *   non realtime platforms, Real-time for realtime platforms)
  * - Set \b procAttr->schedPriority to \b 0
+ * - Clear the CPU affinity and set the memory policy to
+ *   \b OS_MEMPOLICY_DEFAULT
  */
 void
 os_threadAttrInit (
@@ -44,4 +46,7 @@ os_threadAttrInit (
     threadAttr->schedClass = OS_SCHED_DEFAULT;
     threadAttr->schedPriority = (sched_get_priority_min (SCHED_OTHER) + sched_get_priority_max (SCHED_OTHER)) / 2;
     threadAttr->stackSize = 0;
+    memset (threadAttr->cpuAffinity, 0, sizeof (threadAttr->cpuAffinity));
+    threadAttr->memPolicy = OS_MEMPOLICY_DEFAULT;
+    threadAttr->memNodes = 0;
 }
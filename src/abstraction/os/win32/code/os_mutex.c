@@ -219,3 +219,44 @@ os_mutexUnlock (
             break;
     }
 }
+
+_Acquires_nonreentrant_lock_(&mutex->lock)
+void
+os_mutexLockFrom(
+    _Inout_ os_mutex *mutex,
+    _In_opt_ const void *site)
+{
+    OS_UNUSED_ARG(site);
+    os_mutexLock(mutex);
+}
+
+/** \brief Sets the lock contention profiling rate
+ *
+ * Not (yet) supported on this platform
+ */
+void
+os_mutexProfileSetRate(
+    os_uint32 rate)
+{
+    OS_UNUSED_ARG(rate);
+}
+
+os_uint32
+os_mutexProfileGetRate(void)
+{
+    return 0;
+}
+
+void
+os_mutexProfileWalk(
+    _In_ os_mutexProfileAction action,
+    _In_opt_ void *arg)
+{
+    OS_UNUSED_ARG(action);
+    OS_UNUSED_ARG(arg);
+}
+
+void
+os_mutexProfileReport(void)
+{
+}
@@ -35,6 +35,8 @@
 #include "os__debug.h"
 #include "os_report.h"
 
+#include <string.h>
+
 os_threadInfo id_none = {0, };
 
 typedef struct {
@@ -126,6 +128,8 @@ os_threadMemExit(void)
  *   (take the platforms default scheduling class, Time-sharing for
  *   non realtime platforms, Real-time for realtime platforms)
  * - Set \b procAttr->schedPriority to \b 0
+ * - Clear the CPU affinity and set the memory policy to
+ *   \b OS_MEMPOLICY_DEFAULT
  */
 void
 os_threadAttrInit (
@@ -135,6 +139,9 @@ os_threadAttrInit (
     threadAttr->schedClass = OS_SCHED_DEFAULT;
     threadAttr->schedPriority = 0;
     threadAttr->stackSize = 1024*1024; /* 1MB */
+    memset (threadAttr->cpuAffinity, 0, sizeof (threadAttr->cpuAffinity));
+    threadAttr->memPolicy = OS_MEMPOLICY_DEFAULT;
+    threadAttr->memNodes = 0;
 }
 
 /** \brief Initialize the thread module
@@ -393,6 +400,22 @@ os_threadCreate(
       OS_DEBUG_1("os_threadCreate", "SetThreadPriority failed with %d", (int)os_getErrno());
     }
 
+    /* Only the CPUs that fit in the affinity mask of the thread's
+     * processor group can be used, NUMA memory policies are not
+     * supported. */
+    {
+        DWORD_PTR mask = 0;
+        os_uint32 i;
+        for (i = 0; i < 8 * sizeof (mask) && i < OS_THREAD_MAX_CPUS; i++) {
+            if (threadAttr->cpuAffinity[i / 32] & (1u << (i % 32))) {
+                mask |= (DWORD_PTR) 1 << i;
+            }
+        }
+        if (mask != 0 && SetThreadAffinityMask (threadHandle, mask) == 0) {
+            OS_DEBUG_1("os_threadCreate", "SetThreadAffinityMask failed with %d", (int)os_getErrno());
+        }
+    }
+
    /* ES: dds2086: Close handle should not be performed here. Instead the handle
     * should not be closed until the os_threadWaitExit(...) call is called.
     * CloseHandle (threadHandle);
@@ -24,6 +24,8 @@
 #include "v_dataReaderSample.h"
 #include "v_dataViewInstance.h"
 #include "v_dataViewSample.h"
+#include "v_dataReader.h"
+#include "v_topic.h"
 #include "v_state.h"
 #include "os_report.h"
 
@@ -36,6 +38,11 @@
 
 #define READBUFFERSIZE (32)
 
+/* The buffers following the first read and info buffer are kept for the next
+ * read or take, up to this many, so that reading batches of similar size does
+ * not allocate and free them every time while the reader is locked. */
+#define READBUFFERRETAIN (64)
+
 C_CLASS(cmn_infoField);
 C_CLASS(cmn_infoBuffer);
 C_CLASS(cmn_readBuffer);
@@ -87,14 +94,31 @@ C_STRUCT(cmn_samplesList) {
 
 
 static void
-readListInit(
+readListClear(
     cmn_readList _this)
 {
+    cmn_readBuffer buf, del;
+    cmn_infoBuffer ibuf, idel;
+    os_uint32 n;
+
+    for (buf = &_this->readBuffer, n = 0; (buf->next != NULL) && (n < READBUFFERRETAIN); n++) {
+        buf = buf->next;
+    }
+    while ((del = buf->next) != NULL) {
+        buf->next = del->next;
+        os_free(del);
+    }
+    for (ibuf = &_this->infoBuffer, n = 0; (ibuf->next != NULL) && (n < READBUFFERRETAIN); n++) {
+        ibuf = ibuf->next;
+    }
+    while ((idel = ibuf->next) != NULL) {
+        ibuf->next = idel->next;
+        os_free(idel);
+    }
+
     _this->readBufferLength = 0;
-    _this->readBuffer.next = NULL;
     _this->lastReadBuffer = &_this->readBuffer;
     _this->infoBufferLength = 0;
-    _this->infoBuffer.next = NULL;
     _this->lastInfoBuffer = &_this->infoBuffer;
     _this->prevSample = NULL;
     _this->prevIndex = 0;
@@ -102,6 +126,15 @@ readListInit(
     _this->mrsDisposed = 0;
 }
 
+static void
+readListInit(
+    cmn_readList _this)
+{
+    _this->readBuffer.next = NULL;
+    _this->infoBuffer.next = NULL;
+    readListClear(_this);
+}
+
 static void
 readListFreeContents(
     cmn_readList _this)
@@ -169,8 +202,7 @@ cmn_samplesList_reset (
 {
     assert(_this);
     readListFreeContents(&_this->list);
-    readListFree(&_this->list);
-    readListInit(&_this->list);
+    readListClear(&_this->list);
     _this->maxSamples = max_samples;
 }
 
@@ -204,10 +236,12 @@ cmn_samplesList_insert(
             (list->readBufferLength > 0)) /* but only after the first pre allocated
                                             * buffer is filled */
         {
-            /* Allocate a new buffer */
-            list->lastReadBuffer->next = os_malloc(sizeof(C_STRUCT(cmn_readBuffer)));
+            /* Use the next buffer, allocating it if there is none left */
+            if (list->lastReadBuffer->next == NULL) {
+                list->lastReadBuffer->next = os_malloc(sizeof(C_STRUCT(cmn_readBuffer)));
+                list->lastReadBuffer->next->next = NULL;
+            }
             list->lastReadBuffer = list->lastReadBuffer->next;
-            list->lastReadBuffer->next = NULL;
         }
         list->lastReadBuffer->samples[index] = c_keep(sample);
         list->readBufferLength++;
@@ -227,10 +261,12 @@ cmn_samplesList_insert(
                     (list->infoBufferLength > 0)) /* but only after the first pre allocated
                                                     * buffer is filled */
                 {
-                    /* Allocate a new buffer */
-                    list->lastInfoBuffer->next = os_malloc(sizeof(C_STRUCT(cmn_infoBuffer)));
+                    /* Use the next buffer, allocating it if there is none left */
+                    if (list->lastInfoBuffer->next == NULL) {
+                        list->lastInfoBuffer->next = os_malloc(sizeof(C_STRUCT(cmn_infoBuffer)));
+                        list->lastInfoBuffer->next->next = NULL;
+                    }
                     list->lastInfoBuffer = list->lastInfoBuffer->next;
-                    list->lastInfoBuffer->next = NULL;
                 }
                 field = &list->lastInfoBuffer->infoField[index];
                 field->index = list->readBufferLength-2;
@@ -618,7 +654,7 @@ cmn_samplesList_flush(
         }
         v_kernelProtectStrictReadOnlyExit();
         readListFreeContents(list);
-        readListFree(list);
+        readListClear(list);
     }
     return r;
 }
@@ -657,11 +693,137 @@ cmn_samplesList_flush2(
             copy_action(sample, sampleInfo, copy_arg);
         }
         readListFreeContents(list);
-        readListFree(list);
+        readListClear(list);
+    }
+    return (os_int32) length;
+}
+
+os_int32
+cmn_samplesList_loan(
+    cmn_samplesList _this,
+    cmn_sampleList_loan_func loan_action,
+    void *loan_arg)
+{
+    os_uint32 length;
+    os_uint32 i;
+    cmn_readBuffer buffer;
+    v_dataReaderSample sample;
+    cmn_sampleInfo sampleInfo;
+    v_message message;
+    void *data;
+
+    cmn_readList list = &_this->list;
+
+    assert(loan_action);
+
+    buffer = &list->readBuffer;
+    length = list->readBufferLength;
+    if (length > 0) {
+        for ( i = 0; i < length; i++ ) {
+            os_uint32 bufnum = i % READBUFFERSIZE;
+            if ((bufnum == 0) && (i > 0)) {
+                buffer = buffer->next;
+            }
+            if (_this->isView) {
+                sample = v_dataReaderSample(v_dataViewSampleTemplate(buffer->samples[bufnum])->sample);
+            } else {
+                sample = v_dataReaderSample(buffer->samples[bufnum]);
+            }
+            sampleInfo = &buffer->infos[bufnum];
+
+            /* The message outlives the reader sample, which is freed below. */
+            message = c_keep(v_dataReaderSampleMessage(sample));
+            data = C_DISPLACE(message, C_SIZEOF(v_message));
+
+            loan_action(data, message, sampleInfo, loan_arg);
+        }
+        readListFreeContents(list);
+        readListClear(list);
     }
     return (os_int32) length;
 }
 
+void
+cmn_samplesList_returnLoan(
+    void *messages[],
+    os_uint32 length)
+{
+    os_uint32 i;
+
+    for (i = 0; i < length; i++) {
+        c_free(messages[i]);
+    }
+}
+
+static os_boolean
+loanableType(
+    c_type type)
+{
+    c_array members;
+    os_uint32 i, size;
+
+    type = c_typeActualType(type);
+    switch (c_baseObjectKind(type)) {
+    case M_PRIMITIVE:
+        switch (c_primitive(type)->kind) {
+        case P_BOOLEAN: case P_CHAR: case P_OCTET:
+        case P_SHORT: case P_USHORT: case P_LONG: case P_ULONG:
+        case P_LONGLONG: case P_ULONGLONG: case P_FLOAT: case P_DOUBLE:
+            return OS_TRUE;
+        default:
+            return OS_FALSE;
+        }
+    case M_ENUMERATION:
+        return OS_TRUE;
+    case M_COLLECTION:
+        return (c_collectionType(type)->kind == OSPL_C_ARRAY) &&
+               (c_collectionType(type)->maxSize > 0) &&
+               loanableType(c_collectionType(type)->subType);
+    case M_STRUCTURE:
+        members = c_structure(type)->members;
+        size = c_arraySize(members);
+        for (i = 0; i < size; i++) {
+            if (!loanableType(c_memberType(members[i]))) {
+                return OS_FALSE;
+            }
+        }
+        return OS_TRUE;
+    default:
+        return OS_FALSE;
+    }
+}
+
+static void
+loanableSizeAction(
+    v_public p,
+    void *arg)
+{
+    os_uint32 *size = (os_uint32 *)arg;
+    v_topic topic;
+    c_type type;
+
+    topic = v_dataReaderGetTopic(v_dataReader(p));
+    if (topic) {
+        type = v_topicDataType(topic);
+        if (loanableType(type) && (C_SIZEOF(v_message) % type->alignment) == 0) {
+            *size = (os_uint32) type->size;
+        }
+        c_free(topic);
+    }
+}
+
+os_uint32
+cmn_samplesList_loanableSize(
+    u_dataReader reader)
+{
+    os_uint32 size = 0;
+
+    if (u_observableAction(u_observable(reader), loanableSizeAction, &size) != U_RESULT_OK) {
+        size = 0;
+    }
+    return size;
+}
+
 os_int32
 cmn_samplesList_read(
     cmn_samplesList _this,
@@ -39,6 +39,9 @@
  *
  *  cmn_samplesList_read();
  *  cmn_samplesList_flush();
+ *  cmn_samplesList_loan();
+ *  cmn_samplesList_returnLoan();
+ *  cmn_samplesList_loanableSize();
  *
  *  cmn_samplesList_full();
  *  cmn_samplesList_empty();
@@ -138,6 +141,27 @@ typedef void
         cmn_sampleInfo info,
         void *copy_arg);
 
+/** \brief Callback function to loan samples to the language binding.
+ *
+ * When there are samples within the list, then this callback will be called
+ * by cmn_samplesList_loan(). Instead of copying the sample the language
+ * binding can keep the sample pointer, the message is kept alive until it is
+ * returned by means of cmn_samplesList_returnLoan().
+ *
+ * \param sample   The sample data.
+ * \param message  The message that contains the sample data.
+ * \param info     The sample info.
+ * \param loan_arg The loan_arg provided with the loan() call.
+ *
+ * \return         void
+ */
+typedef void
+(*cmn_sampleList_loan_func)(
+        void *sample,
+        void *message,
+        cmn_sampleInfo info,
+        void *loan_arg);
+
 
 
 /** \brief The class constructor.
@@ -265,6 +289,60 @@ cmn_samplesList_flush2(
     cmn_sampleList_copy_func copy_action,
     void *copy_arg);
 
+/** \brief Loan and remove all single samples.
+ *
+ * Like cmn_samplesList_flush(), but the samples are not copied: the related
+ * samples will be provided by a callback to 'loan_action()' together with a
+ * reference to the message that contains them. Every message must be given
+ * back with cmn_samplesList_returnLoan().
+ *
+ * The kernel must be protected by the caller (e.g. u_readerProtectCopyOutEnter()).
+ *
+ * \param _this       The sampleList.
+ * \param loan_action The loan callback function.
+ * \param loan_arg    The argument passed along with the loan_action calls.
+ *
+ * \return os_int32   The number of loaned samples.
+ */
+OS_API os_int32
+cmn_samplesList_loan(
+    cmn_samplesList _this,
+    cmn_sampleList_loan_func loan_action,
+    void *loan_arg);
+
+/** \brief Return loaned messages.
+ *
+ * Releases the messages provided by cmn_samplesList_loan(). After this call
+ * the sample data of these messages may no longer be accessed.
+ *
+ * The kernel must be protected by the caller (e.g. u_readerProtectCopyOutEnter()).
+ *
+ * \param messages    The loaned messages.
+ * \param length      The number of messages.
+ *
+ * \return            void
+ */
+OS_API void
+cmn_samplesList_returnLoan(
+    void *messages[],
+    os_uint32 length);
+
+/** \brief Return the size of loanable samples of a reader.
+ *
+ * Samples can only be loaned when their layout does not depend on the
+ * language binding, i.e. when the data type only consists of primitives,
+ * enumerations, structures and arrays of those. Strings, sequences, unions
+ * and wide characters require a copy.
+ *
+ * \param reader      The reader.
+ *
+ * \return os_uint32  The size of the sample data when the samples of the
+ *                    reader can be loaned, otherwise 0.
+ */
+OS_API os_uint32
+cmn_samplesList_loanableSize(
+    u_dataReader reader);
+
 /** \brief Check if the list is full.
  *
  * Check if the given sampleList is full.
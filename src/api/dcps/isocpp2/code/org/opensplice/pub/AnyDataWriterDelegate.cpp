@@ -104,6 +104,31 @@ AnyDataWriterDelegate::write(
     ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_writerWrite failed.");
 }
 
+void
+AnyDataWriterDelegate::write_batch(
+    u_writer writer,
+    const std::vector<const void *>& data,
+    const dds::core::Time& timestamp)
+{
+    if (data.empty()) {
+        return;
+    }
+
+    std::vector<struct WriterCopyInfo> info(data.size());
+    std::vector<void *> samples(data.size());
+    os_timeW t = org::opensplice::core::timeUtils::convertTime(timestamp, maxSupportedSeconds_);
+
+    for (std::vector<const void *>::size_type i = 0; i < data.size(); i++) {
+        info[i].helper = this;
+        info[i].data = data[i];
+        samples[i] = &info[i];
+    }
+    u_result uResult = u_writerWriteBatch(
+                           writer, (u_writerCopy)copy_data, &samples[0],
+                           (os_uint32)samples.size(), t);
+    ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_writerWriteBatch failed.");
+}
+
 void
 AnyDataWriterDelegate::writedispose(
     u_writer writer,
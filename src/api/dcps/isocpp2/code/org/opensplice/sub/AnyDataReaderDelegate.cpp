@@ -34,6 +34,8 @@
 #include <org/opensplice/topic/BuiltinTopicCopy.hpp>
 #include <org/opensplice/core/TimeUtils.hpp>
 
+#include <u_user.h>
+#include <u_observable.h>
 #include <v_status.h>
 
 #include "cmn_reader.h"
@@ -55,6 +57,42 @@ struct ReaderCopyInfo {
     const void *key;
 };
 
+/* Keeps the messages of a zero-copy read or take alive until the last
+ * LoanedSamples that refers to them is gone. */
+class LoanedMessages
+{
+public:
+    LoanedMessages(const AnyDataReaderDelegate::ref_type& reader, uint32_t length)
+        : reader_(reader)
+    {
+        /* The samples refer to the loaned messages outside of the domain
+         * protection, so keep the domain attached until they are returned. */
+        domain_ = u_userLookupDomain(
+                u_observableGetDomainId(u_observable(reader_->get_user_handle())));
+        messages_.reserve(length);
+    }
+
+    ~LoanedMessages()
+    {
+        if (!messages_.empty()) {
+            try {
+                reader_->return_loan(&messages_[0], static_cast<uint32_t>(messages_.size()));
+            } catch (...) {
+                /* The loan is lost with the domain. */
+            }
+        }
+        if (domain_) {
+            (void)u_domainClose(domain_);
+        }
+    }
+
+    std::vector<void *> messages_;
+
+private:
+    AnyDataReaderDelegate::ref_type reader_;
+    u_domain domain_;
+};
+
 
 /* For dynamic casting to AnyDataReaderDelegate to work for a few older compilers,
  * it is needed that (at least) the constructor is moved to the cpp file. */
@@ -63,10 +101,17 @@ AnyDataReaderDelegate::AnyDataReaderDelegate(
         const dds::topic::TopicDescription& td)
     : copyIn(NULL), copyOut(NULL), qos_(qos), td_(td)
 {
+    pa_stvoidp(&this->samplesList_, NULL);
+    pa_st32(&this->zeroCopy_, 0);
+    pa_st32(&this->loans_, 0);
 }
 
 AnyDataReaderDelegate::~AnyDataReaderDelegate()
 {
+    cmn_samplesList list = (cmn_samplesList)pa_ldvoidp(&this->samplesList_);
+    if (list) {
+        cmn_samplesList_free(list);
+    }
 }
 
 const dds::topic::TopicDescription&
@@ -200,6 +245,29 @@ AnyDataReaderDelegate::reset_data_available_callback(
     v_statusReset(v_entity(p)->status, V_EVENT_DATA_AVAILABLE);
 }
 
+/* The samples list keeps its buffers between reads and takes, so the list is
+ * cached rather than created for every call. A concurrent read or take finds
+ * the cache empty and uses a list of its own. */
+cmn_samplesList
+AnyDataReaderDelegate::samples_list_acquire(uint32_t max_samples)
+{
+    cmn_samplesList list = (cmn_samplesList)pa_ldvoidp(&this->samplesList_);
+
+    if (list == NULL || !pa_casvoidp(&this->samplesList_, list, NULL)) {
+        list = cmn_samplesList_new((os_boolean)0);
+    }
+    cmn_samplesList_reset(list, max_samples);
+    return list;
+}
+
+void
+AnyDataReaderDelegate::samples_list_release(cmn_samplesList list)
+{
+    if (!pa_casvoidp(&this->samplesList_, NULL, list)) {
+        cmn_samplesList_free(list);
+    }
+}
+
 u_sampleMask
 AnyDataReaderDelegate::getUserMask(const dds::sub::status::DataState& state)
 {
@@ -225,8 +293,7 @@ AnyDataReaderDelegate::read(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_sampleMask uMask = getUserMask(mask);
 
@@ -235,13 +302,12 @@ AnyDataReaderDelegate::read(
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderRead failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -249,7 +315,7 @@ AnyDataReaderDelegate::read(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 void
@@ -259,8 +325,7 @@ AnyDataReaderDelegate::take(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_sampleMask uMask = getUserMask(mask);
 
@@ -269,13 +334,12 @@ AnyDataReaderDelegate::take(
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderTake failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -283,7 +347,7 @@ AnyDataReaderDelegate::take(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 
@@ -295,8 +359,7 @@ AnyDataReaderDelegate::read_instance(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_sampleMask uMask = getUserMask(mask);
 
@@ -307,13 +370,12 @@ AnyDataReaderDelegate::read_instance(
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderReadInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -321,7 +383,7 @@ AnyDataReaderDelegate::read_instance(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 void
@@ -332,8 +394,7 @@ AnyDataReaderDelegate::take_instance(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_sampleMask uMask = getUserMask(mask);
 
@@ -344,13 +405,12 @@ AnyDataReaderDelegate::take_instance(
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderTakeInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -358,7 +418,7 @@ AnyDataReaderDelegate::take_instance(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 void
@@ -369,8 +429,7 @@ AnyDataReaderDelegate::read_next_instance(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_sampleMask uMask = getUserMask(mask);
 
@@ -381,13 +440,12 @@ AnyDataReaderDelegate::read_next_instance(
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderReadNextInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -395,7 +453,7 @@ AnyDataReaderDelegate::read_next_instance(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 void
@@ -406,8 +464,7 @@ AnyDataReaderDelegate::take_next_instance(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_sampleMask uMask = getUserMask(mask);
 
@@ -418,13 +475,12 @@ AnyDataReaderDelegate::take_next_instance(
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(reader));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_dataReaderTakeNextInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(reader));
 
         if (testlength < 0) {
@@ -432,7 +488,7 @@ AnyDataReaderDelegate::take_next_instance(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 
@@ -443,21 +499,19 @@ AnyDataReaderDelegate::read_w_condition(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_result uResult = u_queryRead(query, cmn_reader_action, cmnSampleList, OS_DURATION_ZERO);
     ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryRead failed.");
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryRead failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -465,7 +519,7 @@ AnyDataReaderDelegate::read_w_condition(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 void
@@ -474,21 +528,19 @@ AnyDataReaderDelegate::take_w_condition(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_result uResult = u_queryTake(query, cmn_reader_action, cmnSampleList, OS_DURATION_ZERO);
     ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryTake failed.");
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryTake failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -496,7 +548,7 @@ AnyDataReaderDelegate::take_w_condition(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 void
@@ -506,21 +558,19 @@ AnyDataReaderDelegate::read_instance_w_condition(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_result uResult = u_queryReadInstance(query, handle.delegate().handle(), cmn_reader_action, cmnSampleList, OS_DURATION_ZERO);
     ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryReadInstance failed.");
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryReadInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -528,7 +578,7 @@ AnyDataReaderDelegate::read_instance_w_condition(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 void
@@ -538,21 +588,19 @@ AnyDataReaderDelegate::take_instance_w_condition(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_result uResult = u_queryTakeInstance(query, handle.delegate().handle(), cmn_reader_action, cmnSampleList, OS_DURATION_ZERO);
     ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryTakeInstance failed.");
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryTakeInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -560,7 +608,7 @@ AnyDataReaderDelegate::take_instance_w_condition(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 
@@ -571,21 +619,19 @@ AnyDataReaderDelegate::read_next_instance_w_condition(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_result uResult = u_queryReadNextInstance(query, handle.delegate().handle(), cmn_reader_action, cmnSampleList, OS_DURATION_ZERO);
     ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryReadNextInstance failed.");
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryReadNextInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -593,7 +639,7 @@ AnyDataReaderDelegate::read_next_instance_w_condition(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 void
@@ -603,21 +649,19 @@ AnyDataReaderDelegate::take_next_instance_w_condition(
     dds::sub::detail::SamplesHolder& samples,
     uint32_t max_samples)
 {
-    cmn_samplesList cmnSampleList = cmn_samplesList_new((os_boolean)0);
-    cmn_samplesList_reset(cmnSampleList, max_samples);
+    cmn_samplesList cmnSampleList = samples_list_acquire(max_samples);
 
     u_result uResult = u_queryTakeNextInstance(query, handle.delegate().handle(), cmn_reader_action, cmnSampleList, OS_DURATION_ZERO);
     ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryTakeNextInstance failed.");
 
     uint32_t length = (uint32_t) cmn_samplesList_length(cmnSampleList);
     if (length > 0) {
-        samples.set_length(length);
+        bool loan = this->set_length(samples, length);
 
         uResult = u_readerProtectCopyOutEnter(u_entity(query));
         ISOCPP_U_RESULT_CHECK_AND_THROW(uResult, "u_queryTakeNextInstance failed.");
 
-        FlushActionArguments flushArgs = {*this, samples};
-        int32_t testlength = cmn_samplesList_flush(cmnSampleList, flush_action, &flushArgs);
+        int32_t testlength = this->flush(cmnSampleList, samples, loan);
         u_readerProtectCopyOutExit(u_entity(query));
 
         if (testlength < 0) {
@@ -625,7 +669,7 @@ AnyDataReaderDelegate::take_next_instance_w_condition(
         }
         assert(length == (uint32_t)testlength);
     }
-    cmn_samplesList_free(cmnSampleList);
+    samples_list_release(cmnSampleList);
 }
 
 
@@ -874,6 +918,48 @@ AnyDataReaderDelegate::matched_publication_data(const ::dds::core::InstanceHandl
     return dataSample;
 }
 
+void
+AnyDataReaderDelegate::zero_copy(bool enable, uint32_t sample_size)
+{
+    ISOCPP_REPORT_STACK_DELEGATE_BEGIN(this);
+    org::opensplice::core::ScopedObjectLock scopedLock(*this);
+
+    if (enable && !pa_ld32(&this->zeroCopy_)) {
+        uint32_t size = cmn_samplesList_loanableSize((u_dataReader)(this->userHandle));
+        if ((size == 0) || (size != sample_size)) {
+            ISOCPP_THROW_EXCEPTION(ISOCPP_PRECONDITION_NOT_MET_ERROR,
+                "Zero-copy reads need a type without strings, sequences or unions");
+        }
+    }
+    pa_st32(&this->zeroCopy_, enable ? 1 : 0);
+}
+
+bool
+AnyDataReaderDelegate::zero_copy() const
+{
+    return pa_ld32(&this->zeroCopy_) != 0;
+}
+
+void
+AnyDataReaderDelegate::return_loan(void *messages[], uint32_t length)
+{
+    u_result uResult = u_readerProtectCopyOutEnter(u_entity(this->userHandle));
+    if (uResult == U_RESULT_OK) {
+        cmn_samplesList_returnLoan(messages, length);
+        u_readerProtectCopyOutExit(u_entity(this->userHandle));
+    }
+    pa_sub32(&this->loans_, length);
+}
+
+void
+AnyDataReaderDelegate::check_loans_returned() const
+{
+    if (pa_ld32(&this->loans_) != 0) {
+        ISOCPP_THROW_EXCEPTION(ISOCPP_PRECONDITION_NOT_MET_ERROR,
+            "DataReader still has zero-copy loans outstanding");
+    }
+}
+
 void
 AnyDataReaderDelegate::close()
 {
@@ -923,6 +1009,63 @@ AnyDataReaderDelegate::copy_sample_info(
 }
 
 
+/* The zero-copy setting is read once per read or take, so that sizing
+ * and filling the samples agree when it is changed concurrently. */
+bool
+AnyDataReaderDelegate::set_length(
+    dds::sub::detail::SamplesHolder& samples,
+    uint32_t length)
+{
+    bool loan = (pa_ld32(&this->zeroCopy_) != 0) && samples.loanable();
+
+    if (loan) {
+        samples.set_loaned_length(length);
+    } else {
+        samples.set_length(length);
+    }
+    return loan;
+}
+
+int32_t
+AnyDataReaderDelegate::flush(
+    cmn_samplesList list,
+    dds::sub::detail::SamplesHolder& samples,
+    bool loan)
+{
+    int32_t length;
+
+    if (loan) {
+        AnyDataReaderDelegate::ref_type ref =
+                OSPL_CXX11_STD_MODULE::dynamic_pointer_cast<AnyDataReaderDelegate>(this->get_strong_ref());
+        LoanedMessages *messages = new LoanedMessages(ref, cmn_samplesList_length(list));
+        samples.set_loan(OSPL_CXX11_STD_MODULE::shared_ptr<void>(messages));
+
+        LoanActionArguments loanArgs = {samples, messages->messages_};
+        length = cmn_samplesList_loan(list, loan_action, &loanArgs);
+        pa_add32(&this->loans_, static_cast<uint32_t>(messages->messages_.size()));
+    } else {
+        FlushActionArguments flushArgs = {*this, samples};
+        length = cmn_samplesList_flush(list, flush_action, &flushArgs);
+    }
+    return length;
+}
+
+void
+AnyDataReaderDelegate::loan_action(
+    void *sample,
+    void *message,
+    cmn_sampleInfo sampleInfo,
+    void *args)
+{
+    LoanActionArguments *loanArgs = (LoanActionArguments *) args;
+
+    loanArgs->messages.push_back(message);
+    loanArgs->samples.set_view(sample);
+    copy_sample_info(sampleInfo, loanArgs->samples.info());
+
+    loanArgs->samples++;
+}
+
 void
 AnyDataReaderDelegate::flush_action(
     void *sample,
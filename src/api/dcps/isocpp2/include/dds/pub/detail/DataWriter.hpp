@@ -88,6 +88,13 @@ public:
     void write(const dds::topic::TopicInstance<T>& i,
                const dds::core::Time& timestamp);
 
+    template <typename FWIterator>
+    void write(const FWIterator& begin, const FWIterator& end);
+
+    template <typename FWIterator>
+    void write(const FWIterator& begin, const FWIterator& end,
+               const dds::core::Time& timestamp);
+
     void writedispose(const T& sample);
 
     void writedispose(const T& sample, const dds::core::Time& timestamp);
@@ -123,12 +123,7 @@ DataWriter<T, DELEGATE>::write(const FWIterator& begin, const FWIterator& end)
 {
     ISOCPP_REPORT_STACK_DDS_BEGIN(*this);
 
-    FWIterator b = begin;
-    while(b != end)
-    {
-        this->delegate()->write(*b);
-        ++b;
-    }
+    this->delegate()->write(begin, end);
 }
 
 template <typename T, template <typename Q> class DELEGATE>
@@ -139,12 +134,7 @@ DataWriter<T, DELEGATE>::write(const FWIterator& begin, const FWIterator& end,
 {
     ISOCPP_REPORT_STACK_DDS_BEGIN(*this);
 
-    FWIterator b = begin;
-    while(b != end)
-    {
-        this->delegate()->write(*b, timestamp);
-        ++b;
-    }
+    this->delegate()->write(begin, end, timestamp);
 }
 
 template <typename T, template <typename Q> class DELEGATE>
@@ -642,6 +632,37 @@ dds::pub::detail::DataWriter<T>::writedispose(
                                   timestamp);
 }
 
+template <typename T>
+template <typename FWIterator>
+void
+dds::pub::detail::DataWriter<T>::write(const FWIterator& begin, const FWIterator& end)
+{
+    ISOCPP_REPORT_STACK_DELEGATE_BEGIN(this);
+
+    this->write(begin, end, dds::core::Time::invalid());
+}
+
+template <typename T>
+template <typename FWIterator>
+void
+dds::pub::detail::DataWriter<T>::write(const FWIterator& begin, const FWIterator& end,
+        const dds::core::Time& timestamp)
+{
+    ISOCPP_REPORT_STACK_DELEGATE_BEGIN(this);
+
+    /* All samples are written in a single batch, which claims and locks the
+     * writer and triggers the readers once instead of once per sample. */
+    std::vector<const void *> samples;
+    for (FWIterator b = begin; b != end; ++b) {
+        const T& sample = *b;
+        samples.push_back(&sample);
+    }
+    this->check();
+    AnyDataWriterDelegate::write_batch((u_writer)(this->userHandle),
+                                       samples,
+                                       timestamp);
+}
+
 template <typename T>
 template <typename FWIterator>
 void
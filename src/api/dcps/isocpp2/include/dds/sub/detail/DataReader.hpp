@@ -106,6 +106,11 @@ public:
 
     dds::sub::DataReader<T, dds::sub::detail::DataReader> wrapper();
 
+    /* Vendor specific: when enabled, LoanedSamples refer to the data in the
+     * kernel instead of holding a copy of it. */
+    using AnyDataReaderDelegate::zero_copy;
+    void zero_copy(bool enable);
+
     virtual void listener_notify(ObjectDelegate::ref_type source,
                                  uint32_t       triggerMask,
                                  void           *eventData,
@@ -77,7 +77,18 @@ public:
 
     void resize(uint32_t s)
     {
-         samples_.resize(s);
+        samples_.resize(s);
+        data_.resize(s);
+        for (uint32_t i = 0; i < s; i++) {
+            samples_[i].delegate().bind(&data_[i]);
+        }
+    }
+
+    /* Zero-copy samples only refer to the loaned data, so no data is
+     * allocated for them. */
+    void resize_loaned(uint32_t s)
+    {
+        samples_.resize(s);
     }
 
     dds::sub::Sample<T, dds::sub::detail::Sample>& operator[] (uint32_t i)
@@ -89,9 +100,18 @@ public:
         return this->samples_.data();
     }
 
+    void loan(const OSPL_CXX11_STD_MODULE::shared_ptr<void>& l)
+    {
+        this->loan_ = l;
+    }
+
 
 private:
     LoanedSamplesContainer samples_;
+    /* The data of the samples when they are not loaned. */
+    std::vector<T> data_;
+    /* Keeps the data of zero-copy samples alive. */
+    OSPL_CXX11_STD_MODULE::shared_ptr<void> loan_;
 };
 
 }
@@ -48,46 +48,91 @@ template <typename T>
 class Sample
 {
 public:
-    Sample() { }
-
-    Sample(const T& d, const dds::sub::SampleInfo& i)
+    /* The data of a sample is either:
+     * - a view on loaned data (zero-copy reads), which is only copied
+     *   when it is accessed for writing or the sample is copied,
+     * - a slot in the storage of the LoanedSamples the sample is part of,
+     * - or data owned by the sample itself, allocated on first use.
+     */
+    Sample() : data_(NULL), owned_(false), view_(NULL) { }
+
+    Sample(const T& d, const dds::sub::SampleInfo& i) : data_(new T(d)), owned_(true), view_(NULL)
     {
-        this->data_ = d;
         this->info_ = i;
     }
 
-    Sample(const Sample& other)
+    Sample(const Sample& other) : data_(NULL), owned_(false), view_(NULL)
     {
         copy(other);
     }
 
+    ~Sample()
+    {
+        if (this->owned_) {
+            delete this->data_;
+        }
+    }
+
     Sample& operator=(const Sample& other)
     {
         return copy(other);
     }
 
+    /* A copy never refers to loaned data, it gets its own data instead. */
     Sample& copy(const Sample& other)
     {
-        this->data_ = other.data_;
-        this->info_ = other.info_;
-
+        if (this != &other) {
+            const T* src = other.view_ ? other.view_ : other.data_;
+            if (src) {
+                this->data(*src);
+            } else {
+                this->view_ = NULL;
+                if (this->data_) {
+                    *this->data_ = T();
+                }
+            }
+            this->info_ = other.info_;
+        }
         return *this;
     }
 
 public:
     const T& data() const
     {
-        return data_;
+        return view_ ? *view_ : *storage();
     }
 
     T& data()
     {
-        return data_;
+        return *data_ptr();
     }
 
     void data(const T& d)
     {
-        data_ = d;
+        this->view_ = NULL;
+        if (this->data_) {
+            *this->data_ = d;
+        } else {
+            this->data_ = new T(d);
+            this->owned_ = true;
+        }
+    }
+
+    /* Refer to loaned data instead of holding a copy of it. */
+    void view(const T* v)
+    {
+        view_ = v;
+    }
+
+    /* Use a slot of the LoanedSamples storage for the data. */
+    void bind(T* d)
+    {
+        if (this->owned_) {
+            delete this->data_;
+            this->owned_ = false;
+        }
+        this->data_ = d;
+        this->view_ = NULL;
     }
 
     const dds::sub::SampleInfo& info() const
@@ -112,7 +157,10 @@ public:
 
     T* data_ptr()
     {
-        return &this->data_;
+        if (this->view_) {
+            this->data(*this->view_);
+        }
+        return storage();
     }
 
     dds::sub::SampleInfo *info_ptr()
@@ -122,7 +170,18 @@ public:
 
 
 private:
-    T data_;
+    T* storage() const
+    {
+        if (!this->data_) {
+            this->data_ = new T();
+            this->owned_ = true;
+        }
+        return this->data_;
+    }
+
+    mutable T* data_;
+    mutable bool owned_;
+    const T* view_;
     dds::sub::SampleInfo info_;
 };
 
@@ -49,6 +49,10 @@ public:
         this->samples_.delegate()->resize(len);
     }
 
+    void set_loaned_length(uint32_t len) {
+        this->samples_.delegate()->resize_loaned(len);
+    }
+
     uint32_t get_length() const {
         return this->index;
     }
@@ -69,6 +73,21 @@ public:
         return (*this->samples_.delegate())[this->index].delegate().info_ptr();
     }
 
+    bool loanable() const
+    {
+        return true;
+    }
+
+    void set_loan(const OSPL_CXX11_STD_MODULE::shared_ptr<void>& loan)
+    {
+        this->samples_.delegate()->loan(loan);
+    }
+
+    void set_view(const void *data)
+    {
+        (*this->samples_.delegate())[this->index].delegate().view(static_cast<const T*>(data));
+    }
+
 private:
     dds::sub::LoanedSamples<T>& samples_;
     uint32_t index;
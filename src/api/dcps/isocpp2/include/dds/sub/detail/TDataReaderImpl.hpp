@@ -778,6 +778,8 @@ template <typename T>
 void
 dds::sub::detail::DataReader<T>::close()
 {
+    this->check_loans_returned();
+
     this->listener(NULL, dds::core::status::StatusMask::none());
     this->listener_dispatcher_reset();
 
@@ -828,6 +830,13 @@ dds::sub::detail::DataReader<T>::wrapper()
     return reader;
 }
 
+template <typename T>
+void
+dds::sub::detail::DataReader<T>::zero_copy(bool enable)
+{
+    this->AnyDataReaderDelegate::zero_copy(enable, sizeof(T));
+}
+
 template <typename T>
 void
 dds::sub::detail::DataReader<T>::listener_notify(
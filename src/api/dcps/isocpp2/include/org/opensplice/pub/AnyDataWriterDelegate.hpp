@@ -36,6 +36,7 @@
 #include <dds/topic/TopicDescription.hpp>
 #include <dds/topic/BuiltinTopic.hpp>
 #include <u_writer.h>
+#include <vector>
 
 
 namespace dds { namespace pub {
@@ -141,6 +142,11 @@ protected:
                  const dds::core::InstanceHandle& handle,
                  const dds::core::Time& timestamp);
 
+    void
+    write_batch(u_writer writer,
+                const std::vector<const void *>& data,
+                const dds::core::Time& timestamp);
+
     u_instanceHandle
     register_instance(u_writer writer,
                       const void *data,
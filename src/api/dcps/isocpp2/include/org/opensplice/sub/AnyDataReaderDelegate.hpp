@@ -61,6 +61,7 @@
 
 #include <u_dataReader.h>
 #include "cmn_samplesList.h"
+#include "os_atomics.h"
 
 
 namespace dds { namespace sub {
@@ -90,6 +91,13 @@ public:
     virtual SamplesHolder& operator++(int) = 0;
     virtual void *data() = 0;
     virtual detail::SampleInfo* info() = 0;
+
+    /* Zero-copy reads: a holder that can keep the loan alive gets a
+     * reference to the sample data instead of a copy of it. */
+    virtual bool loanable() const { return false; }
+    virtual void set_loaned_length(uint32_t len) { this->set_length(len); }
+    virtual void set_loan(const OSPL_CXX11_STD_MODULE::shared_ptr<void>&) {}
+    virtual void set_view(const void *) {}
 };
 
 }
@@ -256,6 +264,12 @@ public:
 
     void close();
 
+    void zero_copy(bool enable, uint32_t sample_size);
+    bool zero_copy() const;
+
+    void return_loan(void *messages[], uint32_t length);
+    void check_loans_returned() const;
+
 private:
     static void
     reset_data_available_callback(v_public p, c_voidp arg);
@@ -266,10 +280,26 @@ private:
         dds::sub::detail::SamplesHolder& samples;
     } FlushActionArguments;
 
+    typedef struct LoanActionArguments {
+        dds::sub::detail::SamplesHolder& samples;
+        std::vector<void *>& messages;
+    } LoanActionArguments;
+
+    bool set_length(dds::sub::detail::SamplesHolder& samples, uint32_t length);
+    int32_t flush(cmn_samplesList list, dds::sub::detail::SamplesHolder& samples, bool loan);
+
     static void flush_action(void *sample, cmn_sampleInfo sampleInfo, void *args);
+    static void loan_action(void *sample, void *message, cmn_sampleInfo sampleInfo, void *args);
     static void copy_sample_info(cmn_sampleInfo from, dds::sub::SampleInfo *to);
     static v_copyin_result copy_key(c_type t, const void *data, void *to);
 
+    cmn_samplesList samples_list_acquire(uint32_t max_samples);
+    void samples_list_release(cmn_samplesList list);
+
+    pa_voidp_t samplesList_;
+    pa_uint32_t zeroCopy_;
+    pa_uint32_t loans_;
+
 protected:
     org::opensplice::topic::copyInFunction  copyIn;
     org::opensplice::topic::copyOutFunction copyOut;
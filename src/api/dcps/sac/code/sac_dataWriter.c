@@ -144,6 +144,7 @@ DDS_DataWriterNew (
         _this->copy_in    = DDS_TypeSupportCopyIn(typeSupport);
         _this->copy_out   = DDS_TypeSupportCopyOut(typeSupport);
         _this->copy_cache = DDS_TypeSupportCopyCache(typeSupport);
+        _this->allocSize  = (DDS_unsigned_long)DDS_TypeSupport_get_alloc_size(typeSupport);
 /* TODO       copy_action = DDS_TypeSupportGetWriterCopy(typeSupport);*/
 
         *writer = (DDS_DataWriter)_this;
@@ -984,6 +985,47 @@ DDS_DataWriter_write_w_timestamp (
     return result;
 }
 
+DDS_ReturnCode_t
+DDS_DataWriter_write_batch (
+    DDS_DataWriter _this,
+    const DDS_Sample instance_data,
+    const DDS_unsigned_long length)
+{
+    DDS_ReturnCode_t result;
+    _DataWriter w;
+    u_result uResult;
+    writerInfo *data;
+    void **samples;
+    DDS_unsigned_long i;
+
+    SAC_REPORT_STACK();
+
+    if ((instance_data != NULL) || (length == 0)) {
+        result = DDS_DataWriterCheck(_this, &w);
+        if ((result == DDS_RETCODE_OK) && (length > 0)) {
+            data = os_malloc(length * (sizeof(*data) + sizeof(*samples)));
+            samples = (void **)(data + length);
+            for (i = 0; i < length; i++) {
+                data[i].writer = _this;
+                data[i].data = (void *)((os_address)instance_data + i * w->allocSize);
+                samples[i] = &data[i];
+            }
+            uResult = u_writerWriteBatch(_DataWriter_get_user_entity(w),
+                                         _DataWriterCopy,
+                                         samples,
+                                         length,
+                                         OS_TIMEW_INVALID);
+            result = DDS_ReturnCode_get(uResult);
+            os_free(data);
+        }
+    } else {
+        result = DDS_RETCODE_BAD_PARAMETER;
+        SAC_REPORT(result, "instance_data = NULL");
+    }
+    SAC_REPORT_FLUSH(_this, (result != DDS_RETCODE_OK) && (result != DDS_RETCODE_TIMEOUT));
+    return result;
+}
+
 DDS_ReturnCode_t
 DDS_DataWriter_dispose (
     DDS_DataWriter _this,
@@ -73,7 +73,7 @@ DDS_typeHistoryNew (
 static c_long DDS_copyCacheWrite(DDS_copyCache copyCache,
                                   void *data, c_long size);
 static void DDS_metaObjectBuild(c_type o, DDS_context context);
-static void DDS_cacheStructMember(c_member o, DDS_context context);
+static c_ulong DDS_cacheStructMember(c_structure o, c_ulong mi, DDS_context context);
 static void DDS_cacheUnionLabel(c_literal lit, DDS_context ctx);
 static unsigned int DDS_cacheObjectUserSize(c_type o);
 
@@ -631,11 +631,13 @@ DDS_metaObjectBuild(
     case M_STRUCTURE:
     {
         DDSCopyStruct copyStruct;
+        DDSCopyStruct *csh;
         c_long headerIndex;
-        c_ulong mi;
+        c_ulong mi, memberCount;
+        unsigned int nrOfMembers = 0;
 
         DDSCopyHeader_init(&copyStruct.header, DDSStruct, 0);
-        copyStruct.nrOfMembers = c_arraySize(c_structure(o)->members);
+        copyStruct.nrOfMembers = 0;
         assert (c_typeActualType((c_type)o)->size == (unsigned) c_typeActualType((c_type)o)->size);
         copyStruct.size = (unsigned) c_typeActualType((c_type)o)->size;
         copyStruct.userSize = DDS_cacheObjectUserSize((c_type)o);
@@ -647,9 +649,15 @@ DDS_metaObjectBuild(
 
         TRACE (printf ("Struct\n"));
 
-        for (mi = 0; mi < copyStruct.nrOfMembers; mi++) {
-            DDS_cacheStructMember (c_structureMember(o,mi), context);
+        memberCount = c_structureMemberCount(o);
+        mi = 0;
+        while (mi < memberCount) {
+            mi = DDS_cacheStructMember (c_structure(o), mi, context);
+            nrOfMembers++;
         }
+        /* The cache may have been reallocated while caching the members */
+        csh = (DDSCopyStruct *)((PA_ADDRCAST)context->copyCache->cache + headerIndex);
+        csh->nrOfMembers = nrOfMembers;
         os_free(c_iterTakeFirst (context->typeStack));
         DDS_copyCacheUpdateSize (context->copyCache, headerIndex);
     }
@@ -715,19 +723,56 @@ DDS_metaObjectBuild(
     }
 }
 
-static void
+/* Caches member mi of structure o and returns the index of the next member
+ * that still needs to be cached.
+ *
+ * A run of consecutive members without references (primitives, enums, and
+ * arrays or structures thereof) has the same layout in the database and in
+ * the user representation, padding included, so the whole run is cached as a
+ * single black box. Copying such a run then costs one memcpy instead of a
+ * dispatch per member, which matters for types with many primitive fields.
+ */
+static c_ulong
 DDS_cacheStructMember (
-    c_member o,
+    c_structure o,
+    c_ulong mi,
     DDS_context ctx)
 {
     DDSCopyStructMember member;
+    DDSCopyBlackBox blackBox;
+    c_member m, next;
+    c_type type;
+    os_size_t end;
+    c_ulong last = mi;
 
-    assert (o->offset == (unsigned)o->offset);
-    member.memberOffset = (unsigned)o->offset;
+    m = c_structureMember(o, mi);
+    assert (m->offset == (unsigned)m->offset);
+    member.memberOffset = (unsigned)m->offset;
     TRACE (printf ("    Struct Member @ %d\n", member.memberOffset));
 
     DDS_copyCacheWrite (ctx->copyCache, &member, sizeof(member));
-    DDS_metaObjectBuild (c_specifier(o)->type, ctx);
+
+    type = c_typeActualType(c_memberType(m));
+    if (c_typeHasRef(type)) {
+        DDS_metaObjectBuild (c_specifier(m)->type, ctx);
+    } else {
+        end = m->offset + type->size;
+        while (last + 1 < c_structureMemberCount(o)) {
+            next = c_structureMember(o, last + 1);
+            type = c_typeActualType(c_memberType(next));
+            if (c_typeHasRef(type)) {
+                break;
+            }
+            end = next->offset + type->size;
+            last++;
+        }
+        TRACE (printf ("    BlackBox members %d..%d (%d bytes)\n", mi, last, end - m->offset));
+        DDSCopyHeader_init ((DDSCopyHeader *)&blackBox, DDSBlackBox, sizeof(blackBox));
+        assert ((end - m->offset) == (unsigned) (end - m->offset));
+        blackBox.size = (unsigned) (end - m->offset);
+        DDS_copyCacheWrite (ctx->copyCache, &blackBox, sizeof(blackBox));
+    }
+    return last + 1;
 }
 
 static void
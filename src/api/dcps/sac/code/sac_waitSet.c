@@ -523,6 +523,36 @@ DDS_WaitSet_get_conditions(
     return result;
 }
 
+DDS_ReturnCode_t
+DDS_WaitSet_set_spin(
+    DDS_WaitSet _this,
+    const DDS_Duration_t *limit,
+    DDS_boolean adaptive)
+{
+    DDS_ReturnCode_t result;
+    os_duration uLimit;
+    u_result uResult;
+    _WaitSet ws;
+
+    SAC_REPORT_STACK();
+
+    result = DDS_Duration_copyIn(limit, &uLimit);
+    if ((result == DDS_RETCODE_OK) && (uLimit == OS_DURATION_INFINITE)) {
+        result = DDS_RETCODE_BAD_PARAMETER;
+        SAC_REPORT(result, "Spin limit must be finite");
+    }
+    if (result == DDS_RETCODE_OK) {
+        result = DDS_WaitSetClaim(_this, &ws);
+    }
+    if (result == DDS_RETCODE_OK) {
+        uResult = u_waitsetSetSpin(ws->uWaitset, uLimit, adaptive);
+        result = DDS_ReturnCode_get(uResult);
+        DDS_WaitSetRelease(_this);
+    }
+    SAC_REPORT_FLUSH(_this, result != DDS_RETCODE_OK);
+    return result;
+}
+
 DDS_ReturnCode_t
 DDS_WaitSet_trigger(
     DDS_WaitSet _this,
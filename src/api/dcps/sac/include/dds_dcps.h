@@ -243,6 +243,11 @@ typedef struct DDS_sequence_s *DDS_sequence;
  */
 #define DDS__FooDataWriter_write_w_timestamp DDS_DataWriter_write_w_timestamp
 
+/*
+ *     write_batch
+ */
+#define DDS__FooDataWriter_write_batch DDS_DataWriter_write_batch
+
 /*
  *     dispose
  */
@@ -1502,6 +1507,23 @@ DDS_WaitSet_get_conditions(
     DDS_WaitSet _this,
     DDS_ConditionSeq *attached_conditions);
 
+/*     ReturnCode_t
+ *     set_spin(
+ *         in Duration_t limit,
+ *         in boolean adaptive);
+ *
+ * Makes wait poll the attached conditions for at most limit before blocking,
+ * trading CPU time for wake-up latency. A zero limit (the default) disables
+ * spinning. When adaptive is TRUE, limit is an upper bound and the spin time
+ * follows the recently observed wait times, so spinning stops when events
+ * arrive too far apart to be caught by it.
+ */
+OS_API DDS_ReturnCode_t
+DDS_WaitSet_set_spin(
+    DDS_WaitSet _this,
+    const DDS_Duration_t *limit,
+    DDS_boolean adaptive);
+
 
 /*     WaitSet
  *     WaitSet__alloc (
@@ -3980,6 +4002,20 @@ DDS_DataWriter_write_w_timestamp (
     const DDS_InstanceHandle_t handle,
     const DDS_Time_t *source_timestamp);
 
+/* ReturnCode_t
+ * write_batch(
+ *     in DataSeq instance_data);
+ *
+ * Writes the length consecutive samples at instance_data as if by write with
+ * a nil handle, but claims and locks the writer and triggers the readers only
+ * once for the batch. Writing stops at the first sample that fails.
+ */
+OS_API DDS_ReturnCode_t
+DDS_DataWriter_write_batch (
+    DDS_DataWriter _this,
+    const DDS_Sample instance_data,
+    const DDS_unsigned_long length);
+
 /* ReturnCode_t
  * dispose(
  *     in Data instance_data,
@@ -51,6 +51,8 @@ extern "C" {
 #define CFG_CPUAFFINITY   "CPUAffinity"
 #define CFG_BUILTINTOPICS "BuiltinTopics"
 #define CFG_PRIOINHER     "PriorityInheritance"
+#define CFG_LOCKPROFILING "LockProfiling"
+#define CFG_SAMPLERATE    "SampleRate"
 #define CFG_SYSTEMID      "SystemId"
 #define CFG_SYSTEMIDRANGE   "Range"
 #define CFG_SYSTEMIDENTROPY "UserEntropy"
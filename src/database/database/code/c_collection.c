@@ -126,6 +126,7 @@ C__LIST_CODE_TMPL(static, c__listImpl, c_object, NULL, C__LISTIMPL_EQUALS, C__LI
 C_CLASS(c_setNode);
 C_CLASS(c_bagNode);
 C_CLASS(c_tableNode);
+C_CLASS(c_tableHashSlot);
 
 C_STRUCT(c_list) {
     struct c__listImpl_s x;
@@ -153,6 +154,10 @@ C_STRUCT(c_table) {
     c_array key;
     c_ulong count;
     c_mm mm;
+    c_tableHashSlot hash;  /* optional index of the leaf nodes, NULL if not hashed */
+    c_ulong hashSize;
+    c_ulong hashCount;
+    c_bool hashIntKey;     /* hash is a bijection of a single integer key */
     _STATISTICS_
 };
 
@@ -945,10 +950,417 @@ static const ut_avlTreedef_t c_table_td =
         offsetof (C_STRUCT(c_tableNode), avlnode), offsetof (C_STRUCT(c_tableNode), keyValue),
         tableCmp, 0);
 
+/* Hashed tables additionally index the leaf nodes of the key tree in a flat
+ * open-addressing (linear probing) array, keyed by a hash over all key fields
+ * together (see c_keyHash). Looking up an existing key then costs one hash
+ * computation and a key comparison instead of a tree descent per key field,
+ * each of which boxes the key value in a c_value. The key tree is maintained
+ * as before, so ordered iteration, range reads and cursors are not affected.
+ *
+ * The hash and equality are defined on the raw key field contents, which for
+ * the supported key kinds is equivalent to c_valueCompare returning C_EQ.
+ * Floating point keys (where e.g. 0.0 equals -0.0) are not supported and make
+ * c_tableNewHashed fall back to a plain table.
+ *
+ * Tables keyed by a single integer field (the common case for instance tables
+ * of topics keyed by an id) hash the key with an invertible mix instead. The
+ * hash then identifies the key, so a probe only compares the hashes stored in
+ * the slots and never has to visit the node or the key fields.
+ */
+C_STRUCT(c_tableHashSlot) {
+    c_ulonglong hash;
+    c_tableNode node;
+};
+
+#define C_TABLE_HASH_MINSIZE (16)
+
+static c_bool
+tableKeyHashable (
+    c_array key)
+{
+    c_ulong i, nrOfKeys;
+
+    nrOfKeys = (key == NULL) ? 0 : c_arraySize (key);
+    if (nrOfKeys == 0) {
+        return FALSE;
+    }
+    for (i = 0; i < nrOfKeys; i++) {
+        switch (c_fieldValueKind (key[i])) {
+        case V_FLOAT:
+        case V_DOUBLE:
+        case V_FIXED:
+        case V_UNDEFINED:
+        case V_COUNT:
+            return FALSE;
+        default:
+            break;
+        }
+    }
+    return TRUE;
+}
+
+static c_bool
+tableKeyIsInteger (
+    c_valueKind kind)
+{
+    switch (kind) {
+    case V_BOOLEAN: case V_OCTET: case V_CHAR:
+    case V_SHORT: case V_USHORT: case V_WCHAR:
+    case V_LONG: case V_ULONG:
+    case V_LONGLONG: case V_ULONGLONG:
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+static os_size_t
+tableKeySize (
+    c_valueKind kind)
+{
+    switch (kind) {
+    case V_BOOLEAN:   return sizeof (c_bool);
+    case V_OCTET:     return sizeof (c_octet);
+    case V_CHAR:      return sizeof (c_char);
+    case V_SHORT:     return sizeof (c_short);
+    case V_USHORT:    return sizeof (c_ushort);
+    case V_WCHAR:     return sizeof (c_wchar);
+    case V_LONG:      return sizeof (c_long);
+    case V_ULONG:     return sizeof (c_ulong);
+    case V_LONGLONG:  return sizeof (c_longlong);
+    case V_ULONGLONG: return sizeof (c_ulonglong);
+    case V_FLOAT:     return sizeof (c_float);
+    case V_DOUBLE:    return sizeof (c_double);
+    case V_ADDRESS:   return sizeof (c_address);
+    case V_OBJECT:    return sizeof (c_object);
+    case V_VOIDP:     return sizeof (c_voidp);
+    default:
+        /* not part of the hash */
+        return 0;
+    }
+}
+
+/* FNV-1a (64-bit) over the contents of a key field. For string kinds p points
+ * to the string reference, for other kinds to the value itself, which allows
+ * hashing both object fields and the contents of a c_value.
+ */
+#define C_TABLE_HASH_BASIS PA_UINT64_C(14695981039346656037)
+#define C_TABLE_HASH_PRIME PA_UINT64_C(1099511628211)
+
+static c_ulonglong
+tableKeyFieldHash (
+    c_ulonglong h,
+    c_valueKind kind,
+    const void *p)
+{
+    const c_octet *b;
+    os_size_t j, n;
+
+    if (p == NULL) {
+        return (h ^ 0xffU) * C_TABLE_HASH_PRIME;
+    } else if ((kind == V_STRING) || (kind == V_WSTRING)) {
+        if ((b = *(const c_octet * const *) p) == NULL) {
+            return (h ^ 0xffU) * C_TABLE_HASH_PRIME;
+        }
+        while (*b) {
+            h = (h ^ *b++) * C_TABLE_HASH_PRIME;
+        }
+        /* separate the strings of consecutive key fields */
+        return h * C_TABLE_HASH_PRIME;
+    } else {
+        b = p;
+        n = tableKeySize (kind);
+        for (j = 0; j < n; j++) {
+            h = (h ^ b[j]) * C_TABLE_HASH_PRIME;
+        }
+        return h;
+    }
+}
+
+static c_ulonglong
+tableKeyHashFinish (
+    c_ulonglong h)
+{
+    /* 0 is reserved to mark a hash that has not been computed */
+    return (h == 0) ? 1 : h;
+}
+
+/* Hash of a single integer key field: the finalizer of splitmix64, which is
+ * a bijection on 64-bit values. Only the key mapping to 0 and a key that
+ * cannot be reached (a NULL reference on the field path) share their hash (1)
+ * with another key, so lookups compare the key fields for that hash only.
+ */
+static c_ulonglong
+tableKeyIntHash (
+    c_valueKind kind,
+    const void *p)
+{
+    c_ulonglong h;
+
+    if (p == NULL) {
+        return 1;
+    }
+    switch (tableKeySize (kind)) {
+    case 1: h = *(const c_octet *) p; break;
+    case 2: h = *(const c_ushort *) p; break;
+    case 4: h = *(const c_ulong *) p; break;
+    default: h = *(const c_ulonglong *) p; break;
+    }
+    h = (h ^ (h >> 30)) * PA_UINT64_C(0xbf58476d1ce4e5b9);
+    h = (h ^ (h >> 27)) * PA_UINT64_C(0x94d049bb133111eb);
+    h = h ^ (h >> 31);
+    return tableKeyHashFinish (h);
+}
+
+static c_bool
+tableKeyFieldEqual (
+    c_valueKind kind,
+    const void *pa,
+    const void *pb)
+{
+    if ((pa == NULL) || (pb == NULL)) {
+        return (pa == pb);
+    } else if ((kind == V_STRING) || (kind == V_WSTRING)) {
+        const c_char *sa = *(const c_char * const *) pa;
+        const c_char *sb = *(const c_char * const *) pb;
+        return (sa == sb) || ((sa != NULL) && (sb != NULL) && (strcmp (sa, sb) == 0));
+    } else {
+        return (memcmp (pa, pb, tableKeySize (kind)) == 0);
+    }
+}
+
+static c_ulonglong
+tableKeyHash (
+    C_STRUCT(c_table) *table,
+    c_object o)
+{
+    return c_keyHash (table->key, o);
+}
+
+static c_bool
+tableKeyEqual (
+    C_STRUCT(c_table) *table,
+    c_object a,
+    c_array keyList,
+    c_object b)
+{
+    c_ulong i, nrOfKeys = c_arraySize (table->key);
+
+    for (i = 0; i < nrOfKeys; i++) {
+        if (!tableKeyFieldEqual (c_fieldValueKind (table->key[i]),
+                                 c_fieldGetAddress (table->key[i], a),
+                                 c_fieldGetAddress (keyList[i], b))) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* Returns the leaf node of which the key equals the keyList fields of o,
+ * where keyList is either the key of the table or a list of fields with the
+ * same value kinds (see c_tableFindHashed).
+ */
+static c_tableNode
+tableHashLookup (
+    C_STRUCT(c_table) *table,
+    c_ulonglong hash,
+    c_array keyList,
+    c_object o)
+{
+    c_ulong mask = table->hashSize - 1;
+    c_ulong i = (c_ulong) hash & mask;
+    c_tableHashSlot slot;
+
+    while ((slot = &table->hash[i])->node != NULL) {
+        if ((slot->hash == hash) &&
+            ((table->hashIntKey && (hash != 1)) ||
+             tableKeyEqual (table, slot->node->contents.object, keyList, o))) {
+            return slot->node;
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+/* Looks up the leaf node for the key values of c_tableFind. Returns FALSE if
+ * the kinds of the values do not match the key fields, in which case the key
+ * tree must be searched instead.
+ */
+static c_bool
+tableHashLookupValues (
+    C_STRUCT(c_table) *table,
+    const c_value *keyValues,
+    c_tableNode *node)
+{
+    c_ulonglong h = C_TABLE_HASH_BASIS;
+    c_ulong i, nrOfKeys = c_arraySize (table->key);
+    c_ulong mask = table->hashSize - 1;
+    c_ulong j;
+    c_tableHashSlot slot;
+
+    for (i = 0; i < nrOfKeys; i++) {
+        c_valueKind kind = c_fieldValueKind (table->key[i]);
+        if (keyValues[i].kind != kind) {
+            return FALSE;
+        }
+        if (!table->hashIntKey) {
+            h = tableKeyFieldHash (h, kind, &keyValues[i].is);
+        }
+    }
+    if (table->hashIntKey) {
+        h = tableKeyIntHash (keyValues[0].kind, &keyValues[0].is);
+    } else {
+        h = tableKeyHashFinish (h);
+    }
+    *node = NULL;
+    j = (c_ulong) h & mask;
+    while (((slot = &table->hash[j])->node != NULL) && (*node == NULL)) {
+        if (slot->hash == h) {
+            for (i = 0; (i < nrOfKeys) &&
+                        tableKeyFieldEqual (keyValues[i].kind,
+                                            c_fieldGetAddress (table->key[i], slot->node->contents.object),
+                                            &keyValues[i].is); i++) {
+                /* compare next key field */
+            }
+            if (i == nrOfKeys) {
+                *node = slot->node;
+            }
+        }
+        j = (j + 1) & mask;
+    }
+    return TRUE;
+}
+
+static void
+tableHashPut (
+    c_tableHashSlot slots,
+    c_ulong size,
+    c_ulonglong hash,
+    c_tableNode node)
+{
+    c_ulong mask = size - 1;
+    c_ulong i = (c_ulong) hash & mask;
+
+    while (slots[i].node != NULL) {
+        i = (i + 1) & mask;
+    }
+    slots[i].hash = hash;
+    slots[i].node = node;
+}
+
+static c_bool
+tableHashResize (
+    C_STRUCT(c_table) *table,
+    c_ulong size)
+{
+    c_tableHashSlot slots;
+    c_ulong i;
+
+    slots = c_mmMalloc (table->mm, size * C_SIZEOF(c_tableHashSlot));
+    if (slots == NULL) {
+        return FALSE;
+    }
+    memset (slots, 0, size * C_SIZEOF(c_tableHashSlot));
+    for (i = 0; i < table->hashSize; i++) {
+        if (table->hash[i].node != NULL) {
+            tableHashPut (slots, size, table->hash[i].hash, table->hash[i].node);
+        }
+    }
+    c_mmFree (table->mm, table->hash);
+    table->hash = slots;
+    table->hashSize = size;
+    return TRUE;
+}
+
+static void
+tableHashInsert (
+    C_STRUCT(c_table) *table,
+    c_ulonglong hash,
+    c_tableNode node)
+{
+    /* Keep the load factor below 3/4 */
+    if (4 * (table->hashCount + 1) > 3 * table->hashSize) {
+        if (!tableHashResize (table, 2 * table->hashSize)) {
+            /* Out of memory: continue as a plain table */
+            c_mmFree (table->mm, table->hash);
+            table->hash = NULL;
+            table->hashSize = 0;
+            table->hashCount = 0;
+            return;
+        }
+    }
+    tableHashPut (table->hash, table->hashSize, hash, node);
+    table->hashCount++;
+}
+
+static void
+tableHashRemove (
+    C_STRUCT(c_table) *table,
+    c_tableNode node)
+{
+    c_ulong mask = table->hashSize - 1;
+    c_ulong i, j, k;
+
+    i = (c_ulong) tableKeyHash (table, node->contents.object) & mask;
+    while (table->hash[i].node != node) {
+        assert (table->hash[i].node != NULL);
+        i = (i + 1) & mask;
+    }
+    /* Backward shift deletion: move later entries of the probe sequence into
+     * the hole, as long as that does not move them before their home slot. */
+    j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (table->hash[j].node == NULL) {
+            break;
+        }
+        k = (c_ulong) table->hash[j].hash & mask;
+        if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) {
+            continue;
+        }
+        table->hash[i] = table->hash[j];
+        i = j;
+    }
+    table->hash[i].node = NULL;
+    table->hashCount--;
+
+    if ((table->hashSize > C_TABLE_HASH_MINSIZE) && (8 * table->hashCount < table->hashSize)) {
+        /* Failing to shrink is harmless */
+        (void) tableHashResize (table, table->hashSize / 2);
+    }
+}
+
+c_ulonglong
+c_keyHash (
+    c_array keyList,
+    c_object o)
+{
+    c_ulonglong h = C_TABLE_HASH_BASIS;
+    c_ulong i, nrOfKeys = (keyList == NULL) ? 0 : c_arraySize (keyList);
+    c_valueKind kind;
+
+    if ((nrOfKeys == 1) && tableKeyIsInteger (kind = c_fieldValueKind (keyList[0]))) {
+        return tableKeyIntHash (kind, c_fieldGetAddress (keyList[0], o));
+    }
+    for (i = 0; i < nrOfKeys; i++) {
+        h = tableKeyFieldHash (h, c_fieldValueKind (keyList[i]), c_fieldGetAddress (keyList[i], o));
+    }
+    return tableKeyHashFinish (h);
+}
+
 static union c_tableContents *c_tableLookupInsert (C_STRUCT(c_table) *table, c_object o)
 {
     union c_tableContents *index;
     c_ulong i, nrOfKeys;
+    c_ulonglong hash = 0;
+    if (table->hash != NULL) {
+        c_tableNode f;
+        hash = tableKeyHash (table, o);
+        if ((f = tableHashLookup (table, hash, table->key, o)) != NULL) {
+            _CHECK_CONSISTENCY_ (table, f);
+            return &f->contents;
+        }
+    }
     nrOfKeys = c_arraySize (table->key);
     index = &table->contents;
     for (i = 0; i < nrOfKeys; i++) {
@@ -967,6 +1379,9 @@ static union c_tableContents *c_tableLookupInsert (C_STRUCT(c_table) *table, c_o
             f->table = table;
 #endif
             ut_avlInsertIPath (&c_table_td, &index->tree, f, &p);
+            if ((i == nrOfKeys-1) && (table->hash != NULL)) {
+                tableHashInsert (table, hash, f);
+            }
         } else {
             c_valueFreeRef (k);
             _CHECK_CONSISTENCY_ (table, f);
@@ -1066,8 +1481,19 @@ c_tableRemove (
             ut_avlDPath_t path;
         } *stk;
         C_STRUCT(c_tableNode) root_index;
+        c_tableNode leaf = NULL;
         c_ulong i;
 
+        if (table->hash != NULL) {
+            /* Resolve misses and refused removals (e.g. c_find) without
+             * descending the key tree */
+            leaf = tableHashLookup (table, tableKeyHash (table, o), table->key, o);
+            if ((leaf == NULL) || ((condition != 0) && !condition (leaf->contents.object, o, arg))) {
+                _ACCESS_END_ (table);
+                return NULL;
+            }
+        }
+
         stk = os_alloca ((nrOfKeys+1) * sizeof (*stk));
 
         root_index.contents = table->contents;
@@ -1082,9 +1508,13 @@ c_tableRemove (
             _CHECK_CONSISTENCY_ (table, stk[i+1].node);
         }
 
-        if (condition == 0 || condition (stk[i].node->contents.object, o, arg)) {
+        assert ((leaf == NULL) || (leaf == stk[i].node));
+        if (leaf != NULL || condition == 0 || condition (stk[i].node->contents.object, o, arg)) {
             object = stk[i].node->contents.object;
             table->count--;
+            if (table->hash != NULL) {
+                tableHashRemove (table, stk[i].node);
+            }
             /* delete object */
             if (table->cursor[i-1] == stk[i].node) {
                 table->cursor[i-1] = ut_avlFindPred (&c_table_td, &stk[i-1].node->contents.tree, stk[i].node);
@@ -1135,6 +1565,11 @@ c_tableFind (
             goto notfound;
         }
         object = table->contents.object;
+    } else if ((table->hash != NULL) && tableHashLookupValues (table, keyValues, &found)) {
+        if (found == NULL) {
+            goto notfound;
+        }
+        object = found->contents.object;
     } else {
         contents = &table->contents;
         for (i = 0; i < nrOfKeys; i++) {
@@ -1154,6 +1589,64 @@ notfound:
 }
 #endif
 
+static c_bool
+tableKeyListMatches (
+    C_STRUCT(c_table) *table,
+    c_array keyList)
+{
+    c_ulong i, nrOfKeys = c_arraySize (table->key);
+
+    for (i = 0; i < nrOfKeys; i++) {
+        if (c_fieldValueKind (table->key[i]) != c_fieldValueKind (keyList[i])) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+c_object
+c_tableFindHashed (
+    c_table _this,
+    c_ulonglong hash,
+    c_array keyList,
+    c_object o)
+{
+    C_STRUCT(c_table) *table = (C_STRUCT(c_table) *)_this;
+    union c_tableContents *contents;
+    c_tableNode found;
+    c_object object = NULL;
+    c_ulong i, nrOfKeys;
+    c_value k;
+
+    assert(c_collectionIsType(_this, OSPL_C_DICTIONARY));
+    assert(hash == c_keyHash(keyList, o));
+
+    _READ_BEGIN_(table);
+
+    nrOfKeys = (table->key == NULL) ? 0 : c_arraySize(table->key);
+    assert(nrOfKeys == ((keyList == NULL) ? 0 : c_arraySize(keyList)));
+    if (nrOfKeys == 0) {
+        object = table->contents.object;
+    } else if ((table->hash != NULL) && tableKeyListMatches (table, keyList)) {
+        if ((found = tableHashLookup (table, hash, keyList, o)) != NULL) {
+            object = found->contents.object;
+        }
+    } else {
+        contents = &table->contents;
+        for (i = 0; (i < nrOfKeys) && (contents != NULL); i++) {
+            k = c_fieldValue (keyList[i], o);
+            found = ut_avlLookup (&c_table_td, &contents->tree, &k);
+            c_valueFreeRef (k);
+            contents = (found != NULL) ? &found->contents : NULL;
+        }
+        if (contents != NULL) {
+            object = contents->object;
+        }
+    }
+    _READ_END_(table);
+    return c_keep (object);
+}
+
 static c_tableNode
 tableNext(
     c_object o,
@@ -1623,6 +2116,7 @@ C_STRUCT(tableTakeActionArg) {
     c_ulong count;
     c_bool proceed;
     c_mm mm;
+    C_STRUCT(c_table) *table;
 #ifdef _CONSISTENCY_CHECKING_
     C_STRUCT(c_table) *t;
 #endif
@@ -1640,6 +2134,9 @@ static void tableTakeActionDeleteDisposed (c_tableNode n, tableTakeActionArg arg
     c_tableNode d = arg->disposed;
     ut_avlDelete (&c_table_td, &n->contents.tree, d);
     if (arg->keyIndex == c_arraySize(arg->key)) {
+        if (arg->table->hash != NULL) {
+            tableHashRemove(arg->table, d);
+        }
         c_free(d->contents.object);
     }
     c_valueFreeRef(d->keyValue);
@@ -1750,6 +2247,7 @@ c_tableTake (
         }
     } else {
         a.mm = MM(table);
+        a.table = table;
         a.key = table->key;
         a.action = action;
         a.arg = arg;
@@ -2948,10 +3446,11 @@ c_bagNew(
 #undef C_BAG_ANONYMOUS_NAME
 
 #define C_TABLE_ANONYMOUS_NAME "MAP<******>"
-c_collection
-c_tableNew(
+static c_collection
+tableNew(
     c_type subType,
-    const c_char *keyNames)
+    const c_char *keyNames,
+    c_bool hashed)
 {
     c_base base;
     c_iter keyNameList, fieldList;
@@ -3060,11 +3559,38 @@ c_tableNew(
         } else {
             ut_avlInit (&c_table_td, &t->contents.tree);
         }
+        t->hash = NULL;
+        t->hashSize = 0;
+        t->hashCount = 0;
+        t->hashIntKey = (nrOfKeys == 1) && tableKeyIsInteger(c_fieldValueKind(t->key[0]));
+        if (hashed && tableKeyHashable(t->key)) {
+            t->hash = c_mmMalloc(t->mm, C_TABLE_HASH_MINSIZE * C_SIZEOF(c_tableHashSlot));
+            if (t->hash != NULL) {
+                memset(t->hash, 0, C_TABLE_HASH_MINSIZE * C_SIZEOF(c_tableHashSlot));
+                t->hashSize = C_TABLE_HASH_MINSIZE;
+            }
+        }
     }
     return (c_collection)t;
 }
 #undef C_TABLE_ANONYMOUS_NAME
 
+c_collection
+c_tableNew(
+    c_type subType,
+    const c_char *keyNames)
+{
+    return tableNew(subType, keyNames, FALSE);
+}
+
+c_collection
+c_tableNewHashed(
+    c_type subType,
+    const c_char *keyNames)
+{
+    return tableNew(subType, keyNames, TRUE);
+}
+
 #if 0
 c_collection
 c_queryNew(
@@ -3210,6 +3736,10 @@ c_clear (
         }
         c_free(c_table(c)->key);
         c_free(c_table(c)->cursor);
+        if (c_table(c)->hash != NULL) {
+            c_mmFree(c_table(c)->mm, c_table(c)->hash);
+            c_table(c)->hash = NULL;
+        }
     break;
     case OSPL_C_SET:
         while ((o = c_take(c)) != NULL) {
@@ -52,10 +52,11 @@ void
 c_mutexLock (
     c_mutex *mtx)
 {
+    /* Lock contention is attributed to the caller of c_mutexLock. */
 #ifdef NDEBUG
-    os_mutexLock(mtx);
+    os_mutexLockFrom(mtx, OS_MUTEX_CALLER());
 #else
-    os_mutexLock(&mtx->mtx);
+    os_mutexLockFrom(&mtx->mtx, OS_MUTEX_CALLER());
     mtx->owner = os_threadIdSelf();
 #endif
 }
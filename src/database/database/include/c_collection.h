@@ -55,6 +55,7 @@
  *     c_set    c_setNew       (c_type subType);
  *     c_bag    c_bagNew       (c_type subType);
  *     c_table  c_tableNew     (c_type subType, const c_char *keyNames);
+ *     c_table  c_tableNewHashed (c_type subType, const c_char *keyNames);
  *     c_query  c_queryNew     (c_collection c, q_expr predicate,
  *                              c_value params[]);
  *
@@ -236,6 +237,32 @@ c_tableNew (
     c_type subType,
     const c_char *keyNames);
 
+/**
+ * \brief This operation constructs a table collection object that also
+ *        maintains a hash index on its key.
+ *
+ * The table behaves as a table created by c_tableNew, but lookups of existing
+ * key values (c_tableInsert, c_replace, c_remove) use a hash over all key
+ * fields instead of descending the key tree one key field at a time. This
+ * costs some additional memory per element and is intended for large tables
+ * that are accessed mostly by key, such as instance tables.
+ *
+ * If a key field has a floating point type, the table is created without
+ * hash index.
+ *
+ * \param subType The element type of the table that must be created.
+ * \param keyNames A comma seperated list of field names that specify the
+ * table key value.
+ *
+ * \return On a successful operation the created table object.
+ *         Otherwise this method will return NULL, detailed error information
+ *         is reported to the os report facility.
+ */
+OS_API c_table
+c_tableNewHashed (
+    c_type subType,
+    const c_char *keyNames);
+
 /**
  * \brief This operation constructs a query collection object.
  *
@@ -823,6 +850,47 @@ c_tableFind (
     c_value *keyValues);
 #endif
 
+/**
+ * \brief This operation returns the key hash of an object as used by
+ *        hashed tables.
+ *
+ * The hash covers the values of the given fields in the given order and is
+ * never 0, so 0 can be used to mark a hash that has not yet been computed.
+ *
+ * \param keyList The key fields of the object.
+ * \param o The object of which the key hash is computed.
+ *
+ * \return The key hash.
+ */
+OS_API c_ulonglong
+c_keyHash (
+    c_array keyList,
+    c_object o);
+
+/**
+ * \brief This table operation looks up the element with the key of o, using
+ *        a key hash computed before by c_keyHash.
+ *
+ * The keyList specifies the key fields of o, which need not be of the same
+ * type as the table elements, but must correspond one to one with the key
+ * fields of the table. This allows looking up an element by another object
+ * carrying the same key (e.g. a message) without constructing a template
+ * element. Tables that are not hashed are searched by key value.
+ *
+ * \param _this The table.
+ * \param hash The key hash of o, as returned by c_keyHash(keyList, o).
+ * \param keyList The key fields of o.
+ * \param o The object providing the key values.
+ *
+ * \return The found element (kept), or NULL.
+ */
+OS_API c_object
+c_tableFindHashed (
+    c_table _this,
+    c_ulonglong hash,
+    c_array keyList,
+    c_object o);
+
 OS_API c_bool
 c_tableWalk(
     c_table _this,
@@ -26,6 +26,7 @@
 #include "os_thread.h"
 #include "os_heap.h"
 #include "os_mutex.h"
+#include "os_atomics.h"
 
 #include "c_base.h"
 #include "c_collection.h"
@@ -45,6 +46,13 @@
 #define UNUSED_ARG_NDEBUG(x) UNUSED_ARG (x)
 #endif
 
+#if defined __GNUC__ && (defined __x86_64__ || defined __i386__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define BSWAP_ARRAY_X86 1
+#include <immintrin.h>
+#else
+#define BSWAP_ARRAY_X86 0
+#endif
+
 #if defined PA_LITTLE_ENDIAN
 #define BE_NEEDS_BSWAP 1
 #else
@@ -3200,24 +3208,137 @@ static int serprog_exec (struct sd_cdrSerdata *sd, const struct serprog *prog, c
   }
 }
 
-/******************** SERIALIZE VM (SWAPPED) ********************/
+/******************** BULK BYTE SWAP ********************/
+
+/* Swapping arrays of primitives (sequences, arrays, and the arrays
+   convstruct_discover_primarray makes of runs of struct members) is
+   where the swapped VMs spend most of their time on large samples.
+   On x86 these use SSSE3 or AVX2 byte shuffles when the CPU supports
+   them, the choice being made on first use; anything short or left
+   over goes through the scalar loop. Neither source nor destination
+   needs to be aligned. */
+
+#define BSWAP_ARRAY_IMPL_UNKNOWN 0
+#define BSWAP_ARRAY_IMPL_SCALAR 1
+#define BSWAP_ARRAY_IMPL_SSSE3 2
+#define BSWAP_ARRAY_IMPL_AVX2 3
+
+/* Arrays shorter than this many bytes aren't worth a vector kernel */
+#define BSWAP_ARRAY_MIN_VECTOR 32
+
+#define BSWAP_ARRAY_SCALAR(width) static void bswap_array_##width##_scalar (char *dst, const char *src, size_t n) { \
+    size_t i;                                   \
+    for (i = 0; i < n; i++) {                   \
+      serprog_uint##width##_t v;                \
+      memcpy (&v, src, (width));                \
+      v = bswap##width##u (v);                  \
+      memcpy (dst, &v, (width));                \
+      src += (width);                           \
+      dst += (width);                           \
+    }                                           \
+  }
+BSWAP_ARRAY_SCALAR (2)
+BSWAP_ARRAY_SCALAR (4)
+BSWAP_ARRAY_SCALAR (8)
+
+#if BSWAP_ARRAY_X86
+/* pshufb/vpshufb masks reversing the bytes of each element, indexed by
+   log2 of the element width; vpshufb shuffles within 128-bit lanes, so
+   the second half repeats the first */
+static const unsigned char bswap_array_mask[4][32] = {
+  { 0 },
+  { 1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14, 1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14 },
+  { 3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12, 3,2,1,0,7,6,5,4,11,10,9,8,15,14,13,12 },
+  { 7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8, 7,6,5,4,3,2,1,0,15,14,13,12,11,10,9,8 }
+};
 
-#define SER_OPER_COPY_MULTIPLE_SWAP(width) static void ser_oper_copy_multiple_swap_##width (char *dst, const char *src, os_uint32 n) { \
-    const serprog_uint##width##_t *tsrc =       \
-      (const serprog_uint##width##_t *) src;    \
-    serprog_uint##width##_t *tdst;              \
-    os_uint32 i;                                \
-    tdst = (serprog_uint##width##_t *) dst;     \
-    for (i = 0; i < n; i++)                     \
-      *tdst++ = bswap##width##u (*tsrc++);      \
+#define BSWAP_ARRAY_SSSE3(width, lg2_width) __attribute__ ((target ("ssse3"))) static void bswap_array_##width##_ssse3 (char *dst, const char *src, size_t n) { \
+    const __m128i mask = _mm_loadu_si128 ((const __m128i *) bswap_array_mask[lg2_width]); \
+    const size_t nbytes = n << (lg2_width);     \
+    size_t i;                                   \
+    for (i = 0; i + 16 <= nbytes; i += 16) {    \
+      const __m128i x = _mm_loadu_si128 ((const __m128i *) (src + i)); \
+      _mm_storeu_si128 ((__m128i *) (dst + i), _mm_shuffle_epi8 (x, mask)); \
+    }                                           \
+    bswap_array_##width##_scalar (dst + i, src + i, (nbytes - i) >> (lg2_width)); \
+  }
+BSWAP_ARRAY_SSSE3 (2, 1)
+BSWAP_ARRAY_SSSE3 (4, 2)
+BSWAP_ARRAY_SSSE3 (8, 3)
+
+#define BSWAP_ARRAY_AVX2(width, lg2_width) __attribute__ ((target ("avx2"))) static void bswap_array_##width##_avx2 (char *dst, const char *src, size_t n) { \
+    const __m256i mask = _mm256_loadu_si256 ((const __m256i *) bswap_array_mask[lg2_width]); \
+    const size_t nbytes = n << (lg2_width);     \
+    size_t i;                                   \
+    for (i = 0; i + 64 <= nbytes; i += 64) {    \
+      const __m256i x0 = _mm256_loadu_si256 ((const __m256i *) (src + i)); \
+      const __m256i x1 = _mm256_loadu_si256 ((const __m256i *) (src + i + 32)); \
+      _mm256_storeu_si256 ((__m256i *) (dst + i), _mm256_shuffle_epi8 (x0, mask)); \
+      _mm256_storeu_si256 ((__m256i *) (dst + i + 32), _mm256_shuffle_epi8 (x1, mask)); \
+    }                                           \
+    if (i + 32 <= nbytes) {                     \
+      const __m256i x = _mm256_loadu_si256 ((const __m256i *) (src + i)); \
+      _mm256_storeu_si256 ((__m256i *) (dst + i), _mm256_shuffle_epi8 (x, mask)); \
+      i += 32;                                  \
+    }                                           \
+    bswap_array_##width##_ssse3 (dst + i, src + i, (nbytes - i) >> (lg2_width)); \
   }
-SER_OPER_COPY_MULTIPLE_SWAP (2)
-SER_OPER_COPY_MULTIPLE_SWAP (4)
-SER_OPER_COPY_MULTIPLE_SWAP (8)
+BSWAP_ARRAY_AVX2 (2, 1)
+BSWAP_ARRAY_AVX2 (4, 2)
+BSWAP_ARRAY_AVX2 (8, 3)
+
+static pa_uint32_t bswap_array_impl = PA_UINT32_INIT (BSWAP_ARRAY_IMPL_UNKNOWN);
+
+static os_uint32 bswap_array_select (void)
+{
+  /* Racing threads all arrive at the same answer, so a plain store
+     suffices */
+  os_uint32 impl = BSWAP_ARRAY_IMPL_SCALAR;
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    impl = BSWAP_ARRAY_IMPL_AVX2;
+  else if (__builtin_cpu_supports ("ssse3"))
+    impl = BSWAP_ARRAY_IMPL_SSSE3;
+  pa_st32 (&bswap_array_impl, impl);
+  return impl;
+}
+
+#define BSWAP_ARRAY(width) static void bswap_array_##width (char *dst, const char *src, os_uint32 n) { \
+    os_uint32 impl;                             \
+    if ((size_t) n * (width) < BSWAP_ARRAY_MIN_VECTOR) { \
+      bswap_array_##width##_scalar (dst, src, n); \
+      return;                                   \
+    }                                           \
+    if ((impl = pa_ld32 (&bswap_array_impl)) == BSWAP_ARRAY_IMPL_UNKNOWN) \
+      impl = bswap_array_select ();             \
+    switch (impl)                               \
+    {                                           \
+      case BSWAP_ARRAY_IMPL_AVX2:               \
+        bswap_array_##width##_avx2 (dst, src, n); \
+        break;                                  \
+      case BSWAP_ARRAY_IMPL_SSSE3:              \
+        bswap_array_##width##_ssse3 (dst, src, n); \
+        break;                                  \
+      default:                                  \
+        bswap_array_##width##_scalar (dst, src, n); \
+        break;                                  \
+    }                                           \
+  }
+#else
+#define BSWAP_ARRAY(width) static void bswap_array_##width (char *dst, const char *src, os_uint32 n) { \
+    bswap_array_##width##_scalar (dst, src, n); \
+  }
+#endif
+BSWAP_ARRAY (2)
+BSWAP_ARRAY (4)
+BSWAP_ARRAY (8)
+
+/******************** SERIALIZE VM (SWAPPED) ********************/
+
 #define SER_OPER_COPY_MULTIPLE_SWAP_0(n) memcpy (*dst, *src, (n))
-#define SER_OPER_COPY_MULTIPLE_SWAP_1(n) ser_oper_copy_multiple_swap_2 (*dst, *src, n)
-#define SER_OPER_COPY_MULTIPLE_SWAP_2(n) ser_oper_copy_multiple_swap_4 (*dst, *src, n)
-#define SER_OPER_COPY_MULTIPLE_SWAP_3(n) ser_oper_copy_multiple_swap_8 (*dst, *src, n)
+#define SER_OPER_COPY_MULTIPLE_SWAP_1(n) bswap_array_2 (*dst, *src, n)
+#define SER_OPER_COPY_MULTIPLE_SWAP_2(n) bswap_array_4 (*dst, *src, n)
+#define SER_OPER_COPY_MULTIPLE_SWAP_3(n) bswap_array_8 (*dst, *src, n)
 
 #define SER_SLOWPATH_MULTIPLE_SWAP(OPER, oper, lg2_width) static int ser_slowpath_##oper##_multiple_swap_##lg2_width ( \
           const struct sd_cdrControl *control,                          \
@@ -3616,21 +3737,159 @@ static int serprog_exec_swap (struct sd_cdrSerdata *sd, const struct serprog *pr
   }
 }
 
-/******************** DESERIALIZE VM (STRAIGHT) ********************/
+/******************** DESERIALIZE SOURCE ********************/
+
+/* The deserializers read from a window [src, srclimit) of the input,
+   with offset 0 of the input at address blobaddr. Contiguous input is
+   a single window. Fragmented input (segs != NULL) is read one
+   fragment at a time: deser_window moves to the next fragment and
+   gathers a primitive that straddles two fragments in a bounce
+   buffer, deser_copy copies arrays and strings piecewise. Either way,
+   the fast path is just the check against srclimit. */
+
+struct deser_segs {
+  const struct sd_cdrFragment *frags;
+  unsigned nfrags;
+  unsigned idx;       /* fragment containing the current position */
+  os_uint32 fragpos;  /* offset of frags[idx] in the input */
+  os_uint32 size;     /* total size of the input */
+  union { serprog_uint8_t align; char buf[8]; } bounce;
+};
+
+struct deser_window {
+  const char *src;
+  const char *srclimit;
+  os_address blobaddr;
+};
+
+static int deser_window (struct deser_segs *segs, os_uint32 pos, os_uint32 amount, struct deser_window *w)
+{
+  const struct sd_cdrFragment *f;
+  os_uint32 off;
+  if (segs == NULL || pos > segs->size || amount > segs->size - pos)
+    return SD_CDR_INVALID;
+  /* the position never moves backwards */
+  while (segs->idx < segs->nfrags && pos - segs->fragpos >= segs->frags[segs->idx].size)
+  {
+    segs->fragpos += segs->frags[segs->idx].size;
+    segs->idx++;
+  }
+  if (segs->idx == segs->nfrags)
+  {
+    /* at the end of the input, only an empty window is possible */
+    w->src = w->srclimit = segs->bounce.buf;
+  }
+  else
+  {
+    f = &segs->frags[segs->idx];
+    off = pos - segs->fragpos;
+    if (amount <= f->size - off)
+    {
+      w->src = (const char *) f->data + off;
+      w->srclimit = (const char *) f->data + f->size;
+    }
+    else if (amount <= sizeof (segs->bounce.buf))
+    {
+      /* straddles fragments: gather it, once it has been consumed the
+         next check finds the end of the bounce buffer and resumes in
+         the fragment following it */
+      unsigned i = segs->idx;
+      os_uint32 n, k = 0;
+      while (k < amount)
+      {
+        n = segs->frags[i].size - off;
+        if (n > amount - k)
+          n = amount - k;
+        memcpy (segs->bounce.buf + k, (const char *) segs->frags[i].data + off, n);
+        k += n;
+        off = 0;
+        i++;
+      }
+      w->src = segs->bounce.buf;
+      w->srclimit = segs->bounce.buf + amount;
+    }
+    else
+    {
+      return SD_CDR_INVALID;
+    }
+  }
+  w->blobaddr = (os_address) w->src - pos;
+  return 0;
+}
+
+static int deser_copy (struct deser_segs *segs, char *dst, os_uint32 n, struct deser_window *w)
+{
+  os_uint32 pos = (os_uint32) ((os_address) w->src - w->blobaddr);
+  int rc;
+  if (segs == NULL || pos > segs->size || n > segs->size - pos)
+    return SD_CDR_INVALID;
+  while (n > 0)
+  {
+    os_uint32 m;
+    if (w->src >= w->srclimit)
+    {
+      pos = (os_uint32) ((os_address) w->src - w->blobaddr);
+      if ((rc = deser_window (segs, pos, 1, w)) < 0)
+        return rc;
+    }
+    m = (os_uint32) (w->srclimit - w->src);
+    if (m > n)
+      m = n;
+    memcpy (dst, w->src, m);
+    dst += m;
+    w->src += m;
+    n -= m;
+  }
+  return 0;
+}
 
 /* FIXME: natural alignment on input guaranteed to be 4,
    so can't do address-based alignment and need to use
    memcpy (on some platforms) for 8 byte objects */
+#define SRC_POS() ((os_uint32) ((os_address) src - blobaddr))
+#define SRC_ALIGN(align) do {                                           \
+    src = (const char *) (blobaddr + alignup_address ((os_address) src - blobaddr, (align))); \
+  } while (0)
+#define SRC_MOVE(amount) do {                                           \
+    struct deser_window w_;                                             \
+    int rc_;                                                            \
+    if ((rc_ = deser_window (segs, SRC_POS (), (amount), &w_)) < 0)     \
+      return rc_;                                                       \
+    src = w_.src;                                                       \
+    srclimit = w_.srclimit;                                             \
+    blobaddr = w_.blobaddr;                                             \
+  } while (0)
 #define SRC_CHECK_ALIGN(amount, align) do {                             \
-    src = blob + alignup_address ((os_address) (src - blob), (align));  \
+    SRC_ALIGN (align);                                                  \
     if (src + amount > srclimit)                                        \
-      return SD_CDR_INVALID;                                            \
+      SRC_MOVE (amount);                                                \
   } while (0)
+#define SRC_AVAILABLE(n)                                                \
+  ((n) <= (os_uint32) (srclimit - src) ||                               \
+   (segs != NULL && (n) <= segs->size - SRC_POS ()))
+#define SRC_COPY(d, n) do {                                             \
+    struct deser_window w_;                                             \
+    int rc_;                                                            \
+    w_.src = src;                                                       \
+    w_.srclimit = srclimit;                                             \
+    w_.blobaddr = blobaddr;                                             \
+    if ((rc_ = deser_copy (segs, (d), (n), &w_)) < 0)                   \
+      return rc_;                                                       \
+    src = w_.src;                                                       \
+    srclimit = w_.srclimit;                                             \
+    blobaddr = w_.blobaddr;                                             \
+  } while (0)
+
+/******************** DESERIALIZE VM (STRAIGHT) ********************/
 
 #define DESERPROG_EXEC_MULTIPLE(width, n) do {  \
-    SRC_CHECK_ALIGN (width*(n), width);         \
-    memcpy (dst, src, width*(n));               \
-    src += width*(n);                           \
+    SRC_ALIGN (width);                          \
+    if (src + width*(n) <= srclimit) {          \
+      memcpy (dst, src, width*(n));             \
+      src += width*(n);                         \
+    } else {                                    \
+      SRC_COPY (dst, width*(n));                \
+    }                                           \
     dst += width*(n);                           \
   } while (0)
 #define DESERPROG_EXEC_SINGLE(width) do {               \
@@ -3654,9 +3913,12 @@ static int serprog_exec_swap (struct sd_cdrSerdata *sd, const struct serprog *pr
     src = (const char *) tsrc;                  \
   } while (0)
 #define DESERPROG_EXEC_MULTIPLE1(n) do {        \
-    SRC_CHECK_ALIGN ((n), 1);                   \
-    memcpy (dst, src, (n));                     \
-    src += (n);                                 \
+    if (src + (n) <= srclimit) {                \
+      memcpy (dst, src, (n));                   \
+      src += (n);                               \
+    } else {                                    \
+      SRC_COPY (dst, (n));                      \
+    }                                           \
     dst += (n);                                 \
   } while (0)
 #define DESERPROG_EXEC_SINGLE1() do {           \
@@ -3697,13 +3959,14 @@ static int serprog_exec_swap (struct sd_cdrSerdata *sd, const struct serprog *pr
     DESERPROG_EXEC_DISPATCH_##mode;                             \
   } while (0)
 
-static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz, const char *blob)
+static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz, const char *blob, struct deser_segs *segs)
 {
   const struct insn_enc *xs = (const struct insn_enc *) prog->buf;
   os_address stk_storage[128];
   os_address *stk = &stk_storage[0];
   const char *src = blob;
   const char *srclimit = blob + sz;
+  os_address blobaddr = (os_address) blob;
   unsigned loopcount = 0;
 #ifdef PROGEXEC_TRACE
   int indent = 0;
@@ -3716,7 +3979,7 @@ static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz,
   {
     const struct insn_enc insn = *xs++;
 #ifdef PROGEXEC_TRACE
-    fprintf (stderr, "%p %5u - ", dst, (unsigned) (src - blob));
+    fprintf (stderr, "%p %5u - ", dst, (unsigned) SRC_POS ());
     serprog_exec_trace (stderr, &indent, prog, xs - 1, loopcount);
 #endif
     /* FIXME: instruction fields are named for serialisation, so
@@ -3785,16 +4048,25 @@ static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz,
             xs++;
           }
           DESERPROG_READ_COUNT (n);
-          SRC_CHECK_ALIGN (n, 1);
           if (n == 0) {
             str = NULL;
-          } else if (n > maxn || n > (os_uint32) (srclimit - src) || src[n-1] != 0) {
+          } else if (n > maxn || !SRC_AVAILABLE (n)) {
             return SD_CDR_INVALID;
-          } else if ((str = c_stringMalloc_s (prog->base, n)) == NULL) {
-            return SD_CDR_OUT_OF_MEMORY;
-          } else {
+          } else if (src + n <= srclimit) {
+            if (src[n-1] != 0)
+              return SD_CDR_INVALID;
+            if ((str = c_stringMalloc_s (prog->base, n)) == NULL)
+              return SD_CDR_OUT_OF_MEMORY;
             memcpy (str, src, n);
             src += n;
+          } else {
+            if ((str = c_stringMalloc_s (prog->base, n)) == NULL)
+              return SD_CDR_OUT_OF_MEMORY;
+            SRC_COPY (str, n);
+            if (str[n-1] != 0) {
+              c_free (str);
+              return SD_CDR_INVALID;
+            }
           }
           *((c_string *) dst) = str;
           if (insn.opcode != INSN_STRING_POPSRC)
@@ -3856,7 +4128,7 @@ static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz,
             const unsigned maxn = *((const unsigned *) xs);
             const struct c_collectionType_s *seqtype = extract_pointer_from_code ((const char *) (xs + 1));
             void *ary;
-            if (n > maxn || n > (unsigned) (srclimit - src))
+            if (n > maxn || !SRC_AVAILABLE (n))
               return SD_CDR_INVALID;
             if ((ary = c_newBaseArrayObject_s ((c_collectionType) seqtype, n)) == NULL)
               return SD_CDR_OUT_OF_MEMORY;
@@ -3912,8 +4184,9 @@ static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz,
         {
           char *str;
           unsigned n;
-          SRC_CHECK_ALIGN (insn.count, 1);
-          if (insn.count > 0) {
+          if (insn.count == 0) {
+            str = NULL;
+          } else if (src + insn.count <= srclimit) {
             n = (unsigned) os_strnlen (src, insn.count);
             if ((str = c_stringMalloc_s (prog->base, n + 1)) == NULL)
               return SD_CDR_OUT_OF_MEMORY;
@@ -3921,7 +4194,12 @@ static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz,
             str[n] = 0;
             src += insn.count;
           } else {
-            str = NULL;
+            if (!SRC_AVAILABLE (insn.count))
+              return SD_CDR_INVALID;
+            if ((str = c_stringMalloc_s (prog->base, insn.count + 1)) == NULL)
+              return SD_CDR_OUT_OF_MEMORY;
+            SRC_COPY (str, insn.count);
+            str[insn.count] = 0;
           }
           *((c_string *) dst) = str;
           dst += sizeof (char *);
@@ -3931,10 +4209,17 @@ static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz,
         {
           unsigned n;
           DESERPROG_READ_COUNT (n);
-          SRC_CHECK_ALIGN (n, 1);
-          memcpy (dst, src, (n <= insn.count) ? n : insn.count);
+          if (src + n <= srclimit) {
+            memcpy (dst, src, (n <= insn.count) ? n : insn.count);
+            src += n;
+          } else if (!SRC_AVAILABLE (n)) {
+            return SD_CDR_INVALID;
+          } else {
+            SRC_COPY (dst, (n <= insn.count) ? n : insn.count);
+            if (n > insn.count)
+              src += n - insn.count;
+          }
           dst += insn.count;
-          src += n;
         }
         break;
       case INSN_PRIM1_CONST:
@@ -3957,8 +4242,9 @@ static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz,
         break;
       case INSN_REF_UNIQ:
         {
-          unsigned char flag = (unsigned char) *src++;
+          unsigned char flag;
           SRC_CHECK_ALIGN (1, 1);
+          flag = (unsigned char) *src++;
           if (flag == 0)
           {
             *((void **) dst) = NULL;
@@ -4003,24 +4289,35 @@ static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz,
 
 /******************** DESERIALIZE VM (SWAPPED) ********************/
 
+#define DESERPROG_SWAP_LOOP(width, n) do {              \
+    bswap_array_##width (dst, src, (n));                \
+    src += (width) * (n);                               \
+    dst += (width) * (n);                               \
+  } while (0)
+/* An array straddling fragments is swapped in runs of whole elements
+   per fragment, with the odd element straddling a boundary going
+   through DESERPROG_EXEC_SINGLE */
 #define DESERPROG_EXEC_MULTIPLE(width, n) do {          \
-    const serprog_uint##width##_t *tsrc;                \
-    serprog_uint##width##_t *tdst =                     \
-      (serprog_uint##width##_t *) dst;                  \
-    unsigned i;                                         \
-    SRC_CHECK_ALIGN (width*(n), width);                 \
-    tsrc = (const serprog_uint##width##_t *) src;       \
-    for (i = 0; i < n; i++) {                           \
-      serprog_uint##width##_t srcval;                   \
-      if ((width) > 4)                                  \
-        memcpy (&srcval, tsrc, (width));                \
-      else                                              \
-        srcval = *tsrc;                                 \
-      tsrc++;                                           \
-      *tdst++ = bswap##width##u (srcval);               \
+    SRC_ALIGN (width);                                  \
+    if (src + width*(n) <= srclimit) {                  \
+      DESERPROG_SWAP_LOOP (width, n);                   \
+    } else if (!SRC_AVAILABLE (width*(n))) {            \
+      return SD_CDR_INVALID;                            \
+    } else {                                            \
+      unsigned left_ = (n);                             \
+      while (left_ > 0) {                               \
+        unsigned m_ = (src < srclimit) ? (unsigned) (srclimit - src) / width : 0; \
+        if (m_ > left_)                                 \
+          m_ = left_;                                   \
+        if (m_ == 0) {                                  \
+          DESERPROG_EXEC_SINGLE (width);                \
+          left_--;                                      \
+        } else {                                        \
+          DESERPROG_SWAP_LOOP (width, m_);              \
+          left_ -= m_;                                  \
+        }                                               \
+      }                                                 \
     }                                                   \
-    src = (const char *) tsrc;                          \
-    dst = (char *) tdst;                                \
   } while (0)
 #define DESERPROG_EXEC_SINGLE(width) do {               \
     const serprog_uint##width##_t *tsrc;                \
@@ -4045,13 +4342,14 @@ static int deserprog_exec (char *dst, const struct serprog *prog, os_uint32 sz,
     src = (const char *) tsrc;                  \
   } while (0)
 
-static int deserprog_exec_swap (char *dst, const struct serprog *prog, os_uint32 sz, const char *blob)
+static int deserprog_exec_swap (char *dst, const struct serprog *prog, os_uint32 sz, const char *blob, struct deser_segs *segs)
 {
   const struct insn_enc *xs = (const struct insn_enc *) prog->buf;
   os_address stk_storage[128];
   os_address *stk = &stk_storage[0];
   const char *src = blob;
   const char *srclimit = blob + sz;
+  os_address blobaddr = (os_address) blob;
   unsigned loopcount = 0;
 #ifdef PROGEXEC_TRACE
   int indent = 0;
@@ -4064,7 +4362,7 @@ static int deserprog_exec_swap (char *dst, const struct serprog *prog, os_uint32
   {
     const struct insn_enc insn = *xs++;
 #ifdef PROGEXEC_TRACE
-    fprintf (stderr, "%p %5u - ", dst, (unsigned) (src - blob));
+    fprintf (stderr, "%p %5u - ", dst, (unsigned) SRC_POS ());
     serprog_exec_trace (stderr, &indent, prog, xs - 1, loopcount);
 #endif
     /* FIXME: instruction fields are named for serialisation, so
@@ -4133,16 +4431,25 @@ static int deserprog_exec_swap (char *dst, const struct serprog *prog, os_uint32
             xs++;
           }
           DESERPROG_READ_COUNT (n);
-          SRC_CHECK_ALIGN (n, 1);
           if (n == 0) {
             str = NULL;
-          } else if (n > maxn || n > (os_uint32) (srclimit - src) || src[n-1] != 0) {
+          } else if (n > maxn || !SRC_AVAILABLE (n)) {
             return SD_CDR_INVALID;
-          } else if ((str = c_stringMalloc_s (prog->base, n)) == NULL) {
-            return SD_CDR_OUT_OF_MEMORY;
-          } else {
+          } else if (src + n <= srclimit) {
+            if (src[n-1] != 0)
+              return SD_CDR_INVALID;
+            if ((str = c_stringMalloc_s (prog->base, n)) == NULL)
+              return SD_CDR_OUT_OF_MEMORY;
             memcpy (str, src, n);
             src += n;
+          } else {
+            if ((str = c_stringMalloc_s (prog->base, n)) == NULL)
+              return SD_CDR_OUT_OF_MEMORY;
+            SRC_COPY (str, n);
+            if (str[n-1] != 0) {
+              c_free (str);
+              return SD_CDR_INVALID;
+            }
           }
           *((c_string *) dst) = str;
           if (insn.opcode != INSN_STRING_POPSRC)
@@ -4204,7 +4511,7 @@ static int deserprog_exec_swap (char *dst, const struct serprog *prog, os_uint32
             const unsigned maxn = *((const unsigned *) xs);
             const struct c_collectionType_s *seqtype = extract_pointer_from_code ((const char *) (xs + 1));
             void *ary;
-            if (n > maxn || n > (unsigned) (srclimit - src))
+            if (n > maxn || !SRC_AVAILABLE (n))
               return SD_CDR_INVALID;
             if ((ary = c_newBaseArrayObject_s ((c_collectionType) seqtype, n)) == NULL)
               return SD_CDR_OUT_OF_MEMORY;
@@ -4260,8 +4567,9 @@ static int deserprog_exec_swap (char *dst, const struct serprog *prog, os_uint32
         {
           char *str;
           unsigned n;
-          SRC_CHECK_ALIGN (insn.count, 1);
-          if (insn.count > 0) {
+          if (insn.count == 0) {
+            str = NULL;
+          } else if (src + insn.count <= srclimit) {
             n = (unsigned) os_strnlen (src, insn.count);
             if ((str = c_stringMalloc_s (prog->base, n + 1)) == NULL)
               return SD_CDR_OUT_OF_MEMORY;
@@ -4269,7 +4577,12 @@ static int deserprog_exec_swap (char *dst, const struct serprog *prog, os_uint32
             str[n] = 0;
             src += insn.count;
           } else {
-            str = NULL;
+            if (!SRC_AVAILABLE (insn.count))
+              return SD_CDR_INVALID;
+            if ((str = c_stringMalloc_s (prog->base, insn.count + 1)) == NULL)
+              return SD_CDR_OUT_OF_MEMORY;
+            SRC_COPY (str, insn.count);
+            str[insn.count] = 0;
           }
           *((c_string *) dst) = str;
           dst += sizeof (char *);
@@ -4279,10 +4592,17 @@ static int deserprog_exec_swap (char *dst, const struct serprog *prog, os_uint32
         {
           unsigned n;
           DESERPROG_READ_COUNT (n);
-          SRC_CHECK_ALIGN (n, 1);
-          memcpy (dst, src, (n <= insn.count) ? n : insn.count);
+          if (src + n <= srclimit) {
+            memcpy (dst, src, (n <= insn.count) ? n : insn.count);
+            src += n;
+          } else if (!SRC_AVAILABLE (n)) {
+            return SD_CDR_INVALID;
+          } else {
+            SRC_COPY (dst, (n <= insn.count) ? n : insn.count);
+            if (n > insn.count)
+              src += n - insn.count;
+          }
           dst += insn.count;
-          src += n;
         }
         break;
       case INSN_PRIM1_CONST:
@@ -4305,8 +4625,9 @@ static int deserprog_exec_swap (char *dst, const struct serprog *prog, os_uint32
         break;
       case INSN_REF_UNIQ:
         {
-          unsigned char flag = (unsigned char) *src++;
+          unsigned char flag;
           SRC_CHECK_ALIGN (1, 1);
+          flag = (unsigned char) *src++;
           if (flag == 0)
           {
             *((void **) dst) = NULL;
@@ -4606,12 +4927,12 @@ struct sd_cdrSerdata *sd_cdrSerializeLE (const struct sd_cdrInfo *ci, const void
 
 int sd_cdrDeserializeRaw (void *dst, const struct sd_cdrInfo *ci, os_uint32 sz, const void *src)
 {
-  return deserprog_exec (dst, ci->prog, sz, src);
+  return deserprog_exec (dst, ci->prog, sz, src, NULL);
 }
 
 int sd_cdrDeserializeRawBSwap (void *dst, const struct sd_cdrInfo *ci, os_uint32 sz, const void *src)
 {
-  return deserprog_exec_swap (dst, ci->prog, sz, src);
+  return deserprog_exec_swap (dst, ci->prog, sz, src, NULL);
 }
 
 int sd_cdrDeserializeRawBE (void *dst, const struct sd_cdrInfo *ci, os_uint32 sz, const void *src)
@@ -4632,13 +4953,44 @@ int sd_cdrDeserializeRawLE (void *dst, const struct sd_cdrInfo *ci, os_uint32 sz
 #endif
 }
 
-static int sd_cdrDeserializeObjectInternal (int (*f) (char *, const struct serprog *, os_uint32, const char *), void **dst, const struct sd_cdrInfo *ci, os_uint32 sz, const void *src)
+static int sd_cdrDeserializeRawFragmentsInternal (int (*f) (char *, const struct serprog *, os_uint32, const char *, struct deser_segs *), void *dst, const struct sd_cdrInfo *ci, unsigned nfrags, const struct sd_cdrFragment *frags)
+{
+  struct deser_segs segs;
+  unsigned i;
+  segs.frags = frags;
+  segs.nfrags = nfrags;
+  segs.idx = 0;
+  segs.fragpos = 0;
+  segs.size = 0;
+  for (i = 0; i < nfrags; i++)
+  {
+    if (frags[i].size > (os_uint32) -1 - segs.size)
+      return SD_CDR_INVALID;
+    segs.size += frags[i].size;
+  }
+  if (nfrags == 0)
+    return f (dst, ci->prog, 0, "", &segs);
+  else
+    return f (dst, ci->prog, frags[0].size, frags[0].data, &segs);
+}
+
+int sd_cdrDeserializeRawFragments (void *dst, const struct sd_cdrInfo *ci, unsigned nfrags, const struct sd_cdrFragment *frags)
+{
+  return sd_cdrDeserializeRawFragmentsInternal (deserprog_exec, dst, ci, nfrags, frags);
+}
+
+int sd_cdrDeserializeRawFragmentsBSwap (void *dst, const struct sd_cdrInfo *ci, unsigned nfrags, const struct sd_cdrFragment *frags)
+{
+  return sd_cdrDeserializeRawFragmentsInternal (deserprog_exec_swap, dst, ci, nfrags, frags);
+}
+
+static int sd_cdrDeserializeObjectInternal (int (*f) (char *, const struct serprog *, os_uint32, const char *, struct deser_segs *), void **dst, const struct sd_cdrInfo *ci, os_uint32 sz, const void *src)
 {
   void *obj;
   int rc;
   if ((obj = c_new_s (ci->prog->ospl_type)) == NULL)
     return SD_CDR_OUT_OF_MEMORY;
-  if ((rc = f (obj, ci->prog, sz, src)) < 0)
+  if ((rc = f (obj, ci->prog, sz, src, NULL)) < 0)
   {
     c_free (obj);
     return rc;
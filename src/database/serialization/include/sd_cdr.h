@@ -136,6 +136,21 @@ OS_API int sd_cdrDeserializeRawBE (void *dst, const struct sd_cdrInfo *ci, os_ui
 OS_API int sd_cdrDeserializeRawLE (void *dst, const struct sd_cdrInfo *ci, os_uint32 sz, const void *src) __nonnull_all__ __attribute_warn_unused_result__;
 OS_API int sd_cdrDeserializeObjectBE (void **dst, const struct sd_cdrInfo *ci, os_uint32 sz, const void *src) __nonnull_all__ __attribute_warn_unused_result__;
 
+/* One piece of a CDR stream that is not contiguous in memory, e.g.
+   a sample received in fragments.  Logical offset 0 of the stream
+   must be 4-byte aligned and the address of each piece must preserve
+   the 4-byte alignment of its offset in the stream. */
+struct sd_cdrFragment {
+  const void *data;
+  os_uint32 size;
+};
+
+/* sd_cdrDeserializeRawFragments deserializes the concatenation of
+   FRAGS[0 .. NFRAGS-1] without first copying it into a single buffer.
+   Elements may straddle fragment boundaries. */
+OS_API int sd_cdrDeserializeRawFragments (void *dst, const struct sd_cdrInfo *ci, unsigned nfrags, const struct sd_cdrFragment *frags) __nonnull_all__ __attribute_warn_unused_result__;
+OS_API int sd_cdrDeserializeRawFragmentsBSwap (void *dst, const struct sd_cdrInfo *ci, unsigned nfrags, const struct sd_cdrFragment *frags) __nonnull_all__ __attribute_warn_unused_result__;
+
 OS_API void sd_cdrSerdataFree (struct sd_cdrSerdata *serdata) __nonnull_all__;
 
 /* SerdataBlob returns a size of blob, address of blob in *blob, has
@@ -107,13 +107,6 @@
 typedef v_actionResult(*v__dataReaderAction)(
     v_dataReaderSample , v_readerSampleAction, c_voidp);
 
-#ifdef _MSG_STAMP_
-void
-v_dataReaderLogMessage(
-    v_dataReader _this,
-    v_message msg);
-#endif
-
 void
 v_dataReaderDeinit(
     v_dataReader _this);
@@ -352,6 +345,35 @@ void
 v_dataReaderTriggerNoLock(
     v_dataReader _this);
 
+/**
+ * Makes the calling thread collect the data available triggers of the
+ * readers it writes into, instead of notifying them for every sample. The
+ * collected readers are triggered once by v_dataReaderTriggerFlush and
+ * v_dataReaderTriggerDeferEnd. Calls may be nested.
+ *
+ * The thread must flush before it blocks on anything a reader may need to
+ * be notified for, e.g. a writer waiting for resources.
+ */
+void
+v_dataReaderTriggerDeferBegin(void);
+
+void
+v_dataReaderTriggerDeferEnd(void);
+
+void
+v_dataReaderTriggerFlush(void);
+
+/**
+ * Returns TRUE if the calling thread defers triggers, in which case _this
+ * is added to the readers to be triggered. The reader must be locked.
+ * If sample is the only sample deferred for _this, it is passed on to the
+ * queries when the trigger is flushed, so they need not walk the reader.
+ */
+c_bool
+v_dataReaderTriggerDefer(
+    v_dataReader _this,
+    v_dataReaderSample sample);
+
 void
 v_dataReaderCheckMinimumSeparationList(
     v_dataReader _this,
@@ -141,6 +141,23 @@ v__lookupTypeRepresentation (
     v_dataRepresentationId_t dataRepresentationId,
     const v_typeHash typeHash);
 
+#define v_typeDescriptor(o) (C_CAST(o,v_typeDescriptor))
+
+/* Returns the type that was loaded before from exactly this XML descriptor,
+ * or NULL if it has not been seen. */
+c_type
+v__kernelLookupTypeDescriptor (
+    v_kernel _this,
+    const os_char *xml_descriptor);
+
+/* Remembers the type successfully loaded from an XML descriptor, so that
+ * loading the same descriptor again only needs a lookup. */
+void
+v__kernelAddTypeDescriptor (
+    v_kernel _this,
+    const os_char *xml_descriptor,
+    c_type type);
+
 v_result
 v_kernelDisposeAllData(
     v_kernel kernel,
@@ -0,0 +1,54 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#ifndef V__LATENCYTRACE_H
+#define V__LATENCYTRACE_H
+
+/** \file kernel/code/v__latencyTrace.h
+ *  \brief Recording side of the latency tracer, see v_latencyTrace.h.
+ *
+ */
+
+#include "v_latencyTrace.h"
+#include "v_message.h"
+#include "v_topic.h"
+
+/* !!!!!!!!NOTE From here no more includes are allowed!!!!!!! */
+
+/* Stamps _msg at _stage if tracing is enabled and the message is sampled.
+ * Only data messages that have been assigned a sequence number by their
+ * writer are traced, _topic provides the kernel and the topic name.
+ */
+#define V_MESSAGE_TRACE(_msg,_topic,_stage) { \
+            c_ulong _rate = v_objectKernel(_topic)->latencyTraceRate; \
+            if ((_rate != 0) && \
+                ((_msg)->sequenceNumber != 0) && \
+                (((_msg)->sequenceNumber % _rate) == 0) && \
+                v_messageStateTest(_msg, L_WRITE)) { \
+                v_latencyTraceRecord(_msg, v_topicName(_topic), _stage); \
+            } \
+        }
+
+void
+v_latencyTraceRecord(
+    v_message msg,
+    const c_char *topicName,
+    v_latencyStage stage);
+
+#endif
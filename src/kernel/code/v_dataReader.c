@@ -300,157 +300,6 @@ v_dataReaderUpdatePurgeListsLocked(
     c_setWalk(v_reader(_this)->entrySet.entries, dataReaderEntryUpdatePurgeLists, NULL);
 }
 
-#ifdef _MSG_STAMP_
-
-#define _LAPSTAMP_(_this,_lap) { \
-            if ((_lap > 0) && (_lap < 100000000))  { \
-            _this.min = (_this.min < _lap ? _this.min : _lap); \
-            _this.max = (_this.max > _lap ? _this.max : _lap); \
-            _this.tot += _lap; \
-            _this.count++; \
-            } \
-        }
-
-void
-v_dataReaderLogMessage(
-    v_dataReader _this,
-    v_message msg)
-{
-    v_hrtime lap;
-    c_long i;
-
-    for (i=0; i<=msg->hops; i++) {
-        lap = msg->writerCopyTime[i] - msg->writerAllocTime[i];
-        _LAPSTAMP_(_this->writerCopyTime[i],lap);
-        lap = msg->writerLookupTime[i] - msg->writerCopyTime[i];
-        _LAPSTAMP_(_this->writerLookupTime[i],lap);
-        lap = msg->groupInsertTime[i] - msg->writerLookupTime[i];
-        _LAPSTAMP_(_this->writerWriteTime[i],lap);
-        lap = msg->groupLookupTime[i] - msg->groupInsertTime[i];
-        _LAPSTAMP_(_this->groupLookupTime[i],lap);
-        lap = msg->readerInsertTime[i] - msg->groupLookupTime[i];
-        _LAPSTAMP_(_this->groupWriteTime[i],lap);
-        lap = msg->readerLookupTime[i] - msg->readerInsertTime[i];
-        _LAPSTAMP_(_this->readerLookupTime[i],lap);
-        lap = msg->readerDataAvailableTime[i] - msg->readerLookupTime[i];
-        _LAPSTAMP_(_this->readerInstanceTime[i],lap);
-        lap = msg->readerInstanceTime[i] - msg->readerDataAvailableTime[i];
-        _LAPSTAMP_(_this->readerInsertTime[i],lap);
-        lap = msg->readerNotifyTime[i] - msg->readerInstanceTime[i];
-        _LAPSTAMP_(_this->readerNotifyTime[i],lap);
-        lap = msg->readerReadTime[i] - msg->readerNotifyTime[i];
-        _LAPSTAMP_(_this->readerReadTime[i],lap);
-        lap = msg->readerCopyTime[i] - msg->readerReadTime[i];
-        _LAPSTAMP_(_this->readerCopyTime[i],lap);
-
-        lap = msg->nwSerialisationTime[i] - msg->readerDataAvailableTime[i];
-        _LAPSTAMP_(_this->nwSerialisationTime[i],lap);
-        lap = msg->nwBufferFullTime[i] - msg->readerDataAvailableTime[i];
-        _LAPSTAMP_(_this->nwBufferFullTime[i],lap);
-        lap = msg->nwFlushBufferTime[i] - msg->nwBufferFullTime[i];
-        _LAPSTAMP_(_this->nwFlushBufferTime[i],lap);
-        lap = msg->nwSendTime[i] - msg->nwFlushBufferTime[i];
-        _LAPSTAMP_(_this->nwSendTime[i],lap);
-        if (i > 0) {
-            lap = msg->nwReceiveTime[i] - msg->nwSendTime[i-1];
-            _LAPSTAMP_(_this->nwReceiveTime[i],lap);
-        }
-        lap = msg->nwInsertTime[i] - msg->nwReceiveTime[i];
-        _LAPSTAMP_(_this->nwInsertTime[i],lap);
-    }
-}
-#undef _LAPSTAMP_
-
-#define _LAPINIT_(_this) { \
-            _this.cur = 0ll; \
-            _this.min = 0x7fffffffffffffffll; \
-            _this.max = 0ll; \
-            _this.tot = 0ll; \
-            _this.count = 0; \
-        }
-
-static void
-v_dataReaderLogInit(
-    v_dataReader _this)
-{
-    c_long i;
-
-    for (i=0; i<2; i++) {
-        _LAPINIT_(_this->writerCopyTime[i]);
-        _LAPINIT_(_this->writerLookupTime[i]);
-        _LAPINIT_(_this->writerWriteTime[i]);
-        _LAPINIT_(_this->groupLookupTime[i]);
-        _LAPINIT_(_this->groupWriteTime[i]);
-        _LAPINIT_(_this->readerLookupTime[i]);
-        _LAPINIT_(_this->readerInstanceTime[i]);
-        _LAPINIT_(_this->readerInsertTime[i]);
-        _LAPINIT_(_this->readerNotifyTime[i]);
-        _LAPINIT_(_this->readerReadTime[i]);
-        _LAPINIT_(_this->readerCopyTime[i]);
-        _LAPINIT_(_this->nwSerialisationTime[i]);
-        _LAPINIT_(_this->nwBufferFullTime[i]);
-        _LAPINIT_(_this->nwFlushBufferTime[i]);
-        _LAPINIT_(_this->nwSendTime[i]);
-        _LAPINIT_(_this->nwReceiveTime[i]);
-        _LAPINIT_(_this->nwInsertTime[i]);
-    }
-}
-#undef _LAPINIT_
-
-static void
-_lapReport(
-    v_laptime *laptime,
-    const char *info)
-{
-    if (laptime->count > 0) {
-        printf("%10d %16d %16d %16d (%s)\n",
-            laptime->count,
-            (int)(laptime->tot / 1000ll) / laptime->count,
-            (int)(laptime->min / 1000ll),
-            (int)(laptime->max / 1000ll),
-            info);
-    }
-}
-
-static void
-v_dataReaderLogReport(
-    v_dataReader _this)
-{
-    c_char *info = "DataReader message arrival stats";
-    c_long i;
-
-    if (_this->writerLookupTime[0].count > 99) {
-        printf("==============================================================\n");
-        printf("DataReader : %s\n", info);
-        printf("--------------------------------------------------------------\n");
-        printf("Nr of laps       mean (usec)       min (usec)       max (usec)\n");
-        for (i=0; i<2; i++) {
-            printf("--------------------------------------------------------------\n");
-            _lapReport(&_this->nwReceiveTime[i],"Network: receive time");
-            _lapReport(&_this->nwInsertTime[i],"Network: insert time");
-            _lapReport(&_this->writerCopyTime[i],"Writer: copy data time");
-            _lapReport(&_this->writerLookupTime[i],"Writer: lookup instance time");
-            _lapReport(&_this->writerWriteTime[i],"Writer: write to group time");
-            _lapReport(&_this->groupLookupTime[i],"Group: lookup instance time");
-            _lapReport(&_this->groupWriteTime[i],"Group: write to Reader time");
-            _lapReport(&_this->readerLookupTime[i],"Reader: lookup instance time");
-            _lapReport(&_this->readerInstanceTime[i],"Reader: insert instance time");
-            _lapReport(&_this->readerInsertTime[i],"Reader: insert time");
-            _lapReport(&_this->readerNotifyTime[i],"Reader: Notify time");
-            _lapReport(&_this->readerReadTime[i],"Reader: read time");
-            _lapReport(&_this->readerCopyTime[i],"Reader: copy time");
-            _lapReport(&_this->nwSerialisationTime[i],"Network: serialisation time");
-            _lapReport(&_this->nwBufferFullTime[i],"Network: buffer full time");
-            _lapReport(&_this->nwFlushBufferTime[i],"Network: buffer flush time");
-            _lapReport(&_this->nwSendTime[i],"Network: send time");
-
-        }
-        printf("==============================================================\n");
-    }
-}
-
-#endif
-
 v_dataReader
 v_dataReaderNewBySQL (
     v_subscriber subscriber,
@@ -620,10 +469,6 @@ v_dataReaderNew (
         _this->maximumSeparationTime = qos->pacing.v.minSeperation;
     }
 
-#ifdef _MSG_STAMP_
-    v_dataReaderLogInit(_this);
-#endif
-
     v_readerInit(v_reader(_this),name, subscriber, q, enable);
 
     if (q->share.v.enable) {
@@ -780,9 +625,6 @@ v_dataReaderFree (
     assert(_this != NULL);
     assert(C_TYPECHECK(_this,v_dataReader));
 
-#ifdef _MSG_STAMP_
-    v_dataReaderLogReport(_this);
-#endif
     /* First create message, only at the end dispose. Applications expect
        the disposed sample to be the last!
     */
@@ -1943,6 +1785,112 @@ v_dataReaderTriggerNoLock(
     }
 }
 
+/* A reader that has to be triggered, together with the sample that caused
+ * the trigger if it is the only one.
+ */
+struct v_dataReaderDeferredTrigger {
+    v_dataReader reader;
+    v_dataReaderSample sample;
+};
+
+struct v_dataReaderTriggers {
+    c_ulong depth;
+    c_iter readers; /* struct v_dataReaderDeferredTrigger */
+};
+
+void
+v_dataReaderTriggerDeferBegin(void)
+{
+    struct v_dataReaderTriggers *triggers;
+
+    if ((triggers = os_threadMemGet(OS_THREAD_READER_TRIGGERS)) == NULL) {
+        triggers = os_threadMemMalloc(OS_THREAD_READER_TRIGGERS, sizeof(*triggers), NULL, NULL);
+        if (triggers == NULL) {
+            /* Triggers will not be deferred */
+            return;
+        }
+        triggers->depth = 0;
+        triggers->readers = NULL;
+    }
+    triggers->depth++;
+}
+
+void
+v_dataReaderTriggerFlush(void)
+{
+    struct v_dataReaderTriggers *triggers;
+    struct v_dataReaderDeferredTrigger *trigger;
+    v_dataReaderSample sample;
+
+    if ((triggers = os_threadMemGet(OS_THREAD_READER_TRIGGERS)) != NULL) {
+        while ((trigger = c_iterTakeFirst(triggers->readers)) != NULL) {
+            v_dataReaderLock(trigger->reader);
+            /* The sample may have been taken or replaced since it was
+             * deferred, in which case the queries must walk the reader. */
+            sample = trigger->sample;
+            if (sample && v_readerSampleTestState(sample, L_REMOVED)) {
+                sample = NULL;
+            }
+            v_dataReaderNotifyDataAvailable(trigger->reader, sample);
+            v_dataReaderUnlock(trigger->reader);
+            c_free(trigger->sample);
+            c_free(trigger->reader);
+            os_free(trigger);
+        }
+    }
+}
+
+void
+v_dataReaderTriggerDeferEnd(void)
+{
+    struct v_dataReaderTriggers *triggers;
+
+    if ((triggers = os_threadMemGet(OS_THREAD_READER_TRIGGERS)) != NULL) {
+        assert(triggers->depth > 0);
+        if (--triggers->depth == 0) {
+            v_dataReaderTriggerFlush();
+            c_iterFree(triggers->readers);
+            triggers->readers = NULL;
+        }
+    }
+}
+
+static c_bool
+deferredTriggerMatch(
+    void *o,
+    c_iterActionArg arg)
+{
+    struct v_dataReaderDeferredTrigger *trigger = o;
+
+    return (trigger->reader == v_dataReader(arg));
+}
+
+c_bool
+v_dataReaderTriggerDefer(
+    v_dataReader _this,
+    v_dataReaderSample sample)
+{
+    struct v_dataReaderTriggers *triggers;
+    struct v_dataReaderDeferredTrigger *trigger;
+
+    triggers = os_threadMemGet(OS_THREAD_READER_TRIGGERS);
+    if ((triggers == NULL) || (triggers->depth == 0)) {
+        return FALSE;
+    }
+    trigger = c_iterReadAction(triggers->readers, deferredTriggerMatch, _this);
+    if (trigger == NULL) {
+        trigger = os_malloc(sizeof(*trigger));
+        trigger->reader = c_keep(_this);
+        trigger->sample = c_keep(sample);
+        triggers->readers = c_iterAppend(triggers->readers, trigger);
+    } else if (trigger->sample) {
+        /* More than one sample, so the queries must walk the reader. */
+        c_free(trigger->sample);
+        trigger->sample = NULL;
+    }
+    return TRUE;
+}
+
 void
 v_dataReaderNotifyDataAvailable(
     v_dataReader _this,
@@ -41,6 +41,7 @@
 #include "v_builtin.h"
 #include "v_topic.h"
 #include "v_message.h"
+#include "v__latencyTrace.h"
 #include "v_messageQos.h"
 #include "v__deliveryService.h"
 #include "v__kernel.h"
@@ -381,6 +382,7 @@ doWrite(
 
         switch (res) {
         case V_DATAREADER_INSERTED:
+            V_MESSAGE_TRACE(message, _this->topic, V_LATENCY_READER_INSERT);
             UPDATE_READER_STATISTICS(_this,found,oldState);
             if (qos->userKey.v.enable == FALSE) {
                 if (!v_dataReaderInstanceEmpty(found)) {
@@ -467,8 +469,6 @@ doWrite(
         }
     }
 
-    V_MESSAGE_STAMP(message,readerNotifyTime);
-
     return result;
 }
 
@@ -493,8 +493,6 @@ v_dataReaderEntryWrite(
     assert(C_TYPECHECK(_this,v_dataReaderEntry));
     assert(message != NULL);
 
-    V_MESSAGE_STAMP(message,readerInsertTime);
-
     /* Only write if the message is not produced by an incompatible writer. */
     reader = v_dataReader(v_entryReader(_this));
     v_observerLock(v_observer(reader));
@@ -553,6 +551,27 @@ v_dataReaderEntryWrite(
             return V_WRITE_SUCCESS;
         }
 
+        if ((_this->filterInstance == NULL) && !qos->userKey.v.enable) {
+            /* Without key filters an existing instance can be looked up
+             * directly by the key hash the message carries, so there is no
+             * need to create (and discard) an instance to look it up.
+             */
+            found = c_tableFindHashed(_this->index->objects,
+                                      v_messageKeyHash(message, _this->index->messageKeyList),
+                                      _this->index->messageKeyList, message);
+            if (found != NULL) {
+                result = doWrite(_this, found, message, context,
+                                 &a_work_around_for_dispose_all_to_indicate_the_instance_is_deleted);
+                if (instancePtr && !a_work_around_for_dispose_all_to_indicate_the_instance_is_deleted) {
+                    *instancePtr = v_instance(found);
+                } else {
+                    c_free(found);
+                }
+                v_observerUnlock(v_observer(reader));
+                return result;
+            }
+        }
+
         instance = v_dataReaderInstanceNew(v_dataReader(reader),message);
         if (!instance) {
             OS_REPORT(OS_CRITICAL,
@@ -663,7 +682,6 @@ v_dataReaderEntryWrite(
                  * crement of the Alive-counter. This special case has to be
                  * handled in the statistics updating. */
                 UPDATE_READER_STATISTICS(_this,found,0);
-                V_MESSAGE_STAMP(message,readerLookupTime);
                 result = doWrite(_this, found, message, context,
                                  &a_work_around_for_dispose_all_to_indicate_the_instance_is_deleted);
             }
@@ -673,7 +691,6 @@ v_dataReaderEntryWrite(
              * to fulfill the following invariant.
              */
             v_dataReaderInstanceFree(instance);
-            V_MESSAGE_STAMP(message,readerLookupTime);
             result = doWrite(_this, found, message, context,
                              &a_work_around_for_dispose_all_to_indicate_the_instance_is_deleted);
         }
@@ -720,7 +737,6 @@ v_dataReaderEntryWrite(
                 }
             }
         }
-        V_MESSAGE_STAMP(message,readerLookupTime);
         result = doWrite(_this, v_dataReaderInstance(*instancePtr), message, context, NULL);
     }
     v_observerUnlock(v_observer(reader));
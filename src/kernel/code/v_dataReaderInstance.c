@@ -48,6 +48,7 @@
 #include "v__orderedInstance.h"
 #include "v__reader.h"
 #include "v__leaseManager.h"
+#include "v__latencyTrace.h"
 
 /* For debugging purposes... */
 #ifndef NDEBUG
@@ -93,6 +94,9 @@
 #define CHECK_COUNT(_this)
 #endif
 
+#define v_dataReaderInstanceTopic(_this) \
+        (v_dataReaderEntry(v_index(v_dataReaderInstance(_this)->index)->entry)->topic)
+
 /**
  * Returns the relative order of a v_message to a v_historyBookmark.
  * @param _this A v_historyBookmark
@@ -750,12 +754,11 @@ MakeSampleAvailable (
         (reader->notReadTriggerThreshold <= 0 ||
          reader->notReadTriggerCount++ == reader->notReadTriggerThreshold))
     {
-        V_MESSAGE_STAMP(message,readerDataAvailableTime);
-        V_MESSAGE_STAMP(message, readerInstanceTime);
-
         reader->notReadTriggerCount = 0;
         v_dataReaderInstanceStateClear(_this, L_TRIGGER);
-        v_dataReaderNotifyDataAvailable(reader, sample);
+        if (!v_dataReaderTriggerDefer(reader, sample)) {
+            v_dataReaderNotifyDataAvailable(reader, sample);
+        }
     }
 }
 
@@ -1827,7 +1830,6 @@ v_dataReaderSampleRead(
             CreateTypedInvalidMessage(instance, v_dataReaderSampleMessage(orgSample));
         /* Hack ends here. */
     }
-    V_MESSAGE_STAMP(v_dataReaderSampleMessage(sample), readerReadTime);
     result = action(v_readerSample(sample), arg);
     /* In case of ordered access and group access scope the reader may read at most
      * one sample, even if the max samples specifies more than one.
@@ -1837,10 +1839,6 @@ v_dataReaderSampleRead(
         result = V_STOP;
     }
 
-    V_MESSAGE_STAMP(v_dataReaderSampleMessage(sample), readerCopyTime);
-    V_MESSAGE_REPORT(v_dataReaderSampleMessage(sample),
-                     v_dataReaderInstanceDataReader(instance));
-
     /* If the message was temporarily switched, switch it back. */
     if (!v_readerSampleTestState(sample, L_VALIDDATA))
     {
@@ -1858,8 +1856,11 @@ v_dataReaderSampleRead(
      */
     if (v_actionResultTestNot(result, V_SKIP))
     {
-        V_MESSAGE_REPORT(v_dataReaderSampleMessage(sample),
-                         v_dataReaderInstanceDataReader(instance));
+        if (!v_readerSampleTestState(sample, L_READ)) {
+            V_MESSAGE_TRACE(v_dataReaderSampleMessage(sample),
+                            v_dataReaderInstanceTopic(instance),
+                            V_LATENCY_READER_TAKE);
+        }
         v_dataReaderInstanceStateClear(instance, L_NEW);
         v_dataReaderInstanceStateClear(instance, L_STATECHANGED);
         if (!v_readerSampleTestState(sample, L_READ)) {
@@ -2206,7 +2207,6 @@ v_dataReaderSampleTake(
      * modified accordingly. That means the 'proceed' flag should be set in
      * that case.
      */
-    V_MESSAGE_STAMP(v_dataReaderSampleMessage(sample),readerReadTime);
     if (action)
     {
         /* If the sample contains an untyped invalid message, then temporarily
@@ -2265,10 +2265,11 @@ v_dataReaderSampleTake(
      */
     if (v_actionResultTestNot(result, V_SKIP))
     {
-        V_MESSAGE_STAMP(v_dataReaderSampleMessage(sample),readerCopyTime);
-        V_MESSAGE_REPORT(v_dataReaderSampleMessage(sample),
-                         v_dataReaderInstanceDataReader(instance));
-
+        if (!v_readerSampleTestState(sample, L_READ)) {
+            V_MESSAGE_TRACE(v_dataReaderSampleMessage(sample),
+                            v_dataReaderInstanceTopic(instance),
+                            V_LATENCY_READER_TAKE);
+        }
 
         if(action)
         {
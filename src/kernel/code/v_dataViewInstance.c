@@ -578,7 +578,6 @@ v_dataViewSampleReadTake(
      * modified accordingly. That means the 'proceed' flag should be set in
      * that case.
      */
-    V_MESSAGE_STAMP(v_dataReaderSampleMessage(sample),readerReadTime);
     if (action)
     {
         /* Invoke the action routine with the typed sample. */
@@ -598,10 +597,6 @@ v_dataViewSampleReadTake(
      */
     if (v_actionResultTestNot(result, V_SKIP))
     {
-        V_MESSAGE_STAMP(v_dataReaderSampleMessage(sample),readerCopyTime);
-        V_MESSAGE_REPORT(v_dataReaderSampleMessage(sample),
-                         v_dataReaderInstanceDataReader(instance));
-
         v_stateClear(v_instanceState(instance),L_NEW);
         if (!v_stateTest(v_readerSample(sample)->sampleState,L_READ)) {
             v_stateSet(v_readerSample(sample)->sampleState,L_LAZYREAD);
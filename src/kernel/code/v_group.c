@@ -24,6 +24,7 @@
 #include "v_partition.h"
 #include "v__topic.h"
 #include "v_message.h"
+#include "v__latencyTrace.h"
 #include "v_messageQos.h"
 #include "v__entity.h"
 #include "v_proxy.h"
@@ -33,6 +34,7 @@
 #include "v_public.h"
 #include "v_instance.h"
 #include "v__observer.h"
+#include "v__dataReader.h"
 #include "v__dataReaderInstance.h"
 #include "v__dataReaderEntry.h"
 #include "v_groupCache.h"
@@ -78,6 +80,21 @@ groupGetHistoricalData(
     v_entry e,
     c_bool openTransactions);
 
+static void
+groupHistoryFence(
+    v_group g,
+    v_groupInstance gi);
+
+static void
+groupHistoryComplete(
+    v_group g);
+
+static v_result
+groupHistoryDeliver(
+    v_group g,
+    c_voidp target,
+    c_bool stream);
+
 v_groupSample
 v_groupSampleNew (
     v_group group,
@@ -1044,7 +1061,7 @@ v_groupInit(
     group->instanceType = createGroupInstanceType(topic, group->sampleType);
 
     keyExpr = createInstanceKeyExpr(topic);
-    group->instances = c_tableNew(group->instanceType,keyExpr);
+    group->instances = c_tableNewHashed(group->instanceType,keyExpr);
     os_free(keyExpr);
 
     group->resourceSampleCount = 0;
@@ -1072,6 +1089,9 @@ v_groupInit(
     group->transactionAdmin = NULL;
     group->onRequest = FALSE;
     group->pristine = TRUE; /* becomes false as soon a writer connects. */
+    group->historyTarget = NULL;
+    group->historyStream = FALSE;
+    group->historyEpoch = 0;
     c_free(type);
 }
 
@@ -1312,6 +1332,9 @@ v_groupRemoveEntry(
 
     c_mutexLock(&g->mutex);
 
+    if (g->historyTarget == (c_voidp)e) {
+        g->historyTarget = NULL;
+    }
     if (v_objectKind(e) == K_NETWORKREADERENTRY) {
         proxy = v_groupEntrySetRemove(&g->networkEntrySet,e);
         if(v_networkReaderEntryIsRouting(v_networkReaderEntry(e))){
@@ -1391,6 +1414,9 @@ v_groupRemoveStream(
 
     result = FALSE;
     c_mutexLock(&group->mutex);
+    if (group->historyTarget == (c_voidp)stream) {
+        group->historyTarget = NULL;
+    }
     found = v_groupStream(c_remove(group->streams,stream, NULL, NULL));
 
     if (found == stream) {
@@ -2468,6 +2494,9 @@ v_groupDisposeAllMatchingInstancesLocked (
     qos = v_topicQosRef(group->topic);
     v_gidSetNil(nullGID);
 
+    /* Historical data still to be delivered precedes the dispose */
+    groupHistoryComplete(group);
+
     msgActionArg.condition = condition;
     msgActionArg.arg = arg;
 
@@ -2645,29 +2674,12 @@ lookupInstanceByMessage(
     v_group group,
     v_message msg)
 {
-    v_groupInstance instance;
-    c_value _keyValues[32];
-    c_value *keyValues = _keyValues;
     c_array messageKeyList;
-    c_ulong i, nrOfKeys;
 
     messageKeyList = v_topicMessageKeyList(v_groupTopic(group));
-    nrOfKeys = c_arraySize(messageKeyList);
-    if (nrOfKeys > 32) {
-        keyValues = os_malloc(sizeof(c_value) * nrOfKeys);
-    }
-    for (i=0;i<nrOfKeys;i++) {
-        keyValues[i] = c_fieldValue(messageKeyList[i], msg);
-    }
-    instance = c_tableFind(group->instances, &keyValues[0]);
-    /* Key values have to be freed again */
-    for (i=0;i<nrOfKeys;i++) {
-        c_valueFreeRef(keyValues[i]);
-    }
-    if (nrOfKeys > 32) {
-        os_free(keyValues);
-    }
-    return instance;
+    return c_tableFindHashed(group->instances,
+                             v_messageKeyHash(msg, messageKeyList),
+                             messageKeyList, msg);
 }
 
 /* As part of scarab#2907, the new inout v_resendScope parameter to groupWrite
@@ -2727,6 +2739,7 @@ groupWrite (
             assert(found == instance);
             OS_UNUSED_ARG(found);
         }
+        groupHistoryFence(group, instance);
 
         result = v_groupInstanceRegister(instance, msg);
         if (result == V_WRITE_REGISTERED){
@@ -2792,6 +2805,7 @@ groupWrite (
             assert(FALSE);
             return V_WRITE_PRE_NOT_MET;
         }
+        groupHistoryFence(group, instance);
         if (!v_stateTestOr(v_nodeState(msg), L_WRITE | L_DISPOSED | L_UNREGISTER | L_TRANSACTION)) {
             return V_WRITE_SUCCESS;
         }
@@ -2799,7 +2813,7 @@ groupWrite (
     }
     (void) result;
 
-    V_MESSAGE_STAMP(msg,groupLookupTime);
+    V_MESSAGE_TRACE(msg, group->topic, V_LATENCY_GROUP_INSERT);
 
     /* At this point the group instance is either created, resolved
      * or verified if it was provided by the callee.
@@ -2980,7 +2994,6 @@ v_groupWrite (
 
     c_mutexLock(&group->mutex);
 
-    V_MESSAGE_STAMP(msg,groupInsertTime);
     if (v_messageStateTest(msg, L_ENDOFTRANSACTION)) {
         result = groupWriteEOT(group, msg, writingNetworkId, resendScope);
     } else {
@@ -3042,6 +3055,7 @@ v_groupFlushTransactionNoLock(
     } else {
         assert(instance);
 
+        groupHistoryFence(a->group, v_groupInstance(instance));
         qos = v_topicQosRef(a->group->topic);
         if (v_messageStateTest(message, L_UNREGISTER)) {
             v_writeResult result;
@@ -3118,8 +3132,6 @@ v_groupWriteCheckSampleLost(
 
     v_groupCheckForSampleLost(group, msg);
 
-    V_MESSAGE_STAMP(msg, groupInsertTime);
-
     /* If the message constitutes and End Of Transaction (EOT) marker, then send
      * it to its own handling function.
      */
@@ -3140,6 +3152,57 @@ v_groupWriteCheckSampleLost(
 }
 
 
+c_ulong
+v_groupWriteCheckSampleLostBatch(
+    v_group group,
+    v_message *messages,
+    c_ulong length,
+    v_networkId writingNetworkId,
+    v_writeResult *result,
+    v_groupInstance *instancePtr,
+    v_resendScope *resendScope)
+{
+    v_groupInstance instance;
+    v_writeResult r = V_WRITE_SUCCESS;
+    c_ulong i;
+
+    assert(C_TYPECHECK(group,v_group));
+    assert((messages != NULL) || (length == 0));
+    assert(instancePtr != NULL);
+    assert(*instancePtr == NULL);
+
+    /* Readers are triggered once for the whole batch rather than for every
+     * message, after the group is unlocked. */
+    v_dataReaderTriggerDeferBegin();
+    c_mutexLock(&group->mutex);
+    for (i = 0; i < length; i++) {
+        assert(C_TYPECHECK(messages[i],v_message));
+        v_groupCheckForSampleLost(group, messages[i]);
+        instance = NULL;
+        *resendScope = V_RESEND_NONE;
+        if (c_baseMakeMemReservation(c_getBase(group), C_MM_RESERVATION_HIGH)) {
+            if (v_messageStateTest(messages[i], L_ENDOFTRANSACTION)) {
+                r = groupWriteEOT(group, messages[i], writingNetworkId, resendScope);
+            } else {
+                r = groupWrite(group, messages[i], &instance, writingNetworkId, TRUE, NULL, resendScope);
+            }
+            c_baseReleaseMemReservation(c_getBase(group), C_MM_RESERVATION_HIGH);
+        } else {
+            r = V_WRITE_OUT_OF_RESOURCES;
+        }
+        if (r != V_WRITE_SUCCESS) {
+            *instancePtr = instance;
+            break;
+        }
+        c_free(instance);
+    }
+    c_mutexUnlock(&group->mutex);
+    v_dataReaderTriggerDeferEnd();
+
+    *result = r;
+    return i;
+}
+
 static c_bool
 purgeInstanceTimedAction(
     c_object o,
@@ -3685,9 +3748,13 @@ v_groupStreamHistoricalData(
 
     c_mutexLock(&g->mutex);
     updatePurgeList(g, os_timeEGet());
-    h.group = g;
-    h.stream = stream;
-    c_tableWalk(g->instances, streamHistoricalData, &h);
+    if (g->historyTarget == NULL) {
+        (void)groupHistoryDeliver(g, stream, TRUE);
+    } else {
+        h.group = g;
+        h.stream = stream;
+        c_tableWalk(g->instances, streamHistoricalData, &h);
+    }
     c_mutexUnlock(&g->mutex);
 }
 
@@ -3813,6 +3880,151 @@ writeHistoricalData(
 }
 
 
+/* Historical data for a late-joining reader or durability stream is
+ * delivered in chunks of about V_GROUP_HISTORY_CHUNK samples, releasing the
+ * group lock in between so that writers to the group are not blocked for
+ * the duration of the whole delivery. The instance table is walked in key
+ * order, resuming after the last instance handled.
+ *
+ * The target is already connected to the group, so live data reaches it
+ * while the delivery is in progress. To keep live data behind the history of
+ * its instance, each instance is stamped with the epoch of the delivery once
+ * its history has been delivered, and a live write to an instance that is
+ * not yet stamped first delivers the history of that instance. Operations
+ * affecting all instances at once complete the delivery first.
+ *
+ * One chunked delivery per group can be in progress, a concurrent request is
+ * served in a single pass under the group lock.
+ */
+#define V_GROUP_HISTORY_CHUNK (256)
+
+static c_ulong
+groupHistoryDeliverInstance(
+    v_group g,
+    v_groupInstance gi,
+    v_result *result)
+{
+    struct getHistoricalDataArg histArgs;
+    struct streamHelper h;
+
+    gi->historyEpoch = g->historyEpoch;
+    if (g->historyStream) {
+        h.group = g;
+        h.stream = v_groupStream(g->historyTarget);
+        (void)streamHistoricalData(gi, &h);
+    } else {
+        histArgs.entry = v_entry(g->historyTarget);
+        histArgs.includeEOT = FALSE;
+        histArgs.result = V_RESULT_OK;
+        if (!writeHistoricalData(gi, &histArgs)) {
+            *result = histArgs.result;
+        }
+    }
+    return (c_ulong)gi->count;
+}
+
+static void
+groupHistoryFence(
+    v_group g,
+    v_groupInstance gi)
+{
+    v_result result = V_RESULT_OK;
+
+    if ((g->historyTarget != NULL) && (gi->historyEpoch != g->historyEpoch)) {
+        /* Failures are reported by writeHistoricalSample */
+        (void)groupHistoryDeliverInstance(g, gi, &result);
+    }
+}
+
+static c_bool
+groupHistoryCompleteAction(
+    c_object o,
+    c_voidp arg)
+{
+    v_group g = v_group(arg);
+    v_result result = V_RESULT_OK;
+
+    if (v_groupInstance(o)->historyEpoch != g->historyEpoch) {
+        (void)groupHistoryDeliverInstance(g, v_groupInstance(o), &result);
+    }
+    return TRUE;
+}
+
+static void
+groupHistoryComplete(
+    v_group g)
+{
+    if (g->historyTarget != NULL) {
+        (void)c_tableWalk(g->instances, groupHistoryCompleteAction, g);
+    }
+}
+
+static c_bool
+groupHistoryNextChunk(
+    v_group g,
+    v_groupInstance *cursor,
+    v_result *result)
+{
+    v_groupInstance gi;
+    c_ulong count = 0;
+
+    while ((count < V_GROUP_HISTORY_CHUNK) && (*result == V_RESULT_OK)) {
+        gi = v_groupInstance(c_tableNext(g->instances, *cursor));
+        if (gi == NULL) {
+            return TRUE;
+        }
+        if (gi->historyEpoch != g->historyEpoch) {
+            count += groupHistoryDeliverInstance(g, gi, result);
+        }
+        count++;
+        c_free(*cursor);
+        *cursor = c_keep(gi);
+    }
+    return (*result != V_RESULT_OK);
+}
+
+/* Delivers the historical data of g to target (a v_entry, or a v_groupStream
+ * if stream is TRUE). Must be called with the group locked, but temporarily
+ * releases the lock between chunks.
+ */
+static v_result
+groupHistoryDeliver(
+    v_group g,
+    c_voidp target,
+    c_bool stream)
+{
+    v_groupInstance cursor = NULL;
+    v_result result = V_RESULT_OK;
+    c_ulong epoch;
+    c_bool done;
+
+    assert(g->historyTarget == NULL);
+
+    /* Epoch 0 is the stamp of a new instance */
+    if (++g->historyEpoch == 0) {
+        g->historyEpoch++;
+    }
+    epoch = g->historyEpoch;
+    g->historyTarget = target;
+    g->historyStream = stream;
+
+    do {
+        done = groupHistoryNextChunk(g, &cursor, &result);
+        if (!done) {
+            c_mutexUnlock(&g->mutex);
+            c_mutexLock(&g->mutex);
+            /* The target may have been disconnected in the meantime */
+            done = ((g->historyTarget != target) || (g->historyEpoch != epoch));
+        }
+    } while (!done);
+
+    if ((g->historyTarget == target) && (g->historyEpoch == epoch)) {
+        g->historyTarget = NULL;
+    }
+    c_free(cursor);
+    return result;
+}
+
 struct writeTransactionArg {
     v_dataReaderEntry entry;
     v_groupInstance prevGroupInst;
@@ -3906,9 +4118,13 @@ groupGetHistoricalData(
     histArgs.includeEOT = FALSE;
     histArgs.result = V_RESULT_OK;
 
-    success = c_tableWalk(g->instances, writeHistoricalData, &histArgs);
-    assert((success && (histArgs.result == V_RESULT_OK)) ||
-           (!success && (histArgs.result != V_RESULT_OK)));
+    if (g->historyTarget == NULL) {
+        histArgs.result = groupHistoryDeliver(g, e, FALSE);
+    } else {
+        success = c_tableWalk(g->instances, writeHistoricalData, &histArgs);
+        assert((success && (histArgs.result == V_RESULT_OK)) ||
+               (!success && (histArgs.result != V_RESULT_OK)));
+    }
     if (openTransactions && g->transactionAdmin) {
         v_transactionGroupAdmin tgroupadm;
         v_transactionAdminWalkTransactions(g->transactionAdmin, writeHistoricalTransaction, &histArgs);
@@ -285,6 +285,7 @@ v_groupInstanceInit (
     _this->resourceSampleCount  = 0;
     _this->count                = 0;
     _this->state                = 0;
+    _this->historyEpoch         = 0;
     _this->owner.exclusive      = (topicQos->ownership.v.kind == V_OWNERSHIP_EXCLUSIVE);
 
     v_stateSet(_this->state, L_EMPTY);
@@ -1579,7 +1580,6 @@ groupInstanceCreateMessageEOT(
     if (message) {
         message->allocTime = os_timeEGet();
         message->qos = NULL;
-        V_MESSAGE_INIT(message);
     } else {
         OS_REPORT(OS_FATAL,
                   "groupInstanceCreateMessageEOT",V_RESULT_INTERNAL_ERROR,
@@ -345,8 +345,8 @@ v_indexInit(
     index->reader = reader;
     index->sourceKeyList = createKeyList(instanceType, keyList);
     index->messageKeyList = c_keep(keyList);    /* keyList is either topic->messageKeyList or a user-defined keylist */
-    index->objects = c_tableNew(instanceType,keyExpr);
-    index->notEmptyList = c_tableNew(instanceType,keyExpr);
+    index->objects = c_tableNewHashed(instanceType,keyExpr);
+    index->notEmptyList = c_tableNewHashed(instanceType,keyExpr);
 
     if(keyExpr){
         os_freea(keyExpr);
@@ -69,6 +69,7 @@
 #include "v__threadInfo.h"
 #include "v_service.h"
 #include "v_messageQos.h"
+#include "v_latencyTrace.h"
 #include "ut_trace.h"
 #include "os_atomics.h"
 
@@ -93,6 +94,11 @@ v_loadRetentionPeriod(
     v_kernel kernel,
     v_configuration config);
 
+static v_result
+v_loadLatencyTrace(
+    v_kernel kernel,
+    v_configuration config);
+
 static v_result
 v_loadDurabilitySupport(
     v_kernel kernel);
@@ -203,6 +209,9 @@ v_objectKindImage(
     case K_TYPEREPRESENTATION:
         return "K_TYPEREPRESENTATION";
     break;
+    case K_TYPEDESCRIPTOR:
+        return "K_TYPEDESCRIPTOR";
+    break;
     case K_STATUSCONDITION:
         return "STATUSCONDITION";
     break;
@@ -904,6 +913,7 @@ static void init_kernel_type_cache (v_kernel kernel)
         { K_TOPIC,                     "v_topicImpl" },
         { K_TOPIC_ADAPTER,             "v_topicAdapter" },
         { K_TYPEREPRESENTATION,        "v_typeRepresentation" },
+        { K_TYPEDESCRIPTOR,            "v_typeDescriptor" },
         { K_MESSAGE,                   "v_message" },
         { K_MESSAGEEOT,                "v_messageEOT" },
         { K_TRANSACTION,               "v_transaction" },
@@ -1087,6 +1097,7 @@ v_kernelNew(
     kernel->partitions = c_tableNew(v_kernelType(kernel,K_DOMAIN),"name");
     kernel->topics = c_tableNew(v_kernelType(kernel,K_TOPIC),"name");
     kernel->typeRepresentations = c_tableNew(v_kernelType(kernel,K_TYPEREPRESENTATION),"typeName,dataRepresentationId,typeHash.msb,typeHash.lsb");
+    kernel->typeDescriptors = c_tableNewHashed(v_kernelType(kernel,K_TYPEDESCRIPTOR),"descriptor");
     kernel->groupSet = v_groupSetNew(kernel);
     kernel->serviceManager = v_serviceManagerNew(kernel);
     kernel->livelinessLM = v_leaseManagerNew(kernel);
@@ -1118,6 +1129,7 @@ v_kernelNew(
     kernel->deliveryService = NULL;
 
     kernel->durabilitySupport = FALSE;
+    kernel->latencyTraceRate = 0;
 
     return kernel;
 }
@@ -1613,6 +1625,9 @@ v_kernelConfigure(
     if (result == V_RESULT_OK) {
         result = v_loadRetentionPeriod(kernel, config);
     }
+    if (result == V_RESULT_OK) {
+        result = v_loadLatencyTrace(kernel, config);
+    }
     if (result == V_RESULT_OK) {
         result = v_loadDurabilitySupport(kernel);
     }
@@ -1833,6 +1848,44 @@ v_loadRetentionPeriod(
 }
 #undef MILLION
 
+static v_result
+v_loadLatencyTrace(
+    v_kernel kernel,
+    v_configuration config)
+{
+    v_result result = V_RESULT_OK;
+    c_iter iter;
+    v_cfData elementData = NULL;
+    c_value value;
+    v_cfElement root;
+    c_ulong rate;
+
+    assert(kernel != NULL);
+    assert(C_TYPECHECK(kernel,v_kernel));
+    assert(config != NULL);
+    assert(C_TYPECHECK(config,v_configuration));
+
+    root = v_configurationGetRoot(config);
+    iter = v_cfElementXPath(root, "Domain/LatencyTrace/SampleRate/#text");
+    while(c_iterLength(iter) > 0)
+    {
+        elementData = v_cfData(c_iterTakeFirst(iter));
+    }
+    if(iter)
+    {
+        c_iterFree(iter);
+    }
+    if(elementData)/* aka the last one from the previous while loop */
+    {
+        value = v_cfDataValue(elementData);
+        if (sscanf(value.is.String, "%u", &rate) == 1) {
+            v_latencyTraceSetRate(kernel, rate);
+        }
+    }
+    c_free(root);
+    return result;
+}
+
 void
 v_checkMaxInstancesWarningLevel(
     v_kernel _this,
@@ -2406,6 +2459,61 @@ v_condWait (
     return result;
 }
 
+c_type
+v__kernelLookupTypeDescriptor (
+    v_kernel _this,
+    const os_char *xml_descriptor)
+{
+    C_STRUCT(v_typeDescriptor) dummy;
+    v_typeDescriptor found;
+    c_type type = NULL;
+
+    assert(C_TYPECHECK(_this,v_kernel));
+    assert(xml_descriptor != NULL);
+
+    memset(&dummy, 0, sizeof(dummy));
+    /* The table only reads the key, the descriptor is not kept */
+    dummy.descriptor = (c_string) xml_descriptor;
+
+    c_lockRead(&_this->lock);
+    found = c_find(_this->typeDescriptors, &dummy);
+    c_lockUnlock(&_this->lock);
+    if (found != NULL) {
+        type = c_keep(found->type);
+        c_free(found);
+    }
+    return type;
+}
+
+void
+v__kernelAddTypeDescriptor (
+    v_kernel _this,
+    const os_char *xml_descriptor,
+    c_type type)
+{
+    c_base base = c_getBase(c_object(_this));
+    v_typeDescriptor td;
+
+    assert(C_TYPECHECK(_this,v_kernel));
+    assert(xml_descriptor != NULL);
+    assert(type != NULL);
+
+    /* Remembering the descriptor is an optimisation only, so running out of
+     * memory here is no reason to fail the load that preceded it. */
+    td = c_new_s(v_kernelType(_this,K_TYPEDESCRIPTOR));
+    if (td != NULL) {
+        td->descriptor = c_stringNew_s(base, xml_descriptor);
+        if (td->descriptor != NULL) {
+            td->type = c_keep(type);
+            /* A concurrent load of the same descriptor may have won */
+            c_lockWrite(&_this->lock);
+            (void) ospl_c_insert(_this->typeDescriptors, td);
+            c_lockUnlock(&_this->lock);
+        }
+        c_free(td);
+    }
+}
+
 v_result
 v_kernel_load_xml_descriptor (
     v_kernel _this,
@@ -2417,12 +2525,21 @@ v_kernel_load_xml_descriptor (
     c_base base;
     v_result result;
 
+    /* Descriptors are typically loaded again for every participant that uses
+     * the type, and by every process in the domain, so a descriptor that has
+     * been loaded before is looked up rather than parsed. */
+    if ((type = c_metaObject(v__kernelLookupTypeDescriptor(_this, xml_descriptor))) != NULL) {
+        c_free(type);
+        return V_RESULT_OK;
+    }
+
     base = c_getBase(c_object(_this));
     if ( base ) {
         serializer = sd_serializerXMLTypeinfoNew(base, TRUE);
         serData = sd_serializerFromString(serializer, xml_descriptor);
         type = c_metaObject(sd_serializerDeserialize(serializer, serData));
         if (type != NULL) {
+            v__kernelAddTypeDescriptor(_this, xml_descriptor, c_type(type));
             c_free(type);
             result = V_RESULT_OK;
         } else {
@@ -0,0 +1,477 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#include "v__latencyTrace.h"
+#include "v_kernel.h"
+#include "v_public.h"
+#include "os_atomics.h"
+#include "os_heap.h"
+#include "os_mutex.h"
+#include "os_process.h"
+#include "os_report.h"
+#include "os_stdlib.h"
+#include "os_string.h"
+#include "os_thread.h"
+#include "os_time.h"
+
+/* Topic names are copied into the records, longer names are truncated. */
+#define V_LATENCY_NAME_SIZE (64)
+
+/* Number of records in the ring of a thread, must be a power of 2. The
+ * rings are only drained by v_latencyTraceCollect, records that do not fit
+ * in between are dropped and counted.
+ */
+#define V_LATENCY_RING_SIZE (1024u)
+
+/* Histograms are log-linear (HDR-style): values below 2^SUB_BITS ns have a
+ * bucket each, every following power of 2 is split into 2^SUB_BITS equal
+ * buckets, for a relative error of at most 1/2^SUB_BITS (about 3%). Values
+ * are clamped at 2^MAX_BITS ns (about 18 minutes).
+ */
+#define V_LATENCY_SUB_BITS (5)
+#define V_LATENCY_SUB_COUNT (1u << V_LATENCY_SUB_BITS)
+#define V_LATENCY_MAX_BITS (40)
+#define V_LATENCY_BUCKETS ((V_LATENCY_MAX_BITS - V_LATENCY_SUB_BITS + 1) * V_LATENCY_SUB_COUNT)
+
+struct v_latencyRecord {
+    v_gid writerGID;
+    c_ulong sequenceNumber;
+    v_latencyStage stage;
+    os_duration latency;
+    c_char topicName[V_LATENCY_NAME_SIZE];
+};
+
+/* Single producer (the owning thread), single consumer (whoever holds the
+ * collector lock) ring. head is only written by the owner, tail only by the
+ * consumer. orphaned is set when the owning thread terminates, after which
+ * the consumer frees the ring once it has been drained.
+ */
+struct v_latencyRing {
+    struct v_latencyRing *next;
+    pa_uint32_t head;
+    pa_uint32_t tail;
+    pa_uint32_t orphaned;
+    pa_uint32_t dropped;
+    struct v_latencyRecord records[V_LATENCY_RING_SIZE];
+};
+
+struct v_latencyHistogram {
+    c_ulonglong count;
+    os_duration max;
+    v_gid maxWriterGID;
+    c_ulong maxSequenceNumber;
+    c_ulonglong buckets[V_LATENCY_BUCKETS];
+};
+
+struct v_latencyTopic {
+    struct v_latencyTopic *next;
+    c_char name[V_LATENCY_NAME_SIZE];
+    struct v_latencyHistogram *stages[V_LATENCY_STAGE_COUNT];
+};
+
+/* Process-wide collector state, initialised on first use. */
+#define V_LATENCY_UNINITIALISED (0u)
+#define V_LATENCY_INITIALISING  (1u)
+#define V_LATENCY_INITIALISED   (2u)
+
+static pa_uint32_t latencyTraceState = PA_UINT32_INIT(V_LATENCY_UNINITIALISED);
+static os_mutex latencyTraceMutex;
+static struct v_latencyRing *latencyRings = NULL;
+static struct v_latencyTopic *latencyTopics = NULL;
+static c_ulonglong latencyDropped = 0;
+
+static void
+latencyTraceAtExit(void)
+{
+    v_latencyTraceReport();
+}
+
+static void
+latencyTraceLock(void)
+{
+    os_uint32 state = pa_ld32(&latencyTraceState);
+
+    while (state != V_LATENCY_INITIALISED) {
+        if ((state == V_LATENCY_UNINITIALISED) &&
+            pa_cas32(&latencyTraceState, V_LATENCY_UNINITIALISED, V_LATENCY_INITIALISING)) {
+            (void)os_mutexInit(&latencyTraceMutex, NULL);
+            /* Report at exit rather than on detach: the application deletes
+             * its entities within an API call, whose report stack discards
+             * informational reports when the call succeeds. */
+            (void)os_procAtExit(latencyTraceAtExit);
+            pa_fence();
+            pa_st32(&latencyTraceState, V_LATENCY_INITIALISED);
+        } else {
+            (void)os_sleep(OS_DURATION_INIT(0, 1000000));
+        }
+        state = pa_ld32(&latencyTraceState);
+    }
+    os_mutexLock(&latencyTraceMutex);
+}
+
+static void
+latencyTraceUnlock(void)
+{
+    os_mutexUnlock(&latencyTraceMutex);
+}
+
+static c_ulong
+latencyBucketIndex(
+    os_duration latency)
+{
+    os_uint64 v = (latency < 0) ? 0 : (os_uint64)latency;
+    c_ulong msb, shift;
+
+    if (v >= ((os_uint64)1 << V_LATENCY_MAX_BITS)) {
+        v = ((os_uint64)1 << V_LATENCY_MAX_BITS) - 1;
+    }
+    if (v < V_LATENCY_SUB_COUNT) {
+        return (c_ulong)v;
+    }
+    msb = V_LATENCY_SUB_BITS;
+    while ((v >> (msb + 1)) != 0) {
+        msb++;
+    }
+    shift = msb - V_LATENCY_SUB_BITS;
+    return (msb - V_LATENCY_SUB_BITS + 1) * V_LATENCY_SUB_COUNT +
+           (c_ulong)((v >> shift) - V_LATENCY_SUB_COUNT);
+}
+
+/* Returns the largest value that maps on bucket index. */
+static os_duration
+latencyBucketValue(
+    c_ulong index)
+{
+    c_ulong shift;
+    os_uint64 lower;
+
+    if (index < V_LATENCY_SUB_COUNT) {
+        return (os_duration)index;
+    }
+    shift = index / V_LATENCY_SUB_COUNT - 1;
+    lower = (os_uint64)(V_LATENCY_SUB_COUNT + index % V_LATENCY_SUB_COUNT) << shift;
+    return (os_duration)(lower + ((os_uint64)1 << shift) - 1);
+}
+
+static struct v_latencyTopic *
+latencyTopicLookup(
+    const c_char *name)
+{
+    struct v_latencyTopic *topic;
+
+    for (topic = latencyTopics; topic != NULL; topic = topic->next) {
+        if (strcmp(topic->name, name) == 0) {
+            return topic;
+        }
+    }
+    topic = os_malloc(sizeof(*topic));
+    memset(topic, 0, sizeof(*topic));
+    os_strncpy(topic->name, name, sizeof(topic->name) - 1);
+    topic->next = latencyTopics;
+    latencyTopics = topic;
+    return topic;
+}
+
+static void
+latencyHistogramInsert(
+    const struct v_latencyRecord *record)
+{
+    struct v_latencyTopic *topic;
+    struct v_latencyHistogram *h;
+
+    topic = latencyTopicLookup(record->topicName);
+    if ((h = topic->stages[record->stage]) == NULL) {
+        h = os_malloc(sizeof(*h));
+        memset(h, 0, sizeof(*h));
+        topic->stages[record->stage] = h;
+    }
+    h->buckets[latencyBucketIndex(record->latency)]++;
+    if ((h->count == 0) || (record->latency > h->max)) {
+        h->max = record->latency;
+        h->maxWriterGID = record->writerGID;
+        h->maxSequenceNumber = record->sequenceNumber;
+    }
+    h->count++;
+}
+
+/* Drains all rings into the histograms, the collector lock must be held. */
+static void
+latencyTraceCollect(void)
+{
+    struct v_latencyRing *ring, **prev;
+    os_uint32 head, tail, dropped;
+
+    prev = &latencyRings;
+    while ((ring = *prev) != NULL) {
+        /* Read orphaned before head: records of an orphaned ring are all
+         * published before it was marked. */
+        c_bool orphaned = (pa_ld32(&ring->orphaned) != 0);
+        pa_fence_acq();
+        head = pa_ld32(&ring->head);
+        pa_fence_acq();
+        for (tail = pa_ld32(&ring->tail); tail != head; tail++) {
+            latencyHistogramInsert(&ring->records[tail & (V_LATENCY_RING_SIZE - 1)]);
+        }
+        pa_fence_rel();
+        pa_st32(&ring->tail, tail);
+        if ((dropped = pa_ld32(&ring->dropped)) != 0) {
+            latencyDropped += dropped;
+            pa_sub32(&ring->dropped, dropped);
+        }
+        if (orphaned) {
+            *prev = ring->next;
+            os_free(ring);
+        } else {
+            prev = &ring->next;
+        }
+    }
+}
+
+static int
+latencyRingOrphan(
+    void *threadMem,
+    void *arg)
+{
+    struct v_latencyRing *ring = *(struct v_latencyRing **)threadMem;
+
+    OS_UNUSED_ARG(arg);
+
+    pa_fence_rel();
+    pa_st32(&ring->orphaned, 1);
+    return 0;
+}
+
+static struct v_latencyRing *
+latencyRingSelf(void)
+{
+    struct v_latencyRing **self, *ring;
+
+    if ((self = os_threadMemGet(OS_THREAD_LATENCY_TRACE)) != NULL) {
+        return *self;
+    }
+    self = os_threadMemMalloc(OS_THREAD_LATENCY_TRACE, sizeof(*self), latencyRingOrphan, NULL);
+    if (self == NULL) {
+        return NULL;
+    }
+    ring = os_malloc(sizeof(*ring));
+    memset(ring, 0, sizeof(*ring));
+    *self = ring;
+    latencyTraceLock();
+    ring->next = latencyRings;
+    latencyRings = ring;
+    latencyTraceUnlock();
+    return ring;
+}
+
+void
+v_latencyTraceRecord(
+    v_message msg,
+    const c_char *topicName,
+    v_latencyStage stage)
+{
+    struct v_latencyRing *ring;
+    struct v_latencyRecord *record;
+    os_uint32 head;
+    os_timeE now = os_timeEGet();
+
+    assert(msg != NULL);
+    assert(stage < V_LATENCY_STAGE_COUNT);
+
+    if ((ring = latencyRingSelf()) == NULL) {
+        return;
+    }
+    head = pa_ld32(&ring->head);
+    if (head - pa_ld32(&ring->tail) == V_LATENCY_RING_SIZE) {
+        /* The recording thread may hold group or reader locks, so it never
+         * drains the rings itself. */
+        pa_inc32(&ring->dropped);
+        return;
+    }
+    pa_fence_acq();
+    record = &ring->records[head & (V_LATENCY_RING_SIZE - 1)];
+    record->writerGID = msg->writerGID;
+    record->sequenceNumber = msg->sequenceNumber;
+    record->stage = stage;
+    record->latency = os_timeEDiff(now, msg->allocTime);
+    if (topicName != NULL) {
+        os_strncpy(record->topicName, topicName, sizeof(record->topicName) - 1);
+        record->topicName[sizeof(record->topicName) - 1] = '\0';
+    } else {
+        record->topicName[0] = '\0';
+    }
+    pa_fence_rel();
+    pa_st32(&ring->head, head + 1);
+}
+
+void
+v_latencyTraceCollect(void)
+{
+    if (pa_ld32(&latencyTraceState) != V_LATENCY_INITIALISED) {
+        /* Nothing was ever recorded by this process. */
+        return;
+    }
+    latencyTraceLock();
+    latencyTraceCollect();
+    latencyTraceUnlock();
+}
+
+void
+v_latencyTraceSetRate(
+    v_kernel kernel,
+    c_ulong rate)
+{
+    assert(C_TYPECHECK(kernel,v_kernel));
+
+    kernel->latencyTraceRate = rate;
+}
+
+c_ulong
+v_latencyTraceGetRate(
+    v_kernel kernel)
+{
+    assert(C_TYPECHECK(kernel,v_kernel));
+
+    return kernel->latencyTraceRate;
+}
+
+static os_duration
+latencyPercentile(
+    const struct v_latencyHistogram *h,
+    c_ulonglong perMille)
+{
+    c_ulonglong rank, seen = 0;
+    c_ulong i;
+
+    /* The rank of the sample at the given fraction, rounded up. */
+    rank = (h->count * perMille + 999) / 1000;
+    if (rank == 0) {
+        rank = 1;
+    }
+    for (i = 0; i < V_LATENCY_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            /* A bucket value never exceeds the largest stamp seen. */
+            os_duration v = latencyBucketValue(i);
+            return (v < h->max) ? v : h->max;
+        }
+    }
+    return h->max;
+}
+
+void
+v_latencyTraceWalk(
+    v_latencyTraceAction action,
+    c_voidp arg)
+{
+    struct v_latencyTopic *topic;
+    struct v_latencyHistogram *h;
+    v_latencySummary summary;
+    c_ulong stage;
+
+    assert(action != NULL);
+
+    latencyTraceLock();
+    latencyTraceCollect();
+    for (topic = latencyTopics; topic != NULL; topic = topic->next) {
+        for (stage = 0; stage < V_LATENCY_STAGE_COUNT; stage++) {
+            if ((h = topic->stages[stage]) != NULL && h->count > 0) {
+                summary.topicName = topic->name;
+                summary.stage = (v_latencyStage)stage;
+                summary.count = h->count;
+                summary.p50 = latencyPercentile(h, 500);
+                summary.p90 = latencyPercentile(h, 900);
+                summary.p99 = latencyPercentile(h, 990);
+                summary.p999 = latencyPercentile(h, 999);
+                summary.max = h->max;
+                summary.maxWriterGID = h->maxWriterGID;
+                summary.maxSequenceNumber = h->maxSequenceNumber;
+                action(&summary, arg);
+            }
+        }
+    }
+    latencyTraceUnlock();
+}
+
+static void
+latencyReportSummary(
+    const v_latencySummary *summary,
+    c_voidp arg)
+{
+    OS_UNUSED_ARG(arg);
+
+    OS_REPORT(OS_INFO, "v_latencyTraceReport", 0,
+              "topic %s, %s: %"PA_PRIu64" samples, latency on this node "
+              "p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, "
+              "max %.1f us (writer %u:%u:%u, sequence number %u)",
+              summary->topicName, v_latencyStageImage(summary->stage),
+              summary->count,
+              (double)summary->p50 / 1e3, (double)summary->p90 / 1e3,
+              (double)summary->p99 / 1e3, (double)summary->p999 / 1e3,
+              (double)summary->max / 1e3,
+              summary->maxWriterGID.systemId, summary->maxWriterGID.localId,
+              summary->maxWriterGID.serial, summary->maxSequenceNumber);
+}
+
+void
+v_latencyTraceReport(void)
+{
+    if (pa_ld32(&latencyTraceState) != V_LATENCY_INITIALISED) {
+        /* Nothing was ever recorded by this process. */
+        return;
+    }
+    v_latencyTraceWalk(latencyReportSummary, NULL);
+    if (latencyDropped > 0) {
+        OS_REPORT(OS_INFO, "v_latencyTraceReport", 0,
+                  "%"PA_PRIu64" latency stamps were dropped", latencyDropped);
+    }
+}
+
+void
+v_latencyTraceReset(void)
+{
+    struct v_latencyTopic *topic;
+    c_ulong stage;
+
+    latencyTraceLock();
+    latencyTraceCollect();
+    while ((topic = latencyTopics) != NULL) {
+        latencyTopics = topic->next;
+        for (stage = 0; stage < V_LATENCY_STAGE_COUNT; stage++) {
+            os_free(topic->stages[stage]);
+        }
+        os_free(topic);
+    }
+    latencyDropped = 0;
+    latencyTraceUnlock();
+}
+
+const c_char *
+v_latencyStageImage(
+    v_latencyStage stage)
+{
+    switch (stage) {
+    case V_LATENCY_WRITER_WRITE: return "writer write";
+    case V_LATENCY_GROUP_INSERT: return "group insert";
+    case V_LATENCY_NETWORK_QUEUE: return "network queue";
+    case V_LATENCY_READER_INSERT: return "reader insert";
+    case V_LATENCY_READER_TAKE: return "reader take";
+    case V_LATENCY_STAGE_COUNT: break;
+    }
+    return "unknown";
+}
@@ -29,6 +29,7 @@
 #include "v__spliced.h"
 #include "v__processInfo.h"
 #include "v__kernel.h"
+#include "v_latencyTrace.h"
 
 #include "vortex_os.h"
 #include "os_report.h"
@@ -45,6 +46,9 @@
  */
 #define v_leaseAction(o) (C_CAST(o,v_leaseAction))
 
+/* The longest the latency trace rings are left undrained while tracing. */
+#define V_LEASEMANAGER_LATENCY_COLLECT_PERIOD OS_DURATION_INIT(0, 100000000)
+
 /**************************************************************
  * Private function/struct declarations
  **************************************************************/
@@ -660,6 +664,10 @@ v_leaseManagerMain(
 
         shortestPeriod = OS_DURATION_INFINITE;
 
+        if ((timeout > V_LEASEMANAGER_LATENCY_COLLECT_PERIOD) &&
+            (v_latencyTraceGetRate(v_objectKernel(_this)) != 0)) {
+            timeout = V_LEASEMANAGER_LATENCY_COLLECT_PERIOD;
+        }
         if (timeout > 0) {
             waitResult = v_condWait(&_this->cond, &_this->mutex, timeout);
         }
@@ -671,6 +679,14 @@ v_leaseManagerMain(
             (void)c_setWalk(_this->monotonic.leases, (c_action)splicedIsDead, NULL);
             break;
         }
+
+        /* Drain the latency trace rings of this process, at least every
+         * V_LEASEMANAGER_LATENCY_COLLECT_PERIOD while tracing is enabled.
+         * The leases are evaluated again after this, so nothing notified
+         * meanwhile is missed. */
+        c_mutexUnlock(&_this->mutex);
+        v_latencyTraceCollect();
+        c_mutexLock(&_this->mutex);
     }
     _this->quit = FALSE;
     c_mutexUnlock(&_this->mutex);
@@ -20,6 +20,9 @@
 #include "v_kernel.h"
 #include "v_message.h"
 #include "v_public.h"
+#include "v_topic.h"
+#include "v_topicImpl.h"
+#include "v_topicAdapter.h"
 
 /**
  * Compares two sequence-/serial numbers according to RFC 1982.
@@ -123,3 +126,29 @@ v_messageCheckDuplicate (
     return FALSE;
 }
 
+
+void
+v_messageSetKeyHash (
+    v_message _this,
+    v_topic topic)
+{
+    assert(_this != NULL);
+    assert(topic != NULL);
+
+    _this->keyHash = c_keyHash(v_topicMessageKeyList(topic), _this);
+}
+
+c_ulonglong
+v_messageKeyHash (
+    v_message _this,
+    c_array keyList)
+{
+    assert(_this != NULL);
+
+    /* The message may be shared, so it is never updated here. */
+    if (_this->keyHash != 0) {
+        assert(_this->keyHash == c_keyHash(keyList, _this));
+        return _this->keyHash;
+    }
+    return c_keyHash(keyList, _this);
+}
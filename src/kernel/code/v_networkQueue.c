@@ -37,6 +37,7 @@
 #include "v_groupSet.h"
 #include "v_topic.h"
 #include "v_message.h"
+#include "v__latencyTrace.h"
 #include "v_messageQos.h"
 #include "v_fullCounter.h"
 #include "v__processInfo.h"
@@ -205,7 +206,7 @@ v_networkQueueWrite(
     os_compare eq;
     c_bool sendNow = FALSE;
 
-    V_MESSAGE_STAMP(msg,readerInsertTime);
+    V_MESSAGE_TRACE(msg, v_groupTopic(v_group(entry->group)), V_LATENCY_NETWORK_QUEUE);
 
     c_mutexLock(&queue->mutex);
     sendBefore = OS_TIMEE_ZERO;
@@ -320,7 +321,6 @@ v_networkQueueWrite(
         }
         *currentMarkerPtr = marker; /* no keep, transfer refCount */
     }
-    V_MESSAGE_STAMP(msg,readerLookupTime);
     assert(marker != NULL);
     if (queue->freeSamples == NULL) {
         newHolder = c_new(queue->sampleType);
@@ -402,8 +402,6 @@ v_networkQueueTakeFirst(
         assert(sample != NULL);
         result = TRUE;
 
-        V_MESSAGE_STAMP(sample->message,readerDataAvailableTime);
-
         /* Copy values */
         *message = sample->message; /* no keep, transfer refCount */
         sample->message = NULL; /* clean reference because of  refCount transfer */
@@ -737,7 +737,6 @@ v_topicImplMessageNew(
     if (message) {
         message->allocTime = os_timeEGet();
         message->qos = NULL;
-        V_MESSAGE_INIT(message);
     } else {
         OS_REPORT(OS_FATAL,
                   "v_topicMessageNew",V_RESULT_INTERNAL_ERROR,
@@ -759,7 +758,6 @@ v_topicImplMessageNew_s(
     if (message) {
         message->allocTime = os_timeEGet();
         message->qos = NULL;
-        V_MESSAGE_INIT(message);
     } else {
         OS_REPORT(OS_FATAL,
                   "v_topicMessageNew",V_RESULT_INTERNAL_ERROR,
@@ -1295,39 +1293,48 @@ v_topicImplNewFromTopicInfo (
 
     assert(C_TYPECHECK(kernel,v_kernel));
 
-    serializer = sd_serializerXMLTypeinfoNew(c_getBase(c_object(kernel)), FALSE /* do not escape " characters */);
-    if (serializer != NULL) {
-        meta_data = sd_serializerFromString(serializer, info->meta_data);
-        if (meta_data != NULL) {
-            topicType = c_type(sd_serializerDeserialize(serializer, meta_data));
-            if (topicType == NULL) {
-                msg = sd_serializerLastValidationMessage(serializer);
-                loc = sd_serializerLastValidationLocation(serializer);
-                if (loc == NULL) {
-                    OS_REPORT(OS_ERROR, "v_topicImplNewFromTopicInfo", 0,
-                              "Deserialization of type failed: "
-                              "%s at <unknown>", msg);
+    /* The same topic is typically discovered from many remote participants,
+     * so a type descriptor that has been loaded before is looked up rather
+     * than parsed again. */
+    topicType = v__kernelLookupTypeDescriptor(kernel, info->meta_data);
+    if (topicType == NULL) {
+        serializer = sd_serializerXMLTypeinfoNew(c_getBase(c_object(kernel)), FALSE /* do not escape " characters */);
+        if (serializer != NULL) {
+            meta_data = sd_serializerFromString(serializer, info->meta_data);
+            if (meta_data != NULL) {
+                topicType = c_type(sd_serializerDeserialize(serializer, meta_data));
+                if (topicType != NULL) {
+                    v__kernelAddTypeDescriptor(kernel, info->meta_data, topicType);
                 } else {
-                    OS_REPORT(OS_ERROR, "v_topicImplNewFromTopicInfo", 0,
-                              "Deserialization of type failed: "
-                              "%s at %s", msg, loc);
+                    msg = sd_serializerLastValidationMessage(serializer);
+                    loc = sd_serializerLastValidationLocation(serializer);
+                    if (loc == NULL) {
+                        OS_REPORT(OS_ERROR, "v_topicImplNewFromTopicInfo", 0,
+                                  "Deserialization of type failed: "
+                                  "%s at <unknown>", msg);
+                    } else {
+                        OS_REPORT(OS_ERROR, "v_topicImplNewFromTopicInfo", 0,
+                                  "Deserialization of type failed: "
+                                  "%s at %s", msg, loc);
+                    }
                 }
+                sd_serializedDataFree(meta_data);
+            } else {
+                OS_REPORT(OS_ERROR, "v_topicNewFromTopicInfo", 0,
+                          "Failed to create serializedData object");
             }
-            sd_serializedDataFree(meta_data);
+            sd_serializerFree(serializer);
         } else {
             OS_REPORT(OS_ERROR, "v_topicNewFromTopicInfo", 0,
-                      "Failed to create serializedData object");
+                      "Failed to create serializerXMLTypeinfoNew");
         }
-        sd_serializerFree(serializer);
-    } else {
-        OS_REPORT(OS_ERROR, "v_topicNewFromTopicInfo", 0,
-                  "Failed to create serializerXMLTypeinfoNew");
     }
 
     if (topicType != NULL) {
         qos = v_topicQosFromTopicInfo(c_getBase (kernel), info);
         newTopic = v_topicImplNew(kernel, info->name, info->type_name, info->key_list, qos, announce);
         c_free(qos);
+        c_free(topicType);
     }
     return newTopic;
 }
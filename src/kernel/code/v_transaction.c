@@ -379,7 +379,6 @@ transactionAdminCreateSingleMessageEOT(
 
     message = c_new(v_kernelType(v_objectKernel(_this), K_MESSAGEEOT));
     if (message) {
-        V_MESSAGE_INIT(message);
         v_stateSet(v_nodeState(message), L_TRANSACTION | L_ENDOFTRANSACTION);
         message->allocTime = tmpl->allocTime;
         message->writeTime = tmpl->writeTime;
@@ -1067,7 +1066,6 @@ clone_messageEOT(
 
     message = c_new(c_getType(tmpl));
     if (message) {
-        V_MESSAGE_INIT(message);
         v_nodeState(message) = v_nodeState(tmpl);
         v_message(message)->allocTime = v_message(tmpl)->allocTime;
         v_message(message)->writeTime = v_message(tmpl)->writeTime;
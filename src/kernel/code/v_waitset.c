@@ -32,6 +32,7 @@
 #include "v_dataViewQuery.h"
 
 #include "os_report.h"
+#include "os_atomics.h"
 #include "vortex_os.h"
 
 #define WAITSET_BUSY_FLAG (0x80000000)
@@ -108,6 +109,9 @@ v_waitsetNew(
         _this->waitsetEventEnabled = TRUE;
         _this->count = 0;
         _this->waitDisconnectCount = 0;
+        _this->spinLimit = OS_DURATION_ZERO;
+        _this->spinEstimate = OS_DURATION_ZERO;
+        _this->spinAdaptive = FALSE;
         c_condInit(c_getBase(_this), &_this->syncDisconnect, &v_observer(_this)->mutex);
         v_participantAdd(p, v_object(_this));
     }
@@ -281,6 +285,115 @@ test_condition (
     return (events != 0);
 }
 
+/* Spinning: before blocking, a wait polls the event flags of the waitset with
+ * the waitset unlocked for at most the spin budget. With adaptive spinning
+ * the budget is twice a running average of how long recent waits took,
+ * bounded by the spin limit; no spinning is done at all while that average
+ * exceeds the limit.
+ */
+#define SPIN_POLLS_PER_CLOCK_READ (64)
+#define SPIN_ESTIMATE_WEIGHT (8) /* a new observation counts for 1/8 */
+
+void
+v_waitsetSetSpin(
+    v_waitset _this,
+    os_duration limit,
+    c_bool adaptive)
+{
+    assert(_this != NULL);
+    assert(C_TYPECHECK(_this,v_waitset));
+    assert(OS_DURATION_ISPOSITIVE(limit));
+
+    v_waitsetLock(_this);
+    _this->spinLimit = limit;
+    _this->spinAdaptive = adaptive;
+    _this->spinEstimate = OS_DURATION_ZERO;
+    v_waitsetUnlock(_this);
+}
+
+static os_duration
+waitsetSpinBudget(
+    v_waitset _this,
+    const os_duration time)
+{
+    os_duration budget = _this->spinLimit;
+
+    if (_this->spinAdaptive) {
+        if (_this->spinEstimate > budget) {
+            budget = OS_DURATION_ZERO;
+        } else if (2 * _this->spinEstimate < budget) {
+            budget = 2 * _this->spinEstimate;
+        }
+    }
+    return (time < budget) ? time : budget;
+}
+
+static void
+waitsetSpin(
+    v_waitset _this,
+    os_timeM start,
+    os_duration budget)
+{
+    const volatile c_ulong *flags = &v_observer(_this)->eventFlags;
+    os_uint32 i;
+
+    do {
+        for (i = 0; i < SPIN_POLLS_PER_CLOCK_READ; i++) {
+            if (*flags != 0) {
+                return;
+            }
+            pa_spin_hint();
+        }
+    } while (os_timeMDiff(os_timeMGet(), start) < budget);
+}
+
+/* Replaces v__observerTimedWait for the waitset, spinning first if so
+ * configured. Must be called with the waitset locked. */
+static c_ulong
+waitsetTimedWait(
+    v_waitset _this,
+    os_duration time)
+{
+    os_duration budget, waited;
+    os_timeM start;
+    c_ulong flags;
+
+    if (OS_DURATION_ISZERO(_this->spinLimit)) {
+        return v__observerTimedWait(v_observer(_this), time);
+    }
+    start = os_timeMGet();
+    budget = waitsetSpinBudget(_this, time);
+    if (!OS_DURATION_ISZERO(budget) && (v_observer(_this)->eventFlags == 0)) {
+        v_waitsetUnlock(_this);
+        waitsetSpin(_this, start, budget);
+        v_waitsetLock(_this);
+        if (!OS_DURATION_ISINFINITE(time)) {
+            time = os_durationSub(time, os_timeMDiff(os_timeMGet(), start));
+            if (time < 0) {
+                time = OS_DURATION_ZERO;
+            }
+        }
+    }
+    if (v_observer(_this)->eventFlags != 0) {
+        /* Triggered while spinning: v__observerTimedWait would fall through
+         * and return no flags, so return them here, reset the same way. */
+        flags = v_observer(_this)->eventFlags;
+        if (v_observer(_this)->waitCount == 0) {
+            v_observer(_this)->eventFlags &= V_EVENT_OBJECT_DESTROYED;
+        }
+    } else {
+        flags = v__observerTimedWait(v_observer(_this), time);
+    }
+    if (_this->spinAdaptive) {
+        waited = os_timeMDiff(os_timeMGet(), start);
+        if (waited > 2 * _this->spinLimit) {
+            waited = 2 * _this->spinLimit;
+        }
+        _this->spinEstimate += (waited - _this->spinEstimate) / SPIN_ESTIMATE_WEIGHT;
+    }
+    return flags;
+}
+
 #define INITIAL_BUFFER_SIZE (32)
 
 v_result
@@ -361,7 +474,7 @@ v_waitsetWait2(
             }
             if (!(triggered) && (v_observerGetEventFlags(v_observer(_this)) == 0)) {
                 EVENT_TRACE("v_waitsetWait: Enter Timed Wait waitset(0x%x)\n", _this);
-                wait_flags = v__observerTimedWait(v_observer(_this),time);
+                wait_flags = waitsetTimedWait(_this, time);
                 v__observerClearEventFlags(_this);
                 if (wait_flags & V_EVENT_OBJECT_DESTROYED) {
                     result = V_RESULT_DETACHING;
@@ -440,7 +553,7 @@ v_waitsetWait(
            (!(wait_flags & (V_EVENT_OBJECT_DESTROYED | V_EVENT_TIMEOUT))))
     {
         EVENT_TRACE("v_waitsetWait: -- waitset(0x%x) No events => block!\n", _this);
-        wait_flags = v__observerTimedWait(v_observer(_this),time);
+        wait_flags = waitsetTimedWait(_this, time);
         EVENT_TRACE("v_waitsetWait: -- waitset(0x%x) Trigger! => unblock! result flags = 0x%x\n", _this, wait_flags);
         eventList = v_waitsetEvent(v_waitsetEventList(_this));
     }
@@ -55,6 +55,7 @@
 #include "v__deadLineInstance.h"
 #include "v_writerStatistics.h"
 #include "v_message.h"
+#include "v__latencyTrace.h"
 #include "v_messageQos.h"
 
 #include "c_iterator.h"
@@ -127,6 +128,24 @@ v_writerNewInstance(
     return instance;
 }
 
+static v_writerInstance
+v_writerFindInstance(
+    v_writer _this,
+    v_message message)
+{
+    v_writerInstance instance;
+    c_array keyList;
+
+    keyList = v_topicMessageKeyList(_this->topic);
+    instance = c_tableFindHashed(_this->instances,
+                                 v_messageKeyHash(message, keyList),
+                                 keyList, message);
+    /* the instance table keeps the instance alive for a locked writer. */
+    c_free(instance);
+
+    return instance;
+}
+
 static void
 v_writerFreeInstance(
     v_writerInstance instance)
@@ -402,6 +421,9 @@ doWait (
         OS_REPORT(OS_ERROR, "v_writer::doWait", result,
                   "Out of resources: Synchronous DataWriter out of history resources");
     } else {
+        /* Readers whose trigger is deferred (see v_writerWriteBatch) may be
+         * the ones that have to make room, so trigger them before blocking. */
+        v_dataReaderTriggerFlush();
         if (w->infWait == FALSE) {
             relTimeOut = os_timeEDiff(until, os_timeEGet());
             if (relTimeOut > 0) {
@@ -1657,7 +1679,7 @@ v_writerInit(
     v_writerGroupSetInit(&writer->groupSet);
     writer->instanceType = createWriterInstanceType(topic);
     keyExpr = createInstanceKeyExpr(topic);
-    writer->instances = c_tableNew(writer->instanceType, keyExpr);
+    writer->instances = c_tableNewHashed(writer->instanceType, keyExpr);
     if(v__writerNeedsInOrderResends(writer)){
         struct v_writerInOrderAdmin * const admin = v__writerInOrderAdmin(writer);
 
@@ -2293,22 +2315,13 @@ v_writerLookupInstance(
     v_writer w,
     v_message keyTemplate)
 {
-    v_writerInstance instance, found = NULL;
+    v_writerInstance found;
 
     assert(C_TYPECHECK(w,v_writer));
     assert(C_TYPECHECK(keyTemplate,v_message));
 
     v_observerLock(v_observer(w));
-
-    instance = v_writerNewInstance(w, keyTemplate);
-    if (instance) {
-        found = c_find(w->instances, instance);
-        v_writerFreeInstance(instance);
-    } else {
-        OS_REPORT(OS_CRITICAL, "v_writerLookupInstance", V_WRITE_OUT_OF_RESOURCES,
-                  "Out of resources: not enough memory available");
-    }
-
+    found = c_keep(v_writerFindInstance(w, keyTemplate));
     v_observerUnlock(v_observer(w));
 
     return found;
@@ -2353,35 +2366,26 @@ v_writerUnregister(
     return result;
 }
 
-v_writeResult
-v_writerWrite(
+/* Writes a message while the writer is locked. For a synchronous writer
+ * the delivery wait list is returned in waitlist, to be waited on once the
+ * writer is unlocked.
+ */
+static v_writeResult
+writerWriteLocked(
     v_writer w,
     v_message message,
     os_timeW timestamp,
-    v_writerInstance instance)
+    v_writerInstance instance,
+    v_deliveryWaitList *waitlist)
 {
     v_writeResult result = V_WRITE_SUCCESS;
     v_writerInstance found;
     v_writerQos qos;
     os_timeE until = OS_TIMEE_ZERO;
     c_ulong blocked; /* Used for statistics */
-    enum v_livelinessKind livKind;
-    C_STRUCT(v_event) event;
-    v_deliveryWaitList waitlist;
-    os_duration max_blocking_time = OS_DURATION_ZERO;
     const os_timeE nowEl = message->allocTime;
 
-    assert(C_TYPECHECK(w,v_writer));
-    assert(C_TYPECHECK(message,v_message));
-
-    V_MESSAGE_STAMP(message,writerCopyTime);
-
-    v_observerLock(v_observer(w));
-    if (!w->publisher) {
-        v_observerUnlock(v_observer(w));
-        OS_REPORT(OS_ERROR, "v_writerWrite", V_WRITE_ERROR,"Writer is in process of deletion, link to publisher already deleted.");
-        return V_WRITE_ERROR;
-    }
+    assert((waitlist != NULL) || !v_writerIsSynchronous(w));
 
     if (w->statistics) {
         w->statistics->numberOfWrites++;
@@ -2428,13 +2432,18 @@ v_writerWrite(
                     w->statistics->numberOfTimedOutWrites++;
                 }
             }
-            v_observerUnlock(v_observer(w));
             return result;
         }
     }
     message->qos = c_keep(w->msgQos);
 
-    if (instance == NULL) {
+    /* Look up an existing instance before creating a new one, so that
+     * writing to an already registered key does not allocate and discard
+     * an instance, and the key hash is cached for the groups and readers. */
+    if ((instance == NULL) &&
+        ((instance = v_writerFindInstance(w,message)) != NULL)) {
+        result = instanceCheckResources(instance,message,until);
+    } else if (instance == NULL) {
         instance = v_writerNewInstance(w,message);
         if (instance) {
             assert(c_refCount(instance) == 2);
@@ -2504,20 +2513,16 @@ v_writerWrite(
         }
     }
 
-    V_MESSAGE_STAMP(message,writerLookupTime);
-
-    waitlist = NULL;
-
     if (result == V_WRITE_SUCCESS) {
         v_state oldState = v_writerInstanceState(instance);
         message->writerInstanceGID = v_publicGid(v_public(instance));
         message->sequenceNumber = w->sequenceNumber++;
+        V_MESSAGE_TRACE(message, w->topic, V_LATENCY_WRITER_WRITE);
 
         if (v_writerIsSynchronous(w)) {
-            max_blocking_time = w->qos->reliability.v.max_blocking_time;
             /* Collect all currently known connected synchronous DataReaders */
-            waitlist = v_deliveryWaitListNew(w->deliveryGuard,message);
-            if (waitlist) {
+            *waitlist = v_deliveryWaitListNew(w->deliveryGuard,message);
+            if (*waitlist) {
                 v_stateSet(v_nodeState(message), L_SYNCHRONOUS);
             } else {
                 result = V_WRITE_OUT_OF_RESOURCES;
@@ -2549,8 +2554,38 @@ v_writerWrite(
             w->statistics->numberOfTimedOutWrites++;
         }
     }
+    return result;
+}
 
-    livKind = qos->liveliness.v.kind;
+v_writeResult
+v_writerWrite(
+    v_writer w,
+    v_message message,
+    os_timeW timestamp,
+    v_writerInstance instance)
+{
+    v_writeResult result;
+    enum v_livelinessKind livKind;
+    C_STRUCT(v_event) event;
+    v_deliveryWaitList waitlist = NULL;
+    os_duration max_blocking_time = OS_DURATION_ZERO;
+
+    assert(C_TYPECHECK(w,v_writer));
+    assert(C_TYPECHECK(message,v_message));
+
+    v_observerLock(v_observer(w));
+    if (!w->publisher) {
+        v_observerUnlock(v_observer(w));
+        OS_REPORT(OS_ERROR, "v_writerWrite", V_WRITE_ERROR,"Writer is in process of deletion, link to publisher already deleted.");
+        return V_WRITE_ERROR;
+    }
+
+    result = writerWriteLocked(w, message, timestamp, instance, &waitlist);
+    if (waitlist) {
+        max_blocking_time = w->qos->reliability.v.max_blocking_time;
+    }
+
+    livKind = w->qos->liveliness.v.kind;
     assertLiveliness(w);
 
     v_observerUnlock(v_observer(w));
@@ -2583,6 +2618,68 @@ v_writerWrite(
     return result;
 }
 
+v_writeResult
+v_writerWriteBatch(
+    v_writer w,
+    v_message *messages,
+    c_ulong length,
+    os_timeW timestamp)
+{
+    v_writeResult result = V_WRITE_SUCCESS;
+    enum v_livelinessKind livKind;
+    C_STRUCT(v_event) event;
+    c_ulong i;
+
+    assert(C_TYPECHECK(w,v_writer));
+    assert((messages != NULL) || (length == 0));
+
+    if (v_writerIsSynchronous(w)) {
+        /* Every message has to wait for its own acknowledgements. */
+        for (i = 0; (i < length) && (result == V_WRITE_SUCCESS); i++) {
+            result = v_writerWrite(w, messages[i], timestamp, NULL);
+        }
+        return result;
+    }
+
+    if (OS_TIMEW_ISINVALID(timestamp)) {
+        timestamp = os_timeWGet();
+    }
+
+    v_observerLock(v_observer(w));
+    if (!w->publisher) {
+        v_observerUnlock(v_observer(w));
+        OS_REPORT(OS_ERROR, "v_writerWriteBatch", V_WRITE_ERROR,"Writer is in process of deletion, link to publisher already deleted.");
+        return V_WRITE_ERROR;
+    }
+
+    /* Readers are triggered once for the whole batch rather than for every
+     * message, after the writer is unlocked. */
+    v_dataReaderTriggerDeferBegin();
+    for (i = 0; i < length; i++) {
+        assert(C_TYPECHECK(messages[i],v_message));
+        result = writerWriteLocked(w, messages[i], timestamp, NULL, NULL);
+        if (result == V_WRITE_REJECTED) {
+            result = V_WRITE_SUCCESS;
+        } else if (result != V_WRITE_SUCCESS) {
+            break;
+        }
+    }
+
+    livKind = w->qos->liveliness.v.kind;
+    assertLiveliness(w);
+
+    v_observerUnlock(v_observer(w));
+    v_dataReaderTriggerDeferEnd();
+
+    if (livKind == V_LIVELINESS_PARTICIPANT) {
+        event.kind = V_EVENT_LIVELINESS_ASSERT;
+        event.source = v_observable(w);
+        event.data = NULL;
+        v_observableNotify(v_observable(w), &event);
+    }
+    return result;
+}
+
 v_writeResult
 v_writerDispose(
     v_writer _this,
@@ -2778,6 +2875,7 @@ v_writerWriteDispose(
         v_state oldState = v_writerInstanceState(instance);
         message->writerInstanceGID = v_publicGid(v_public(instance));
         message->sequenceNumber = w->sequenceNumber++;
+        V_MESSAGE_TRACE(message, w->topic, V_LATENCY_WRITER_WRITE);
         deadlineUpdate(w, instance, nowEl);
         v_writerInstanceSetState(instance, L_DISPOSED);
         v_writerInstanceResetState(instance, L_UNREGISTER);
@@ -220,6 +220,24 @@ v_groupWriteCheckSampleLost(
     v_networkId writingNetworkId,
     v_resendScope *resendScope);
 
+/**
+ * Writes length messages in order, as if by v_groupWriteCheckSampleLost,
+ * but takes the group lock once and triggers each reader once for the
+ * whole batch. Writing stops at the first message that is not written
+ * successfully. Returns the number of messages written; if that is less
+ * than length, the next message failed with result, and instancePtr and
+ * resendScope are set for it as by v_groupWriteCheckSampleLost.
+ */
+OS_API c_ulong
+v_groupWriteCheckSampleLostBatch(
+    v_group group,
+    v_message *messages,
+    c_ulong length,
+    v_networkId writingNetworkId,
+    v_writeResult *result,
+    v_groupInstance *instancePtr,
+    v_resendScope *resendScope);
+
 /**
  * \brief Disposes all instances in the group and the registered DataReaders.
  *
@@ -0,0 +1,126 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#ifndef V_LATENCYTRACE_H
+#define V_LATENCYTRACE_H
+
+/** \file kernel/include/v_latencyTrace.h
+ *  \brief Sampled latency tracing of the local message delivery path.
+ *
+ * When enabled (a non-zero rate, set at runtime with v_latencyTraceSetRate
+ * or through //OpenSplice/Domain/LatencyTrace/SampleRate) every message
+ * whose sequence number is a multiple of the rate is stamped at each stage
+ * it passes. A stamp is the time elapsed since the message was allocated
+ * on this node, which for a message from another node is when it was
+ * received, so the network and the remote node are not included. Since the
+ * decision only depends on the sequence number all processes on a node
+ * trace the same messages.
+ *
+ * Stamps go into a lock-free ring buffer of the recording thread, so the
+ * message itself is not touched. The rings are drained by
+ * v_latencyTraceCollect, which the lease manager of every participant calls
+ * periodically, into per topic, per stage log-linear histograms that are
+ * reported in the info log when the process exits and can be inspected at
+ * any time with v_latencyTraceWalk. Stamps that do not fit in a ring are
+ * dropped and counted.
+ */
+
+#include "v_kernel.h"
+#include "os_if.h"
+
+#ifdef OSPL_BUILD_CORE
+#define OS_API OS_API_EXPORT
+#else
+#define OS_API OS_API_IMPORT
+#endif
+/* !!!!!!!!NOTE From here no more includes are allowed!!!!!!! */
+
+typedef enum v_latencyStage {
+    V_LATENCY_WRITER_WRITE,     /* accepted by the writer */
+    V_LATENCY_GROUP_INSERT,     /* stored in the group */
+    V_LATENCY_NETWORK_QUEUE,    /* queued for a networking service */
+    V_LATENCY_READER_INSERT,    /* stored in a reader */
+    V_LATENCY_READER_TAKE,      /* read or taken by the application */
+    V_LATENCY_STAGE_COUNT
+} v_latencyStage;
+
+typedef struct v_latencySummary {
+    const c_char *topicName;
+    v_latencyStage stage;
+    c_ulonglong count;
+    os_duration p50;
+    os_duration p90;
+    os_duration p99;
+    os_duration p999;
+    os_duration max;
+    v_gid maxWriterGID;         /* identifies the slowest sample */
+    c_ulong maxSequenceNumber;
+} v_latencySummary;
+
+typedef void (*v_latencyTraceAction)(const v_latencySummary *summary, c_voidp arg);
+
+/**
+ * Sets the sample rate of latency tracing for all processes attached to
+ * the domain. 0 disables tracing, N traces 1 in N messages.
+ */
+OS_API void
+v_latencyTraceSetRate(
+    v_kernel kernel,
+    c_ulong rate);
+
+OS_API c_ulong
+v_latencyTraceGetRate(
+    v_kernel kernel);
+
+/**
+ * Drains the stamps recorded by the threads of this process into the
+ * histograms. Must not be called with entity locks held.
+ */
+OS_API void
+v_latencyTraceCollect(void);
+
+/**
+ * Collects all stamps recorded by this process so far and invokes action
+ * for each topic and stage that has stamps. The summary is only valid for
+ * the duration of the call.
+ */
+OS_API void
+v_latencyTraceWalk(
+    v_latencyTraceAction action,
+    c_voidp arg);
+
+/**
+ * Reports the latency summaries of this process in the info log.
+ */
+OS_API void
+v_latencyTraceReport(void);
+
+/**
+ * Discards all stamps recorded by this process so far.
+ */
+OS_API void
+v_latencyTraceReset(void);
+
+OS_API const c_char *
+v_latencyStageImage(
+    v_latencyStage stage);
+
+#undef OS_API
+
+#endif
@@ -74,41 +74,6 @@ extern "C" {
      (v_messageStateTest(msg, L_ENDOFTRANSACTION)) || \
      (v_message_isSingleTransaction(msg)))
 
-#ifdef _MSG_STAMP_
-
-#define V_MESSAGE_INIT(_this) \
-            v_message(_this)->hops = 0
-
-#define V_MESSAGE_STAMP(_this,_id) { \
-            os_time c_time = os_timeGet(); \
-            v_message(_this)->_id[v_message(_this)->hops] = \
-                (v_hrtime)c_time.tv_sec * (v_hrtime)1000000000 + \
-                (v_hrtime)c_time.tv_nsec; \
-        }
-
-#define V_MESSAGE_SETSTAMP(_this,_id,_time) { \
-            v_message(_this)->_id[v_message(_this)->hops] = \
-                (v_hrtime)_time.tv_sec * (v_hrtime)1000000000 + \
-                (v_hrtime)_time.tv_nsec; \
-        }
-
-#define V_MESSAGE_HOPINC(_this) \
-            v_message(_this)->hops++
-
-#define V_MESSAGE_HOPDEC(_this) \
-            v_message(_this)->hops++
-
-#define V_MESSAGE_REPORT(_this,reader) \
-            v_dataReaderLogMessage(reader,_this)
-
-#else
-#define V_MESSAGE_INIT(_this)
-#define V_MESSAGE_STAMP(_this,_id)
-#define V_MESSAGE_HOPINC(_this)
-#define V_MESSAGE_HOPDEC(_this)
-#define V_MESSAGE_REPORT(_this,reader)
-#endif
-
 /**
  * Returns the relative order two v_message's.
  * @param m1 The address of a v_message
@@ -159,6 +124,37 @@ v_messageCheckDuplicate (
     v_message m1,
     v_message m2);
 
+/**
+ * Stores the hash of the key fields of a message in the message, so that
+ * every stage of the delivery path (writer, group, reader) can use it
+ * without computing it again. Must be called by the creator of the message,
+ * after the key fields are set and before the message is shared.
+ *
+ * @param _this The address of a v_message
+ * @param topic The topic of the message
+ */
+OS_API
+void
+v_messageSetKeyHash (
+    v_message _this,
+    v_topic topic);
+
+/**
+ * Returns the hash of the key fields of a message: the hash stored by
+ * v_messageSetKeyHash, or else a freshly computed one. The message itself is
+ * never modified.
+ *
+ * @param _this The address of a v_message
+ * @param keyList The message key list of the message's topic, as the
+ *                stored hash is only valid for that key list
+ * @return The (non-zero) key hash as defined by c_keyHash
+ */
+OS_API
+c_ulonglong
+v_messageKeyHash (
+    v_message _this,
+    c_array keyList);
+
 #undef OS_API
 
 #if defined (__cplusplus)
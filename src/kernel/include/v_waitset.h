@@ -105,6 +105,23 @@ OS_API v_waitset
 v_waitsetNew(
     v_participant p);
 
+/**
+ * Makes a wait on the waitset poll for events for a while before it blocks,
+ * which saves the wake-up latency of a blocked thread at the expense of CPU
+ * time. By default a waitset never spins.
+ *
+ * \param _this    The waitset.
+ * \param limit    The maximum time spent spinning per wait, 0 disables spinning.
+ * \param adaptive When TRUE the time spent spinning is derived from how long
+ *                 recent waits took, and no spinning is done when events
+ *                 usually take longer than limit to arrive.
+ */
+OS_API void
+v_waitsetSetSpin(
+    v_waitset _this,
+    os_duration limit,
+    c_bool adaptive);
+
 /**
  * Destroys the referenced waitset.
  *
@@ -109,6 +109,19 @@ v_writerWrite(
     os_timeW timestamp,
     v_writerInstance instance);
 
+/**
+ * Writes length messages in order, as if by v_writerWrite without an
+ * instance, but takes the writer lock once and triggers each reader once
+ * for the whole batch. Writing stops at the first message that fails, the
+ * result of which is returned.
+ */
+OS_API v_writeResult
+v_writerWriteBatch(
+    v_writer w,
+    v_message *messages,
+    c_ulong length,
+    os_timeW timestamp);
+
 OS_API v_writeResult
 v_writerDispose(
     v_writer w,
@@ -33,7 +33,9 @@
 #ifdef __linux
 #include <linux/if_packet.h>
 #include <sys/types.h>
+#include <sys/mman.h>
 #include <ifaddrs.h>
+#include <unistd.h>
 
 typedef struct ddsi_tran_factory * ddsi_raweth_factory_t;
 
@@ -43,11 +45,35 @@ typedef struct ddsi_raweth_config
 }
 * ddsi_raweth_config_t;
 
+/* Memory mapped (PACKET_MMAP) receive ring shared with the kernel. The
+   ring is block based (TPACKET_V3): the kernel fills a block with frames
+   and hands it over as a whole, frames are then consumed in order and the
+   block is returned once the last one has been copied out.
+
+   There is deliberately no TX ring: a transmit kick carries a single
+   destination address and DDSI2 hands the transport one packet at a time,
+   so it would still take a system call per packet, plus an extra copy
+   into the ring. Transmission uses sendmsg. */
+
+typedef struct ddsi_raweth_ring
+{
+  unsigned char *m_base;
+  size_t m_size;
+  os_uint32 m_block_size;
+  os_uint32 m_nblocks;
+
+  os_uint32 m_rx_block;
+  os_uint32 m_rx_left;
+  struct tpacket3_hdr *m_rx_frame;
+}
+* ddsi_raweth_ring_t;
+
 typedef struct ddsi_raweth_conn
 {
   struct ddsi_tran_conn m_base;
   os_socket m_sock;
   int m_ifindex;
+  ddsi_raweth_ring_t m_ring;
 }
 * ddsi_raweth_conn_t;
 
@@ -69,6 +95,173 @@ static char *ddsi_raweth_to_string (ddsi_tran_factory_t tran, char *dst, size_t
   return dst;
 }
 
+static struct tpacket_block_desc *ddsi_raweth_ring_rx_block (const ddsi_raweth_ring_t r, os_uint32 idx)
+{
+  return (struct tpacket_block_desc *) (r->m_base + (size_t) idx * r->m_block_size);
+}
+
+static void ddsi_raweth_ring_rx_release (ddsi_raweth_ring_t r)
+{
+  struct tpacket_block_desc *bd = ddsi_raweth_ring_rx_block (r, r->m_rx_block);
+  pa_fence_rel ();
+  bd->hdr.bh1.block_status = TP_STATUS_KERNEL;
+  r->m_rx_block = (r->m_rx_block + 1) % r->m_nblocks;
+  r->m_rx_frame = NULL;
+  r->m_rx_left = 0;
+}
+
+static c_bool ddsi_raweth_ring_rx_ready (const ddsi_raweth_ring_t r)
+{
+  const volatile struct tpacket_block_desc *bd = ddsi_raweth_ring_rx_block (r, r->m_rx_block);
+  return (r->m_rx_frame != NULL) || (bd->hdr.bh1.block_status & TP_STATUS_USER);
+}
+
+static void ddsi_raweth_ring_free (os_socket sock, ddsi_raweth_ring_t r)
+{
+  struct tpacket_req3 req;
+
+  /* Unmapping and then requesting a zero-sized ring releases the kernel
+     side, after which the socket is usable with recvmsg again */
+
+  if (r->m_base)
+  {
+    munmap (r->m_base, r->m_size);
+  }
+  memset (&req, 0, sizeof (req));
+  (void) setsockopt (sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof (req));
+  os_free (r);
+}
+
+static ddsi_raweth_ring_t ddsi_raweth_ring_new (os_socket sock)
+{
+  const os_uint32 bs = config.raweth_ring_block_size;
+  const os_uint32 nb = config.raweth_ring_blocks;
+  const long pagesize = sysconf (_SC_PAGESIZE);
+  int version = TPACKET_V3;
+  struct tpacket_req3 req;
+  ddsi_raweth_ring_t r;
+  os_uint32 fs;
+  os_int64 tov;
+  void *base;
+
+  if (pagesize <= 0 || bs < (os_uint32) pagesize || (bs % (os_uint32) pagesize) != 0 || (bs & (bs - 1)) != 0 || nb == 0)
+  {
+    NN_WARNING2 ("raweth: packet ring block size %u / count %u invalid, using system calls\n", bs, nb);
+    return NULL;
+  }
+  if (setsockopt (sock, SOL_PACKET, PACKET_VERSION, &version, sizeof (version)) == -1)
+  {
+    NN_WARNING1 ("raweth: TPACKET_V3 not supported (errno %d), using system calls\n", os_getErrno ());
+    return NULL;
+  }
+
+  /* Frames are sized for the largest message DDSI2 sends, the kernel
+     ignores the frame size of a V3 ring apart from the consistency checks */
+
+  fs = TPACKET_ALIGNMENT;
+  while (fs < TPACKET_ALIGN (sizeof (struct tpacket3_hdr)) + config.max_msg_size && fs < bs)
+  {
+    fs *= 2;
+  }
+  tov = config.raweth_ring_block_timeout / T_MILLISECOND;
+
+  r = os_malloc (sizeof (*r));
+  memset (r, 0, sizeof (*r));
+  r->m_block_size = bs;
+  r->m_nblocks = nb;
+
+  memset (&req, 0, sizeof (req));
+  req.tp_block_size = bs;
+  req.tp_block_nr = nb;
+  req.tp_frame_size = fs;
+  req.tp_frame_nr = (bs / fs) * nb;
+  req.tp_retire_blk_tov = (unsigned) (tov < 1 ? 1 : tov);
+  if (setsockopt (sock, SOL_PACKET, PACKET_RX_RING, &req, sizeof (req)) == -1)
+  {
+    NN_WARNING1 ("raweth: PACKET_RX_RING failed (errno %d), using system calls\n", os_getErrno ());
+    os_free (r);
+    return NULL;
+  }
+  r->m_size = (size_t) bs * nb;
+
+  base = mmap (NULL, r->m_size, PROT_READ | PROT_WRITE, MAP_SHARED, sock, 0);
+  if (base == MAP_FAILED)
+  {
+    NN_WARNING1 ("raweth: mmap of packet ring failed (errno %d), using system calls\n", os_getErrno ());
+    ddsi_raweth_ring_free (sock, r);
+    return NULL;
+  }
+  r->m_base = base;
+
+  nn_log (LC_CONFIG, "raweth: socket %d packet ring %u x %u bytes\n", (int) sock, nb, bs);
+  return r;
+}
+
+static os_ssize_t ddsi_raweth_ring_read (ddsi_raweth_conn_t uc, unsigned char * buf, os_size_t len, nn_locator_t *srcloc)
+{
+  ddsi_raweth_ring_t r = uc->m_ring;
+  const struct tpacket3_hdr *hdr;
+  const struct sockaddr_ll *src;
+  os_size_t n;
+
+  if (r->m_rx_frame == NULL)
+  {
+    struct tpacket_block_desc *bd = ddsi_raweth_ring_rx_block (r, r->m_rx_block);
+    if (! (((volatile struct tpacket_block_desc *) bd)->hdr.bh1.block_status & TP_STATUS_USER))
+    {
+      return -1;
+    }
+    pa_fence_acq ();
+    if (bd->hdr.bh1.num_pkts == 0)
+    {
+      ddsi_raweth_ring_rx_release (r);
+      return -1;
+    }
+    r->m_rx_left = bd->hdr.bh1.num_pkts;
+    r->m_rx_frame = (struct tpacket3_hdr *) ((unsigned char *) bd + bd->hdr.bh1.offset_to_first_pkt);
+  }
+
+  hdr = r->m_rx_frame;
+  src = (const struct sockaddr_ll *) ((const unsigned char *) hdr + TPACKET_ALIGN (sizeof (*hdr)));
+  n = hdr->tp_snaplen;
+  if (n > len || hdr->tp_snaplen < hdr->tp_len)
+  {
+    char addrbuf[DDSI_LOCSTRLEN];
+    snprintf(addrbuf, sizeof(addrbuf), "[%02x:%02x:%02x:%02x:%02x:%02x]:%u",
+             src->sll_addr[0], src->sll_addr[1], src->sll_addr[2],
+             src->sll_addr[3], src->sll_addr[4], src->sll_addr[5], ntohs(src->sll_protocol));
+    NN_WARNING3 ("%s => %d truncated to %d\n", addrbuf, (int) hdr->tp_len, (int) (n > len ? len : n));
+    if (n > len)
+    {
+      n = len;
+    }
+  }
+  memcpy (buf, (const unsigned char *) hdr + hdr->tp_net, n);
+  if (srcloc)
+  {
+    srcloc->kind = NN_LOCATOR_KIND_RAWETH;
+    srcloc->port = ntohs (src->sll_protocol);
+    memset(srcloc->address, 0, 10);
+    memcpy(srcloc->address + 10, src->sll_addr, 6);
+  }
+
+  if (--r->m_rx_left == 0)
+  {
+    ddsi_raweth_ring_rx_release (r);
+  }
+  else
+  {
+    r->m_rx_frame = (struct tpacket3_hdr *) ((unsigned char *) hdr + hdr->tp_next_offset);
+  }
+  return (os_ssize_t) n;
+}
+
+static c_bool ddsi_raweth_conn_pending (ddsi_tran_conn_t conn)
+{
+  ddsi_raweth_conn_t uc = (ddsi_raweth_conn_t) conn;
+  return (uc->m_ring != NULL) && ddsi_raweth_ring_rx_ready (uc->m_ring);
+}
+
 static os_ssize_t ddsi_raweth_conn_read (ddsi_tran_conn_t conn, unsigned char * buf, os_size_t len, nn_locator_t *srcloc)
 {
   int err;
@@ -78,6 +271,11 @@ static os_ssize_t ddsi_raweth_conn_read (ddsi_tran_conn_t conn, unsigned char *
   struct iovec msg_iov;
   socklen_t srclen = (socklen_t) sizeof (src);
 
+  if (((ddsi_raweth_conn_t) conn)->m_ring)
+  {
+    return ddsi_raweth_ring_read ((ddsi_raweth_conn_t) conn, buf, len, srcloc);
+  }
+
   msg_iov.iov_base = (void*) buf;
   msg_iov.iov_len = len;
 
@@ -238,6 +436,10 @@ static ddsi_tran_conn_t ddsi_raweth_create_conn (os_uint32 port, ddsi_tran_qos_t
   memset (uc, 0, sizeof (*uc));
   uc->m_sock = sock;
   uc->m_ifindex = addr.sll_ifindex;
+  if (config.raweth_ring_enable)
+  {
+    uc->m_ring = ddsi_raweth_ring_new (sock);
+  }
   ddsi_factory_conn_init (&ddsi_raweth_factory_g, &uc->m_base);
   uc->m_base.m_base.m_port = port;
   uc->m_base.m_base.m_trantype = DDSI_TRAN_CONN;
@@ -246,6 +448,7 @@ static ddsi_tran_conn_t ddsi_raweth_create_conn (os_uint32 port, ddsi_tran_qos_t
   uc->m_base.m_base.m_locator_fn = ddsi_raweth_conn_locator;
   uc->m_base.m_read_fn = ddsi_raweth_conn_read;
   uc->m_base.m_write_fn = ddsi_raweth_conn_write;
+  uc->m_base.m_pending_fn = ddsi_raweth_conn_pending;
 
   nn_log(LC_INFO, "ddsi_raweth_create_conn %s socket %d port %u\n", mcast ? "multicast" : "unicast", uc->m_sock, uc->m_base.m_base.m_port);
   return uc ? &uc->m_base : NULL;
@@ -307,6 +510,10 @@ static void ddsi_raweth_release_conn (ddsi_tran_conn_t conn)
     uc->m_sock,
     uc->m_base.m_base.m_port
   );
+  if (uc->m_ring)
+  {
+    ddsi_raweth_ring_free (uc->m_sock, uc->m_ring);
+  }
   os_sockFree (uc->m_sock);
   os_free (conn);
 }
@@ -0,0 +1,815 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+#include <stddef.h>
+#include "os_heap.h"
+#include "os_stdlib.h"
+#include "ddsi_tran.h"
+#include "ddsi_shm.h"
+#include "q_nwif.h"
+#include "q_config.h"
+#include "q_log.h"
+#include "q_error.h"
+#include "os_errno.h"
+#include "os_atomics.h"
+
+#ifdef __linux
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+/* Host-local transport: every connection owns a mailbox, a POSIX shared
+   memory segment named after the process id and the port number. A
+   mailbox holds one single-producer/single-consumer ring of fixed size
+   slots per sending process, a sender claims a ring once and from then
+   on is its only producer. Multicast is emulated by delivering to the
+   mailbox with the same port of every process listed in a host-wide
+   registry.
+
+   The receive thread waits on a unix domain datagram socket bound to an
+   abstract name derived from the mailbox name. A receiver that finds its
+   rings empty sets a flag in the mailbox, and the first sender to see it
+   set sends a single byte to wake the receiver up. While data keeps
+   arriving no system calls are made at all.
+
+   Locators of this kind carry the host id in the first four bytes and
+   the process id in the last four bytes of the address; process id 0 is
+   the multicast address.
+
+   All segments are private to the user running the service (mode 0600,
+   one registry per user), and a mailbox of another user is never written
+   to. The contents of a segment can nevertheless be corrupted by any
+   process of that user, so both sides work with the ring geometry they
+   established themselves and check every slot length before using it. */
+
+#define DDSI_SHM_MAGIC 0x44534d31 /* "DSM1" */
+#define DDSI_SHM_MAX_PROCESSES 32
+#define DDSI_SHM_RING_SLOTS 64
+#define DDSI_SHM_CACHELINE 64
+#define DDSI_SHM_REGISTRY_NAME "/ddsi2shm.%u"
+#define DDSI_SHM_MODE 0600
+
+struct ddsi_shm_registry
+{
+  pa_uint32_t m_pid[DDSI_SHM_MAX_PROCESSES];
+};
+
+struct ddsi_shm_ring
+{
+  pa_uint32_t m_producer;
+  pa_uint32_t m_head;
+  char m_pad0[DDSI_SHM_CACHELINE - 2 * sizeof (pa_uint32_t)];
+  pa_uint32_t m_tail;
+  char m_pad1[DDSI_SHM_CACHELINE - sizeof (pa_uint32_t)];
+};
+
+struct ddsi_shm_slot
+{
+  os_uint32 m_len;
+  os_uint32 m_srcport;
+  os_uint32 m_srcpid;
+  os_uint32 m_pad;
+};
+
+struct ddsi_shm_mailbox
+{
+  pa_uint32_t m_magic;
+  pa_uint32_t m_waiting;
+  os_uint32 m_owner;
+  os_uint32 m_nrings;
+  os_uint32 m_nslots;
+  os_uint32 m_slot_size;
+  char m_pad[DDSI_SHM_CACHELINE - 6 * sizeof (os_uint32)];
+  struct ddsi_shm_ring m_rings[DDSI_SHM_MAX_PROCESSES];
+};
+
+/* Mailbox of another (or the same) process, mapped for writing */
+
+/* Ring geometry of a mailbox, as validated (sender) or set (receiver) by
+   this process: the copies in the segment itself are not trusted */
+
+struct ddsi_shm_geometry
+{
+  os_uint32 m_nrings;
+  os_uint32 m_nslots;
+  os_uint32 m_slot_size;
+};
+
+struct ddsi_shm_peer
+{
+  os_uint32 m_pid;
+  os_uint32 m_port;
+  struct ddsi_shm_mailbox *m_mbox;
+  size_t m_size;
+  struct ddsi_shm_geometry m_geom;
+  struct ddsi_shm_ring *m_ring;
+  os_uint32 m_head;
+};
+
+typedef struct ddsi_shm_conn
+{
+  struct ddsi_tran_conn m_base;
+  os_socket m_sock;
+  struct ddsi_shm_mailbox *m_mbox;
+  size_t m_size;
+  struct ddsi_shm_geometry m_geom;
+  os_uint32 m_next_ring;
+  char m_name[64];
+}
+* ddsi_shm_conn_t;
+
+typedef struct ddsi_shm_config
+{
+  os_uint32 m_hostid;
+  os_uint32 m_pid;
+  int m_regidx;
+  struct ddsi_shm_registry *m_registry;
+  os_socket m_wakesock;
+  os_mutex m_lock;
+  struct ddsi_shm_peer *m_peers;
+  unsigned m_npeers;
+  unsigned m_maxpeers;
+}
+* ddsi_shm_config_t;
+
+static struct ddsi_shm_config ddsi_shm_config_g;
+static struct ddsi_tran_factory ddsi_shm_factory_g;
+static pa_uint32_t init_g = PA_UINT32_INIT(0);
+
+static size_t ddsi_shm_mailbox_size (os_uint32 nslots, os_uint32 slot_size)
+{
+  return sizeof (struct ddsi_shm_mailbox) + (size_t) DDSI_SHM_MAX_PROCESSES * nslots * slot_size;
+}
+
+static os_uint32 ddsi_shm_payload_size (const struct ddsi_shm_geometry *geom)
+{
+  return geom->m_slot_size - (os_uint32) sizeof (struct ddsi_shm_slot);
+}
+
+static struct ddsi_shm_slot *ddsi_shm_slot (const struct ddsi_shm_mailbox *mb, const struct ddsi_shm_geometry *geom, os_uint32 ring, os_uint32 idx)
+{
+  const size_t off = ((size_t) ring * geom->m_nslots + (idx % geom->m_nslots)) * geom->m_slot_size;
+  assert (ring < geom->m_nrings);
+  return (struct ddsi_shm_slot *) ((char *) mb + sizeof (*mb) + off);
+}
+
+static void ddsi_shm_mailbox_name (char *dst, size_t size, os_uint32 pid, os_uint32 port)
+{
+  snprintf (dst, size, "/ddsi2shm.%u.%u", pid, port);
+}
+
+static socklen_t ddsi_shm_wakeup_addr (struct sockaddr_un *addr, const char *name)
+{
+  /* Abstract namespace: leading NUL, not NUL-terminated, no file system entry */
+  size_t n = strlen (name);
+  memset (addr, 0, sizeof (*addr));
+  addr->sun_family = AF_UNIX;
+  memcpy (addr->sun_path + 1, name, n);
+  return (socklen_t) (offsetof (struct sockaddr_un, sun_path) + 1 + n);
+}
+
+static c_bool ddsi_shm_pid_alive (os_uint32 pid)
+{
+  return (kill ((pid_t) pid, 0) == 0 || os_getErrno () != ESRCH);
+}
+
+static void ddsi_shm_loc_set (nn_locator_t *loc, os_uint32 hostid, os_uint32 pid, os_uint32 port)
+{
+  os_uint32 x;
+  loc->kind = NN_LOCATOR_KIND_SHM;
+  loc->port = port;
+  memset (loc->address, 0, sizeof (loc->address));
+  x = htonl (hostid);
+  memcpy (loc->address, &x, 4);
+  x = htonl (pid);
+  memcpy (loc->address + 12, &x, 4);
+}
+
+static os_uint32 ddsi_shm_loc_hostid (const nn_locator_t *loc)
+{
+  os_uint32 x;
+  memcpy (&x, loc->address, 4);
+  return ntohl (x);
+}
+
+static os_uint32 ddsi_shm_loc_pid (const nn_locator_t *loc)
+{
+  os_uint32 x;
+  memcpy (&x, loc->address + 12, 4);
+  return ntohl (x);
+}
+
+void ddsi_shm_own_locator (nn_locator_t *loc)
+{
+  ddsi_shm_loc_set (loc, ddsi_shm_config_g.m_hostid, ddsi_shm_config_g.m_pid, NN_LOCATOR_PORT_INVALID);
+}
+
+static char *ddsi_shm_to_string (ddsi_tran_factory_t tran, char *dst, size_t sizeof_dst, const nn_locator_t *loc, int with_port)
+{
+  (void)tran;
+  if (with_port)
+    snprintf (dst, sizeof_dst, "%x.%u:%u", ddsi_shm_loc_hostid (loc), ddsi_shm_loc_pid (loc), loc->port);
+  else
+    snprintf (dst, sizeof_dst, "%x.%u", ddsi_shm_loc_hostid (loc), ddsi_shm_loc_pid (loc));
+  return dst;
+}
+
+static enum ddsi_locator_from_string_result ddsi_shm_address_from_string (ddsi_tran_factory_t tran, nn_locator_t *loc, const char *str)
+{
+  unsigned hostid, pid;
+  int pos;
+  (void)tran;
+  if (os_strcasecmp (str, "all") == 0)
+  {
+    ddsi_shm_loc_set (loc, ddsi_shm_config_g.m_hostid, 0, NN_LOCATOR_PORT_INVALID);
+    return AFSR_OK;
+  }
+  if (sscanf (str, "%x.%u%n", &hostid, &pid, &pos) != 2 || str[pos] != 0)
+    return AFSR_INVALID;
+  ddsi_shm_loc_set (loc, hostid, pid, NN_LOCATOR_PORT_INVALID);
+  return AFSR_OK;
+}
+
+static c_bool ddsi_shm_supports (os_int32 kind)
+{
+  return (kind == NN_LOCATOR_KIND_SHM);
+}
+
+static int ddsi_shm_is_mcaddr (const ddsi_tran_factory_t tran, const nn_locator_t *loc)
+{
+  (void) tran;
+  assert (loc->kind == NN_LOCATOR_KIND_SHM);
+  return ddsi_shm_loc_pid (loc) == 0;
+}
+
+static enum ddsi_nearby_address_result ddsi_shm_is_nearby_address (ddsi_tran_factory_t tran, const nn_locator_t *loc, size_t ninterf, const struct nn_interface interf[])
+{
+  (void) tran;
+  (void) ninterf;
+  (void) interf;
+  return (ddsi_shm_loc_hostid (loc) == ddsi_shm_config_g.m_hostid) ? DNAR_SAME : DNAR_DISTANT;
+}
+
+static int ddsi_shm_enumerate_interfaces (ddsi_tran_factory_t factory, int max, struct os_ifAttributes_s *interfs)
+{
+  (void) factory;
+  if (max < 1)
+    return 0;
+  memset (&interfs[0], 0, sizeof (interfs[0]));
+  os_strncpy (interfs[0].name, "shm", sizeof (interfs[0].name));
+  interfs[0].flags = IFF_UP | IFF_MULTICAST | IFF_LOOPBACK;
+  interfs[0].address.ss_family = AF_UNIX;
+  interfs[0].network_mask.ss_family = AF_UNIX;
+  return 1;
+}
+
+/* Sending side */
+
+static void ddsi_shm_peer_detach (struct ddsi_shm_peer *p)
+{
+  munmap (p->m_mbox, p->m_size);
+  *p = ddsi_shm_config_g.m_peers[--ddsi_shm_config_g.m_npeers];
+}
+
+static struct ddsi_shm_peer *ddsi_shm_peer_attach (os_uint32 pid, os_uint32 port)
+{
+  ddsi_shm_config_t cfg = &ddsi_shm_config_g;
+  struct ddsi_shm_mailbox *mb;
+  struct ddsi_shm_geometry geom;
+  struct ddsi_shm_peer *p;
+  struct stat st;
+  char name[64];
+  void *base;
+  unsigned i;
+  int fd;
+
+  for (i = 0; i < cfg->m_npeers; i++)
+  {
+    p = &cfg->m_peers[i];
+    if (p->m_pid == pid && p->m_port == port)
+    {
+      if (pa_ld32 (&p->m_mbox->m_magic) == DDSI_SHM_MAGIC)
+        return p;
+      /* Owner closed the mailbox, a new one may have taken its place */
+      ddsi_shm_peer_detach (p);
+      break;
+    }
+  }
+
+  ddsi_shm_mailbox_name (name, sizeof (name), pid, port);
+  if ((fd = shm_open (name, O_RDWR, 0)) == -1)
+    return NULL;
+  if (fstat (fd, &st) == -1 || (size_t) st.st_size < sizeof (*mb) || st.st_uid != geteuid ())
+  {
+    close (fd);
+    return NULL;
+  }
+  base = mmap (NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (base == MAP_FAILED)
+    return NULL;
+  mb = base;
+  geom.m_nrings = mb->m_nrings;
+  geom.m_nslots = mb->m_nslots;
+  geom.m_slot_size = mb->m_slot_size;
+  if (pa_ld32 (&mb->m_magic) != DDSI_SHM_MAGIC ||
+      geom.m_nrings == 0 || geom.m_nrings > DDSI_SHM_MAX_PROCESSES ||
+      geom.m_nslots == 0 || geom.m_nslots > DDSI_SHM_RING_SLOTS ||
+      geom.m_slot_size <= sizeof (struct ddsi_shm_slot) || (geom.m_slot_size % 8) != 0 ||
+      ddsi_shm_mailbox_size (geom.m_nslots, geom.m_slot_size) > (size_t) st.st_size)
+  {
+    munmap (base, (size_t) st.st_size);
+    return NULL;
+  }
+
+  if (cfg->m_npeers == cfg->m_maxpeers)
+  {
+    cfg->m_maxpeers = cfg->m_maxpeers ? 2 * cfg->m_maxpeers : 8;
+    cfg->m_peers = os_realloc (cfg->m_peers, cfg->m_maxpeers * sizeof (*cfg->m_peers));
+  }
+  p = &cfg->m_peers[cfg->m_npeers];
+  p->m_pid = pid;
+  p->m_port = port;
+  p->m_mbox = mb;
+  p->m_size = (size_t) st.st_size;
+  p->m_geom = geom;
+  p->m_ring = NULL;
+
+  /* Claim a ring: ours from an earlier attach, a free one, or one left
+     behind by a process that no longer exists. The head is simply
+     continued, anything the old producer left is still delivered. */
+  for (i = 0; i < geom.m_nrings && p->m_ring == NULL; i++)
+  {
+    struct ddsi_shm_ring *r = &mb->m_rings[i];
+    os_uint32 owner = pa_ld32 (&r->m_producer);
+    if (owner == cfg->m_pid ||
+        (owner == 0 && pa_cas32 (&r->m_producer, 0, cfg->m_pid)) ||
+        (owner != 0 && !ddsi_shm_pid_alive (owner) && pa_cas32 (&r->m_producer, owner, cfg->m_pid)))
+    {
+      p->m_ring = r;
+      p->m_head = pa_ld32 (&r->m_head);
+    }
+  }
+  if (p->m_ring == NULL)
+  {
+    NN_WARNING2 ("shm: no free ring in mailbox %s (%u processes)\n", name, geom.m_nrings);
+    munmap (base, (size_t) st.st_size);
+    return NULL;
+  }
+  cfg->m_npeers++;
+  return p;
+}
+
+static void ddsi_shm_peer_put (struct ddsi_shm_peer *p, os_uint32 srcport, size_t niov, const ddsi_iovec_t *iov, size_t len)
+{
+  struct ddsi_shm_mailbox *mb = p->m_mbox;
+  struct ddsi_shm_slot *slot;
+  char *data;
+  size_t i;
+
+  if (len > ddsi_shm_payload_size (&p->m_geom))
+  {
+    NN_WARNING3 ("shm: message of %u bytes dropped, slots of process %u hold %u bytes\n",
+                 (unsigned) len, p->m_pid, ddsi_shm_payload_size (&p->m_geom));
+    return;
+  }
+  if (p->m_head - pa_ld32 (&p->m_ring->m_tail) >= p->m_geom.m_nslots)
+  {
+    /* Receiver not keeping up: drop, just like a full socket buffer */
+    return;
+  }
+
+  slot = ddsi_shm_slot (mb, &p->m_geom, (os_uint32) (p->m_ring - mb->m_rings), p->m_head);
+  slot->m_len = (os_uint32) len;
+  slot->m_srcport = srcport;
+  slot->m_srcpid = ddsi_shm_config_g.m_pid;
+  data = (char *) (slot + 1);
+  for (i = 0; i < niov; i++)
+  {
+    memcpy (data, iov[i].iov_base, iov[i].iov_len);
+    data += iov[i].iov_len;
+  }
+  pa_fence_rel ();
+  pa_st32 (&p->m_ring->m_head, ++p->m_head);
+
+  /* Pairs with the fence in ddsi_shm_conn_read between setting the
+     waiting flag and rechecking the rings */
+  pa_fence ();
+  if (pa_ld32 (&mb->m_waiting) && pa_cas32 (&mb->m_waiting, 1, 0))
+  {
+    struct sockaddr_un addr;
+    char name[64];
+    socklen_t addrlen;
+    ddsi_shm_mailbox_name (name, sizeof (name), p->m_pid, p->m_port);
+    addrlen = ddsi_shm_wakeup_addr (&addr, name);
+    (void) sendto (ddsi_shm_config_g.m_wakesock, "", 1, MSG_DONTWAIT, (struct sockaddr *) &addr, addrlen);
+  }
+}
+
+static os_ssize_t ddsi_shm_conn_write (ddsi_tran_conn_t conn, const nn_locator_t *dst, size_t niov, const ddsi_iovec_t *iov, os_uint32 flags)
+{
+  ddsi_shm_config_t cfg = &ddsi_shm_config_g;
+  const os_uint32 srcport = conn->m_base.m_port;
+  const os_uint32 pid = ddsi_shm_loc_pid (dst);
+  struct ddsi_shm_peer *p;
+  size_t i, len = 0;
+  (void) flags;
+
+  for (i = 0; i < niov; i++)
+    len += iov[i].iov_len;
+  if (ddsi_shm_loc_hostid (dst) != cfg->m_hostid)
+  {
+    /* Not on this host: unreachable, silently dropped */
+    return (os_ssize_t) len;
+  }
+
+  os_mutexLock (&cfg->m_lock);
+  if (pid != 0)
+  {
+    if ((p = ddsi_shm_peer_attach (pid, dst->port)) != NULL)
+      ddsi_shm_peer_put (p, srcport, niov, iov, len);
+  }
+  else
+  {
+    int j;
+    for (j = 0; j < DDSI_SHM_MAX_PROCESSES; j++)
+    {
+      os_uint32 rpid = pa_ld32 (&cfg->m_registry->m_pid[j]);
+      if (rpid == 0)
+        continue;
+      if ((p = ddsi_shm_peer_attach (rpid, dst->port)) != NULL)
+        ddsi_shm_peer_put (p, srcport, niov, iov, len);
+      else if (!ddsi_shm_pid_alive (rpid))
+        (void) pa_cas32 (&cfg->m_registry->m_pid[j], rpid, 0);
+    }
+  }
+  os_mutexUnlock (&cfg->m_lock);
+  return (os_ssize_t) len;
+}
+
+/* Receiving side */
+
+static c_bool ddsi_shm_mailbox_nonempty (const struct ddsi_shm_mailbox *mb, const struct ddsi_shm_geometry *geom)
+{
+  os_uint32 i;
+  for (i = 0; i < geom->m_nrings; i++)
+  {
+    if (pa_ld32 (&mb->m_rings[i].m_head) != pa_ld32 (&mb->m_rings[i].m_tail))
+      return TRUE;
+  }
+  return FALSE;
+}
+
+static os_ssize_t ddsi_shm_mailbox_get (ddsi_shm_conn_t sc, unsigned char * buf, os_size_t len, nn_locator_t *srcloc)
+{
+  struct ddsi_shm_mailbox *mb = sc->m_mbox;
+  const struct ddsi_shm_geometry *geom = &sc->m_geom;
+  os_uint32 k;
+
+  /* Round-robin over the rings to be fair to all senders */
+  for (k = 0; k < geom->m_nrings; k++)
+  {
+    const os_uint32 ri = (sc->m_next_ring + k) % geom->m_nrings;
+    struct ddsi_shm_ring *r = &mb->m_rings[ri];
+    const os_uint32 tail = pa_ld32 (&r->m_tail);
+    if (pa_ld32 (&r->m_head) != tail)
+    {
+      const struct ddsi_shm_slot *slot;
+      os_uint32 srcpid, srcport;
+      os_size_t n;
+      pa_fence_acq ();
+      slot = ddsi_shm_slot (mb, geom, ri, tail);
+      /* Read each header field once: the sender may still change them */
+      n = *(volatile const os_uint32 *) &slot->m_len;
+      srcpid = *(volatile const os_uint32 *) &slot->m_srcpid;
+      srcport = *(volatile const os_uint32 *) &slot->m_srcport;
+      if (n > ddsi_shm_payload_size (geom))
+      {
+        NN_WARNING3 ("shm: message from process %u dropped, length %u exceeds slot size %u\n",
+                     srcpid, (unsigned) n, ddsi_shm_payload_size (geom));
+        n = 0;
+      }
+      else if (n > len)
+      {
+        NN_WARNING3 ("shm: message from process %u of %u bytes truncated to %u\n", srcpid, (unsigned) n, (unsigned) len);
+        n = len;
+      }
+      memcpy (buf, slot + 1, n);
+      if (srcloc)
+        ddsi_shm_loc_set (srcloc, ddsi_shm_config_g.m_hostid, srcpid, srcport);
+      pa_fence_rel ();
+      pa_st32 (&r->m_tail, tail + 1);
+      sc->m_next_ring = (ri + 1) % geom->m_nrings;
+      if (n > 0)
+        return (os_ssize_t) n;
+    }
+  }
+  return -1;
+}
+
+static os_ssize_t ddsi_shm_conn_read (ddsi_tran_conn_t conn, unsigned char * buf, os_size_t len, nn_locator_t *srcloc)
+{
+  ddsi_shm_conn_t sc = (ddsi_shm_conn_t) conn;
+  os_ssize_t ret;
+  char dummy[16];
+
+  if ((ret = ddsi_shm_mailbox_get (sc, buf, len, srcloc)) > 0)
+    return ret;
+
+  /* Nothing there: consume pending wakeups, then ask senders for a new
+     one before checking again, so that a message published in between
+     is either seen now or causes a wakeup */
+  while (recv (sc->m_sock, dummy, sizeof (dummy), MSG_DONTWAIT) > 0)
+    ;
+  pa_st32 (&sc->m_mbox->m_waiting, 1);
+  pa_fence ();
+  return ddsi_shm_mailbox_get (sc, buf, len, srcloc);
+}
+
+static c_bool ddsi_shm_conn_pending (ddsi_tran_conn_t conn)
+{
+  ddsi_shm_conn_t sc = (ddsi_shm_conn_t) conn;
+  return ddsi_shm_mailbox_nonempty (sc->m_mbox, &sc->m_geom);
+}
+
+static os_handle ddsi_shm_conn_handle (ddsi_tran_base_t base)
+{
+  return ((ddsi_shm_conn_t) base)->m_sock;
+}
+
+static int ddsi_shm_conn_locator (ddsi_tran_base_t base, nn_locator_t *loc)
+{
+  ddsi_shm_conn_t sc = (ddsi_shm_conn_t) base;
+  ddsi_shm_loc_set (loc, ddsi_shm_config_g.m_hostid, ddsi_shm_config_g.m_pid, sc->m_base.m_base.m_port);
+  return 0;
+}
+
+static ddsi_tran_conn_t ddsi_shm_create_conn (os_uint32 port, ddsi_tran_qos_t qos)
+{
+  const os_uint32 slot_size = (os_uint32) ((sizeof (struct ddsi_shm_slot) + config.max_msg_size + 7) & ~(os_uint32) 7);
+  const size_t size = ddsi_shm_mailbox_size (DDSI_SHM_RING_SLOTS, slot_size);
+  c_bool mcast = (c_bool) (qos ? qos->m_multicast : FALSE);
+  struct ddsi_shm_mailbox *mb;
+  struct sockaddr_un addr;
+  socklen_t addrlen;
+  ddsi_shm_conn_t sc;
+  os_socket sock;
+  void *base;
+  char name[64];
+  int fd;
+
+  if (port == 0 || port > 65535)
+  {
+    NN_ERROR2 ("ddsi_shm_create_conn %s port %u - dynamic ports not supported\n", mcast ? "multicast" : "unicast", port);
+    return NULL;
+  }
+
+  /* Wakeup socket first: binding fails if another live conn of this
+     process already uses the port */
+  ddsi_shm_mailbox_name (name, sizeof (name), ddsi_shm_config_g.m_pid, port);
+  if ((sock = socket (AF_UNIX, SOCK_DGRAM, 0)) == -1)
+  {
+    NN_ERROR2 ("ddsi_shm_create_conn port %u socket failed ... errno = %d\n", port, os_getErrno ());
+    return NULL;
+  }
+  addrlen = ddsi_shm_wakeup_addr (&addr, name);
+  if (bind (sock, (struct sockaddr *) &addr, addrlen) == -1)
+  {
+    NN_ERROR2 ("ddsi_shm_create_conn port %u bind failed ... errno = %d\n", port, os_getErrno ());
+    close (sock);
+    return NULL;
+  }
+
+  /* A segment with this name can only be a leftover of a crashed process
+     that had the same pid */
+  (void) shm_unlink (name);
+  if ((fd = shm_open (name, O_RDWR | O_CREAT | O_EXCL, DDSI_SHM_MODE)) == -1)
+  {
+    NN_ERROR2 ("ddsi_shm_create_conn shm_open %s failed ... errno = %d\n", name, os_getErrno ());
+    close (sock);
+    return NULL;
+  }
+  if (ftruncate (fd, (off_t) size) == -1 ||
+      (base = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+  {
+    NN_ERROR2 ("ddsi_shm_create_conn mapping %s failed ... errno = %d\n", name, os_getErrno ());
+    close (fd);
+    shm_unlink (name);
+    close (sock);
+    return NULL;
+  }
+  close (fd);
+
+  mb = base;
+  mb->m_owner = ddsi_shm_config_g.m_pid;
+  mb->m_nrings = DDSI_SHM_MAX_PROCESSES;
+  mb->m_nslots = DDSI_SHM_RING_SLOTS;
+  mb->m_slot_size = slot_size;
+  pa_st32 (&mb->m_waiting, 1);
+  pa_fence_rel ();
+  pa_st32 (&mb->m_magic, DDSI_SHM_MAGIC);
+
+  sc = (ddsi_shm_conn_t) os_malloc (sizeof (*sc));
+  memset (sc, 0, sizeof (*sc));
+  sc->m_sock = sock;
+  sc->m_mbox = mb;
+  sc->m_size = size;
+  sc->m_geom.m_nrings = DDSI_SHM_MAX_PROCESSES;
+  sc->m_geom.m_nslots = DDSI_SHM_RING_SLOTS;
+  sc->m_geom.m_slot_size = slot_size;
+  os_strncpy (sc->m_name, name, sizeof (sc->m_name));
+  ddsi_factory_conn_init (&ddsi_shm_factory_g, &sc->m_base);
+  sc->m_base.m_base.m_port = port;
+  sc->m_base.m_base.m_trantype = DDSI_TRAN_CONN;
+  sc->m_base.m_base.m_multicast = mcast;
+  sc->m_base.m_base.m_handle_fn = ddsi_shm_conn_handle;
+  sc->m_base.m_base.m_locator_fn = ddsi_shm_conn_locator;
+  sc->m_base.m_read_fn = ddsi_shm_conn_read;
+  sc->m_base.m_write_fn = ddsi_shm_conn_write;
+  sc->m_base.m_pending_fn = ddsi_shm_conn_pending;
+
+  nn_log (LC_INFO, "ddsi_shm_create_conn %s mailbox %s (%u bytes) port %u\n", mcast ? "multicast" : "unicast", name, (unsigned) size, port);
+  return &sc->m_base;
+}
+
+static void ddsi_shm_release_conn (ddsi_tran_conn_t conn)
+{
+  ddsi_shm_conn_t sc = (ddsi_shm_conn_t) conn;
+  nn_log
+  (
+    LC_INFO,
+    "ddsi_shm_release_conn %s mailbox %s port %d\n",
+    conn->m_base.m_multicast ? "multicast" : "unicast",
+    sc->m_name,
+    sc->m_base.m_base.m_port
+  );
+  /* Senders drop their mapping once they see the magic has gone */
+  pa_st32 (&sc->m_mbox->m_magic, 0);
+  shm_unlink (sc->m_name);
+  munmap (sc->m_mbox, sc->m_size);
+  close (sc->m_sock);
+  os_free (conn);
+}
+
+static int ddsi_shm_join_mc (ddsi_tran_conn_t conn, const nn_locator_t *srcloc, const nn_locator_t *mcloc, const struct nn_interface *interf)
+{
+  /* Every mailbox receives the "multicasts" for its port */
+  (void) conn; (void) srcloc; (void) mcloc; (void) interf;
+  return 0;
+}
+
+static int ddsi_shm_leave_mc (ddsi_tran_conn_t conn, const nn_locator_t *srcloc, const nn_locator_t *mcloc, const struct nn_interface *interf)
+{
+  (void) conn; (void) srcloc; (void) mcloc; (void) interf;
+  return 0;
+}
+
+static void ddsi_shm_deinit (void)
+{
+  if (pa_dec32_nv (&init_g) == 0)
+  {
+    ddsi_shm_config_t cfg = &ddsi_shm_config_g;
+    while (cfg->m_npeers > 0)
+      ddsi_shm_peer_detach (&cfg->m_peers[0]);
+    os_free (cfg->m_peers);
+    (void) pa_cas32 (&cfg->m_registry->m_pid[cfg->m_regidx], cfg->m_pid, 0);
+    munmap (cfg->m_registry, sizeof (*cfg->m_registry));
+    close (cfg->m_wakesock);
+    os_mutexDestroy (&cfg->m_lock);
+    nn_log (LC_INFO | LC_CONFIG, "shm de-initialized\n");
+  }
+}
+
+static int ddsi_shm_registry_attach (ddsi_shm_config_t cfg)
+{
+  struct stat st;
+  char name[64];
+  void *base;
+  int fd, i;
+
+  snprintf (name, sizeof (name), DDSI_SHM_REGISTRY_NAME, (unsigned) geteuid ());
+  if ((fd = shm_open (name, O_RDWR | O_CREAT, DDSI_SHM_MODE)) == -1)
+  {
+    NN_ERROR1 ("shm: opening registry failed ... errno = %d\n", os_getErrno ());
+    return -1;
+  }
+  /* The registry decides into which mailboxes we write, so one that
+     someone else could have planted or can modify is refused */
+  if (fstat (fd, &st) == -1 || st.st_uid != geteuid () || (st.st_mode & 077) != 0)
+  {
+    NN_ERROR1 ("shm: registry %s is not private to this user\n", name);
+    close (fd);
+    return -1;
+  }
+  /* Growing a fresh (zero-length) segment is idempotent, it is zero-filled */
+  if ((size_t) st.st_size < sizeof (*cfg->m_registry) && ftruncate (fd, (off_t) sizeof (*cfg->m_registry)) == -1)
+  {
+    NN_ERROR1 ("shm: sizing registry failed ... errno = %d\n", os_getErrno ());
+    close (fd);
+    return -1;
+  }
+  base = mmap (NULL, sizeof (*cfg->m_registry), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (base == MAP_FAILED)
+  {
+    NN_ERROR1 ("shm: mapping registry failed ... errno = %d\n", os_getErrno ());
+    return -1;
+  }
+  cfg->m_registry = base;
+
+  for (i = 0; i < DDSI_SHM_MAX_PROCESSES; i++)
+  {
+    os_uint32 owner = pa_ld32 (&cfg->m_registry->m_pid[i]);
+    if ((owner == 0 && pa_cas32 (&cfg->m_registry->m_pid[i], 0, cfg->m_pid)) ||
+        (owner != 0 && !ddsi_shm_pid_alive (owner) && pa_cas32 (&cfg->m_registry->m_pid[i], owner, cfg->m_pid)))
+    {
+      cfg->m_regidx = i;
+      return 0;
+    }
+  }
+  NN_ERROR1 ("shm: registry full (%d processes)\n", DDSI_SHM_MAX_PROCESSES);
+  munmap (base, sizeof (*cfg->m_registry));
+  return -1;
+}
+
+int ddsi_shm_init (void)
+{
+  if (pa_inc32_nv (&init_g) == 1)
+  {
+    ddsi_shm_config_t cfg = &ddsi_shm_config_g;
+
+    memset (cfg, 0, sizeof (*cfg));
+    cfg->m_hostid = (os_uint32) gethostid ();
+    cfg->m_pid = (os_uint32) getpid ();
+    if (ddsi_shm_registry_attach (cfg) < 0)
+    {
+      pa_dec32 (&init_g);
+      return -1;
+    }
+    if ((cfg->m_wakesock = socket (AF_UNIX, SOCK_DGRAM, 0)) == -1)
+    {
+      NN_ERROR1 ("shm: wakeup socket failed ... errno = %d\n", os_getErrno ());
+      (void) pa_cas32 (&cfg->m_registry->m_pid[cfg->m_regidx], cfg->m_pid, 0);
+      munmap (cfg->m_registry, sizeof (*cfg->m_registry));
+      pa_dec32 (&init_g);
+      return -1;
+    }
+    os_mutexInit (&cfg->m_lock, NULL);
+
+    memset (&ddsi_shm_factory_g, 0, sizeof (ddsi_shm_factory_g));
+    ddsi_shm_factory_g.m_free_fn = ddsi_shm_deinit;
+    ddsi_shm_factory_g.m_kind = NN_LOCATOR_KIND_SHM;
+    ddsi_shm_factory_g.m_typename = "shm";
+    ddsi_shm_factory_g.m_default_spdp_address = "shm/all";
+    ddsi_shm_factory_g.m_connless = TRUE;
+    ddsi_shm_factory_g.m_supports_fn = ddsi_shm_supports;
+    ddsi_shm_factory_g.m_create_conn_fn = ddsi_shm_create_conn;
+    ddsi_shm_factory_g.m_release_conn_fn = ddsi_shm_release_conn;
+    ddsi_shm_factory_g.m_join_mc_fn = ddsi_shm_join_mc;
+    ddsi_shm_factory_g.m_leave_mc_fn = ddsi_shm_leave_mc;
+    ddsi_shm_factory_g.m_is_mcaddr_fn = ddsi_shm_is_mcaddr;
+    ddsi_shm_factory_g.m_is_nearby_address_fn = ddsi_shm_is_nearby_address;
+    ddsi_shm_factory_g.m_locator_from_string_fn = ddsi_shm_address_from_string;
+    ddsi_shm_factory_g.m_locator_to_string_fn = ddsi_shm_to_string;
+    ddsi_shm_factory_g.m_enumerate_interfaces_fn = ddsi_shm_enumerate_interfaces;
+    ddsi_factory_add (&ddsi_shm_factory_g);
+
+    nn_log (LC_INFO | LC_CONFIG, "shm initialized (host %x pid %u registry slot %d)\n", cfg->m_hostid, cfg->m_pid, cfg->m_regidx);
+  }
+  return 0;
+}
+
+#else
+
+int ddsi_shm_init (void)
+{
+  NN_ERROR0 ("shm transport is not supported on this platform\n");
+  return -1;
+}
+
+void ddsi_shm_own_locator (nn_locator_t *loc)
+{
+  (void) loc;
+}
+
+#endif /* defined __linux */
@@ -28,6 +28,7 @@
 #include "q_config.h"
 #include "q_log.h"
 #include "q_entity.h"
+#include "q_time.h"
 #include "os_atomics.h"
 #include "os_errno.h"
 
@@ -54,9 +55,24 @@ static struct ddsi_tran_conn ddsi_tcp_conn_client;
   is flagged as such to avoid connection attempts and for same reason, on failure,
   is not removed from cache but simply flagged as failed (may be subsequently
   replaced). Similarly server side sockets are not closed as are also used in socket
-  wait set that manages their lifecycle.
+  wait set that manages their lifecycle. Data that cannot be written without blocking
+  is held in a send queue of chunks, drained by the receive thread when the socket
+  wait set finds the socket writable (see TCP/SendQueueSize).
 */
 
+#define DDSI_TCP_CHUNK_SIZE 8192
+#define DDSI_TCP_MAX_IOV 16
+
+typedef struct ddsi_tcp_chunk
+{
+  struct ddsi_tcp_chunk * m_next;
+  os_size_t m_size;
+  os_size_t m_head;
+  os_size_t m_tail;
+  char m_data[1];
+}
+* ddsi_tcp_chunk_t;
+
 typedef struct ddsi_tcp_conn
 {
   struct ddsi_tran_conn m_base;
@@ -64,6 +80,10 @@ typedef struct ddsi_tcp_conn
   os_uint32 m_peer_port;
   os_mutex m_mutex;
   os_socket m_sock;
+  ddsi_tcp_chunk_t m_sendq_head;
+  ddsi_tcp_chunk_t m_sendq_tail;
+  os_size_t m_sendq_bytes;
+  nn_mtime_t m_sendq_progress;
 #ifdef DDSI_INCLUDE_SSL
   SSL * m_ssl;
 #endif
@@ -216,7 +236,7 @@ static void ddsi_tcp_sock_free (os_socket sock, const char * msg)
 
 static void ddsi_tcp_sock_new (os_socket * sock, unsigned short port)
 {
-  if (make_socket (sock, port, TRUE, TRUE) != 0)
+  if (make_socket (sock, port, TRUE, TRUE, FALSE) != 0)
   {
     *sock = Q_INVALID_SOCKET;
   }
@@ -564,6 +584,193 @@ static void set_msghdr_iov (struct msghdr *mhdr, ddsi_iovec_t *iov, size_t iovle
 }
 OSPL_DIAG_ON(conversion)
 
+static c_bool ddsi_tcp_sendq_enabled (void)
+{
+#ifdef WINCE
+  /* WinCE socket wait set does not wait for writability */
+  return FALSE;
+#else
+#ifdef DDSI_INCLUDE_SSL
+  if (config.ssl_enable || ddsi_tcp_ssl_plugin.write)
+  {
+    return FALSE;
+  }
+#endif
+  return (config.tcp_sendq_size > 0);
+#endif
+}
+
+static void ddsi_tcp_sendq_append (ddsi_tcp_conn_t conn, const char * buf, os_size_t len)
+{
+  /* Small messages are coalesced in the last chunk, larger ones get a chunk
+     of their own */
+
+  ddsi_tcp_chunk_t chunk = conn->m_sendq_tail;
+
+  if (chunk == NULL || chunk->m_size - chunk->m_tail < len)
+  {
+    os_size_t size = (len > DDSI_TCP_CHUNK_SIZE) ? len : DDSI_TCP_CHUNK_SIZE;
+    chunk = os_malloc (offsetof (struct ddsi_tcp_chunk, m_data) + size);
+    chunk->m_next = NULL;
+    chunk->m_size = size;
+    chunk->m_head = 0;
+    chunk->m_tail = 0;
+    if (conn->m_sendq_tail)
+    {
+      conn->m_sendq_tail->m_next = chunk;
+    }
+    else
+    {
+      conn->m_sendq_head = chunk;
+    }
+    conn->m_sendq_tail = chunk;
+  }
+  memcpy (chunk->m_data + chunk->m_tail, buf, len);
+  chunk->m_tail += len;
+  conn->m_sendq_bytes += len;
+}
+
+static void ddsi_tcp_sendq_clear (ddsi_tcp_conn_t conn)
+{
+  ddsi_tcp_chunk_t chunk;
+  while ((chunk = conn->m_sendq_head) != NULL)
+  {
+    conn->m_sendq_head = chunk->m_next;
+    os_free (chunk);
+  }
+  conn->m_sendq_tail = NULL;
+  conn->m_sendq_bytes = 0;
+}
+
+static void ddsi_tcp_sendq_enqueue (ddsi_tcp_conn_t conn, const struct msghdr * msg, os_size_t sent)
+{
+  /* Queue all of msg beyond the first sent bytes, waking the socket wait set
+     if the queue was empty so that it starts watching for writability */
+
+  c_bool was_empty = (conn->m_sendq_bytes == 0);
+  int i;
+
+  for (i = 0; i < (int) msg->msg_iovlen; i++)
+  {
+    os_size_t len = msg->msg_iov[i].iov_len;
+    if (sent >= len)
+    {
+      sent -= len;
+    }
+    else
+    {
+      ddsi_tcp_sendq_append (conn, (const char *) msg->msg_iov[i].iov_base + sent, len - sent);
+      sent = 0;
+    }
+  }
+  if (was_empty && conn->m_sendq_bytes > 0)
+  {
+    conn->m_sendq_progress = now_mt ();
+    os_sockWaitsetTrigger (gv.waitset);
+  }
+}
+
+static os_ssize_t ddsi_tcp_sendq_send (ddsi_tcp_conn_t conn, int * err)
+{
+  /* Write as much of the queue as the socket accepts in a single call,
+     returns the number of bytes written or -1 with *err set */
+
+  ddsi_iovec_t iov[DDSI_TCP_MAX_IOV];
+  ddsi_tcp_chunk_t chunk;
+  struct msghdr msg;
+  os_size_t n = 0;
+  os_ssize_t ret;
+  int sendflags = 0;
+
+#ifdef MSG_NOSIGNAL
+  sendflags |= MSG_NOSIGNAL;
+#endif
+
+  for (chunk = conn->m_sendq_head; chunk && n < DDSI_TCP_MAX_IOV; chunk = chunk->m_next)
+  {
+    iov[n].iov_base = chunk->m_data + chunk->m_head;
+    iov[n].iov_len = chunk->m_tail - chunk->m_head;
+    n++;
+  }
+  memset (&msg, 0, sizeof (msg));
+  set_msghdr_iov (&msg, iov, n);
+  do
+  {
+    ret = sendmsg (conn->m_sock, &msg, sendflags);
+    *err = (ret == -1) ? os_getErrno () : 0;
+  }
+  while ((ret == -1) && (*err == os_sockEINTR));
+
+  if (ret > 0)
+  {
+    os_size_t pos = (os_size_t) ret;
+    conn->m_sendq_bytes -= pos;
+    conn->m_sendq_progress = now_mt ();
+    while (pos > 0)
+    {
+      chunk = conn->m_sendq_head;
+      if (pos < chunk->m_tail - chunk->m_head)
+      {
+        chunk->m_head += pos;
+        break;
+      }
+      pos -= chunk->m_tail - chunk->m_head;
+      conn->m_sendq_head = chunk->m_next;
+      os_free (chunk);
+    }
+    if (conn->m_sendq_head == NULL)
+    {
+      conn->m_sendq_tail = NULL;
+    }
+  }
+  return ret;
+}
+
+static c_bool ddsi_tcp_conn_write_pending (ddsi_tran_conn_t base)
+{
+  ddsi_tcp_conn_t conn = (ddsi_tcp_conn_t) base;
+  c_bool pending;
+
+  os_mutexLock (&conn->m_mutex);
+  pending = (conn->m_sendq_bytes > 0);
+  os_mutexUnlock (&conn->m_mutex);
+  return pending;
+}
+
+static void ddsi_tcp_conn_flush (ddsi_tran_conn_t base)
+{
+  ddsi_tcp_conn_t conn = (ddsi_tcp_conn_t) base;
+  c_bool failed = FALSE;
+  os_ssize_t ret;
+  int err = 0;
+
+  os_mutexLock (&conn->m_mutex);
+  while (conn->m_sendq_bytes > 0)
+  {
+    ret = ddsi_tcp_sendq_send (conn, &err);
+    if (ret == -1)
+    {
+      if (err != os_sockEAGAIN && err != os_sockEWOULDBLOCK)
+      {
+        TRACE_TCP (("%s flush: sock %d error %d\n", ddsi_name, (int) conn->m_sock, err));
+        ddsi_tcp_sendq_clear (conn);
+        failed = TRUE;
+      }
+      break;
+    }
+    else if (ret == 0)
+    {
+      break;
+    }
+  }
+  os_mutexUnlock (&conn->m_mutex);
+
+  if (failed)
+  {
+    ddsi_tcp_cache_remove (conn);
+  }
+}
+
 static os_ssize_t ddsi_tcp_conn_write (ddsi_tran_conn_t base, const nn_locator_t *dst, size_t niov, const ddsi_iovec_t *iov, os_uint32 flags)
 {
 #ifdef DDSI_INCLUDE_SSL
@@ -617,6 +824,42 @@ static os_ssize_t ddsi_tcp_conn_write (ddsi_tran_conn_t base, const nn_locator_t
     return (os_ssize_t) len;
   }
 
+  /* With a backlog queued, new messages go behind it to keep the byte stream
+     in order; the queue is drained from the socket wait set. A message that
+     does not fit is dropped, unless the queue has stalled for longer than the
+     write timeout, in which case the connection is abandoned */
+
+  if (conn->m_sendq_bytes > 0)
+  {
+    if (conn->m_sendq_bytes < config.tcp_sendq_size)
+    {
+      ddsi_tcp_sendq_enqueue (conn, &msg, 0);
+      ret = (os_ssize_t) len;
+    }
+    else if (now_mt ().v - conn->m_sendq_progress.v < config.tcp_write_timeout)
+    {
+      TRACE_TCP (("%s write: sock %d queue full, message dropped\n", ddsi_name, (int) conn->m_sock));
+      os_mutexUnlock (&conn->m_mutex);
+      return -1;
+    }
+    else
+    {
+      nn_log
+      (
+        LC_WARNING, "%s abandoning write on socket %d with %"PA_PRIuSIZE" bytes queued\n",
+        ddsi_name, (int) conn->m_sock, conn->m_sendq_bytes
+      );
+      ddsi_tcp_sendq_clear (conn);
+      ret = -1;
+    }
+    os_mutexUnlock (&conn->m_mutex);
+    if (ret == -1)
+    {
+      ddsi_tcp_cache_remove (conn);
+    }
+    return ret;
+  }
+
 #ifdef DDSI_INCLUDE_SSL
   if (config.ssl_enable)
   {
@@ -695,6 +938,15 @@ static os_ssize_t ddsi_tcp_conn_write (ddsi_tran_conn_t base, const nn_locator_t
     }
   }
 
+  /* Rather than blocking until the socket accepts the rest, queue it */
+
+  if (piecewise && ddsi_tcp_sendq_enabled ())
+  {
+    ddsi_tcp_sendq_enqueue (conn, &msg, (os_size_t) ret);
+    piecewise = 0;
+    ret = (os_ssize_t) len;
+  }
+
   if (piecewise)
   {
     os_ssize_t (*wr) (ddsi_tcp_conn_t, const void *, os_size_t, int *) = ddsi_tcp_conn_write_plain;
@@ -882,6 +1134,8 @@ static void ddsi_tcp_base_init (struct ddsi_tran_conn * base)
   base->m_read_fn = ddsi_tcp_conn_read;
   base->m_write_fn = ddsi_tcp_conn_write;
   base->m_peer_locator_fn = ddsi_tcp_conn_peer_locator;
+  base->m_write_pending_fn = ddsi_tcp_conn_write_pending;
+  base->m_flush_fn = ddsi_tcp_conn_flush;
 }
 
 static ddsi_tcp_conn_t ddsi_tcp_new_conn (os_socket sock, c_bool server, os_sockaddr_storage * peer)
@@ -961,6 +1215,7 @@ static void ddsi_tcp_conn_delete (ddsi_tcp_conn_t conn)
   {
     ddsi_tcp_sock_free (conn->m_sock, "connection");
   }
+  ddsi_tcp_sendq_clear (conn);
   os_mutexDestroy (&conn->m_mutex);
   os_free (conn);
 }
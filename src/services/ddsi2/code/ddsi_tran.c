@@ -154,6 +154,28 @@ c_bool ddsi_conn_peer_locator (ddsi_tran_conn_t conn, nn_locator_t * loc)
   return FALSE;
 }
 
+c_bool ddsi_conn_pending (ddsi_tran_conn_t conn)
+{
+  /* Connections that buffer received data in user space (e.g. a memory
+     mapped packet ring) can be drained without waiting on the socket */
+  return (conn->m_pending_fn && ! conn->m_closed) ? (conn->m_pending_fn) (conn) : FALSE;
+}
+
+c_bool ddsi_conn_write_pending (ddsi_tran_conn_t conn)
+{
+  /* Connections that queue outbound data (e.g. TCP with a send queue) want
+     the socket waitset to watch for writability */
+  return (conn->m_write_pending_fn && ! conn->m_closed) ? (conn->m_write_pending_fn) (conn) : FALSE;
+}
+
+void ddsi_conn_flush (ddsi_tran_conn_t conn)
+{
+  if (conn->m_flush_fn && ! conn->m_closed)
+  {
+    (conn->m_flush_fn) (conn);
+  }
+}
+
 void ddsi_tran_free_qos (ddsi_tran_qos_t qos)
 {
   os_free (qos);
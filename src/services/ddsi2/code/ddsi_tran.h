@@ -58,6 +58,8 @@ typedef os_handle (*ddsi_tran_handle_fn_t) (ddsi_tran_base_t);
 typedef int (*ddsi_tran_listen_fn_t) (ddsi_tran_listener_t);
 typedef void (*ddsi_tran_free_fn_t) (void);
 typedef void (*ddsi_tran_peer_locator_fn_t) (ddsi_tran_conn_t, nn_locator_t *);
+typedef c_bool (*ddsi_tran_pending_fn_t) (ddsi_tran_conn_t);
+typedef void (*ddsi_tran_flush_fn_t) (ddsi_tran_conn_t);
 typedef ddsi_tran_conn_t (*ddsi_tran_accept_fn_t) (ddsi_tran_listener_t);
 typedef ddsi_tran_conn_t (*ddsi_tran_create_conn_fn_t) (os_uint32 , ddsi_tran_qos_t);
 typedef ddsi_tran_listener_t (*ddsi_tran_create_listener_fn_t) (int port, ddsi_tran_qos_t);
@@ -115,6 +117,9 @@ struct ddsi_tran_conn
   ddsi_tran_read_fn_t m_read_fn;
   ddsi_tran_write_fn_t m_write_fn;
   ddsi_tran_peer_locator_fn_t m_peer_locator_fn;
+  ddsi_tran_pending_fn_t m_pending_fn;
+  ddsi_tran_pending_fn_t m_write_pending_fn;
+  ddsi_tran_flush_fn_t m_flush_fn;
 
   /* Data */
 
@@ -185,6 +190,7 @@ struct ddsi_tran_qos
   /* QoS Data */
 
   c_bool m_multicast;
+  c_bool m_reuseport;
   int m_diffserv;
 };
 
@@ -220,6 +226,9 @@ void ddsi_factory_conn_init (ddsi_tran_factory_t factory, ddsi_tran_conn_t conn)
 OS_API os_ssize_t ddsi_conn_write (ddsi_tran_conn_t conn, const nn_locator_t *dst, size_t niov, const ddsi_iovec_t *iov, os_uint32 flags);
 os_ssize_t ddsi_conn_read (ddsi_tran_conn_t conn, unsigned char * buf, os_size_t len, nn_locator_t *srcloc);
 c_bool ddsi_conn_peer_locator (ddsi_tran_conn_t conn, nn_locator_t * loc);
+c_bool ddsi_conn_pending (ddsi_tran_conn_t conn);
+c_bool ddsi_conn_write_pending (ddsi_tran_conn_t conn);
+void ddsi_conn_flush (ddsi_tran_conn_t conn);
 void ddsi_conn_add_ref (ddsi_tran_conn_t conn);
 void ddsi_conn_free (ddsi_tran_conn_t conn);
 
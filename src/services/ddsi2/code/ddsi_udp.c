@@ -236,6 +236,7 @@ static ddsi_tran_conn_t ddsi_udp_create_conn
   os_socket sock;
   ddsi_udp_conn_t uc = NULL;
   c_bool mcast = (c_bool) (qos ? qos->m_multicast : FALSE);
+  c_bool reuseport = (c_bool) (qos ? qos->m_reuseport : FALSE);
 
   /* If port is zero, need to create dynamic port */
 
@@ -244,7 +245,8 @@ static ddsi_tran_conn_t ddsi_udp_create_conn
     &sock,
     (unsigned short) port,
     FALSE,
-    mcast
+    mcast,
+    reuseport
   );
 
   if (ret == 0)
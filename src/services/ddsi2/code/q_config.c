@@ -158,6 +158,8 @@ DU (uf_besmode);
 DU (uf_retransmit_merging);
 DU (uf_sched_prio_class);
 DU (uf_sched_class);
+DU (uf_cpu_affinity);
+DU (uf_memory_policy);
 DU (uf_maybe_memsize);
 DU (uf_maybe_int32);
 DU (uf_domainId);
@@ -260,7 +262,7 @@ static const struct cfgelem general_cfgelems[] = {
   { LEAF ("UseIPv6"), 1, "default", ABSOFF (compat_use_ipv6), 0, uf_boolean_default, 0, pf_nop,
     "<p>Deprecated (use Transport instead)</p>" },
   { LEAF ("Transport"), 1, "default", ABSOFF (transport_selector), 0, uf_transport_selector, 0, pf_transport_selector,
-    "<p>This element allows selecting the transport to be used (udp, udp6, tcp, tcp6, raweth)</p>" },
+    "<p>This element allows selecting the transport to be used (udp, udp6, tcp, tcp6, raweth, shm). The shm transport exchanges messages through shared memory and only reaches DDSI2 services on the same host (Linux only).</p>" },
   { LEAF ("EnableMulticastLoopback"), 1, "true", ABSOFF (enableMulticastLoopback), 0, uf_boolean, 0, pf_boolean,
     "<p>This element specifies whether DDSI2 allows IP multicast packets to be visible to all DDSI participants in the same node, including itself. It must be \"true\" for intra-node multicast communications, but if a node runs only a single DDSI2 service and does not host any other DDSI-capable programs, it should be set to \"false\" for improved performance.</p>" },
   { LEAF ("CoexistWithNativeNetworking"), 1, "false", ABSOFF (coexistWithNativeNetworking), 0, uf_boolean, 0, pf_boolean,
@@ -305,6 +307,10 @@ static const struct cfgelem thread_properties_cfgattrs[] = {
 };
 
 static const struct cfgelem thread_properties_cfgelems[] = {
+  { LEAF ("Affinity"), 1, "any", RELOFF (config_thread_properties_listelem, cpu_affinity), 0, uf_cpu_affinity, ff_free, pf_string,
+    "<p>This element specifies the CPUs this thread may run on, as a comma-separated list of CPU numbers and ranges of CPU numbers, e.g. <i>0-3,8</i>. The default value <i>any</i> leaves the thread free to run on any CPU. On multi-socket machines, keeping the receive and delivery threads on the CPUs of the NUMA node that owns the network interface avoids cross-node cache misses on the receive path.</p>" },
+  { LEAF ("MemoryPolicy"), 1, "default", RELOFF (config_thread_properties_listelem, memory_policy), 0, uf_memory_policy, ff_free, pf_string,
+    "<p>This element specifies the NUMA memory allocation policy of this thread: <i>default</i> keeps the policy of the process, <i>local</i> allocates on the node the thread is running on, and <i>bind:NODES</i>, <i>preferred:NODES</i> and <i>interleave:NODES</i> respectively restrict allocation to, prefer, or interleave allocations over the nodes in NODES, a list in the same format as Affinity. The receive buffers of a receive thread are allocated by that thread and follow its policy. This setting is ignored on platforms without NUMA support.</p>" },
   { GROUP ("Scheduling", thread_properties_sched_cfgelems),
     "<p>This element configures the scheduling properties of the thread.</p>" },
   { LEAF ("StackSize"), 1, "default", RELOFF (config_thread_properties_listelem, stack_size), 0, uf_maybe_memsize, 0, pf_maybe_memsize,
@@ -362,6 +368,18 @@ static const struct cfgelem unsupp_watermarks_cfgelems[] = {
   END_MARKER
 };
 
+static const struct cfgelem unsupp_packet_ring_cfgelems[] = {
+  { LEAF ("Enable"), 1, "false", ABSOFF (raweth_ring_enable), 0, uf_boolean, 0, pf_boolean,
+    "<p>This element enables memory mapped receive rings (PACKET_MMAP) on the sockets of the raw ethernet transport. Received frames are then collected in blocks that are processed without a system call per frame. Transmission is not affected. If the ring cannot be set up, the transport silently reverts to a system call per frame.</p>" },
+  { LEAF ("BlockSize"), 1, "128 KiB", ABSOFF (raweth_ring_block_size), 0, uf_memsize, 0, pf_memsize,
+    "<p>This element sets the size of a single block in the packet ring. It must be a power-of-two multiple of the page size.</p>" },
+  { LEAF ("Blocks"), 1, "16", ABSOFF (raweth_ring_blocks), 0, uf_uint32, 0, pf_uint32,
+    "<p>This element sets the number of blocks in the packet ring.</p>" },
+  { LEAF ("BlockTimeout"), 1, "1 ms", ABSOFF (raweth_ring_block_timeout), 0, uf_duration_ms_1hr, 0, pf_duration,
+    "<p>This element sets the maximum time the kernel holds on to a partially filled receive block before handing it to DDSI2. It bounds the added latency at low data rates.</p>" },
+  END_MARKER
+};
+
 static const struct cfgelem control_topic_cfgattrs[] = {
   { ATTR ("enable"), 1, "false", ABSOFF (enable_control_topic), 0, uf_boolean, 0, pf_boolean,
     "<p>This attribute controls whether the DDSI2 control topic is defined and acted upon by DDSI2</p>" },
@@ -384,7 +402,9 @@ static const struct cfgelem unsupp_cfgelems[] = {
   { MOVED ("MaxMessageSize", "General/MaxMessageSize") },
   { MOVED ("FragmentSize", "General/FragmentSize") },
   { LEAF ("DeliveryQueueMaxSamples"), 1, "256", ABSOFF (delivery_queue_maxsamples), 0, uf_uint, 0, pf_uint,
-    "<p>This element controls the Maximum size of a delivery queue, expressed in samples. Once a delivery queue is full, incoming samples destined for that queue are dropped until space becomes available again.</p>" },
+    "<p>This element controls the Maximum size of a delivery queue, expressed in samples. Once a delivery queue is full, incoming samples destined for that queue are dropped until space becomes available again.</p><p>While the kernel is short of shared memory, a delivery queue with reliable data it cannot deliver is paused and reports itself as full. This affects all proxy writers delivering through that queue, not only the one whose sample is waiting, but as the shortage is node-wide, their samples could not be delivered either. Reliable samples rejected meanwhile are retransmitted once delivery resumes.</p>" },
+  { LEAF ("DeliveryQueueSpinTime"), 1, "0 s", ABSOFF (delivery_queue_spin_time), 0, uf_duration_us_1s, 0, pf_duration,
+    "<p>This element specifies how long a delivery thread polls its empty queue before blocking. Spinning saves the wake-up latency of a blocked thread when samples arrive in quick succession, at the cost of CPU time. The default of 0 disables spinning.</p>" },
   { LEAF ("PrimaryReorderMaxSamples"), 1, "64", ABSOFF (primary_reorder_maxsamples), 0, uf_uint, 0, pf_uint,
     "<p>This element sets the maximum size in samples of a primary re-order administration. Each proxy writer has one primary re-order administration to buffer the packet flow in case some packets arrive out of order. Old samples are forwarded to secondary re-order administrations associated with readers in need of historical data.</p>" },
   { LEAF ("SecondaryReorderMaxSamples"), 1, "16", ABSOFF (secondary_reorder_maxsamples), 0, uf_uint, 0, pf_uint,
@@ -415,6 +435,8 @@ static const struct cfgelem unsupp_cfgelems[] = {
     "<p>This element controls whether samples sent by a writer with QoS settings latency_budget <= SynchronousDeliveryLatencyBound and transport_priority greater than or equal to this element's value will be delivered synchronously from the \"recv\" thread, all others will be delivered asynchronously through delivery queues. This reduces latency at the expense of aggregate bandwidth.</p>" },
   { LEAF ("SynchronousDeliveryLatencyBound"), 1, "inf", ABSOFF (synchronous_delivery_latency_bound), 0, uf_duration_inf, 0, pf_duration,
     "<p>This element controls whether samples sent by a writer with QoS settings transport_priority >= SynchronousDeliveryPriorityThreshold and a latency_budget at most this element's value will be delivered synchronously from the \"recv\" thread, all others will be delivered asynchronously through delivery queues. This reduces latency at the expense of aggregate bandwidth.</p>" },
+  { LEAF ("ReceiveThreads"), 1, "1", ABSOFF (recv_threads), 0, uf_uint, 0, pf_uint,
+    "<p>This element sets the number of threads receiving data. The first one, named \"recv\", handles the discovery, multicast and participant-specific sockets; each additional thread, named \"recv.1\", \"recv.2\", etc., reads from its own unicast data socket bound to the same port using SO_REUSEPORT, so that the kernel distributes incoming traffic over the threads by sender. Each thread has its own receive buffer pool of Sizing/ReceiveBufferSize. Additional threads are only supported for UDP on platforms providing SO_REUSEPORT; otherwise a warning is logged and a single thread is used. The default is 1.</p>" },
   { LEAF ("MaxParticipants"), 1, "0", ABSOFF (max_participants), 0, uf_natint, 0, pf_int,
     "<p>This elements configures the maximum number of DCPS domain participants this DDSI2 instance is willing to service. 0 is unlimited.</p>" },
   { LEAF ("AccelerateRexmitBlockSize"), 1, "0", ABSOFF (accelerate_rexmit_block_size), 0, uf_uint, 0, pf_uint,
@@ -453,6 +475,8 @@ static const struct cfgelem unsupp_cfgelems[] = {
     "<p>This setting controls the delay between the discovering a remote writer and sending a pre-emptive AckNack to discover the range of data available.</p>" },
   { LEAF ("ScheduleTimeRounding"), 1, "0 ms", ABSOFF (schedule_time_rounding), 0, uf_duration_ms_1hr, 0, pf_duration,
     "<p>This setting allows the timing of scheduled events to be rounded up so that more events can be handled in a single cycle of the event queue. The default is 0 and causes no rounding at all, i.e. are scheduled exactly, whereas a value of 10ms would mean that events are rounded up to the nearest 10 milliseconds.</p>" },
+  { LEAF ("ControlCoalescingDelay"), 1, "1 ms", ABSOFF (control_coalescing_delay), 0, uf_duration_ms_1s, 0, pf_duration,
+    "<p>This setting controls the coalescing of HEARTBEAT and ACKNACK messages. The times at which these are scheduled are rounded up to a multiple of this delay, so that those of all writers and readers falling due in the same interval are handled in a single cycle of the event queue, and the messages for the same destination are combined into a single packet. It is therefore also the maximum additional delay of these messages. The default is 1ms; 0 disables coalescing.</p>" },
   { LEAF ("DDSI2DirectMaxThreads"), 1, "1", ABSOFF (ddsi2direct_max_threads), 0, uf_uint, 0, pf_uint,
     "<p>This element sets the maximum number of extra threads for an experimental, undocumented and unsupported direct mode.</p>" },
   { LEAF ("SquashParticipants"), 1, "false", ABSOFF (squash_participants), 0, uf_boolean, 0, pf_boolean,
@@ -491,6 +515,8 @@ static const struct cfgelem unsupp_cfgelems[] = {
     "<p>Testing options.</p>" },
   { GROUP ("Watermarks", unsupp_watermarks_cfgelems),
     "<p>Watermarks for flow-control.</p>" },
+  { GROUP ("PacketRing", unsupp_packet_ring_cfgelems),
+    "<p>Memory mapped packet receive rings for the raw ethernet transport (Linux only).</p>" },
   END_MARKER
 };
 
@@ -538,6 +564,8 @@ static const struct cfgelem tcp_cfgelems[] = {
     "<p>This element specifies the timeout for blocking TCP read operations. If this timeout expires then the connection is closed.</p>" },
   { LEAF ("WriteTimeout"), 1, "2 s", ABSOFF (tcp_write_timeout), 0, uf_duration_ms_1hr, 0, pf_duration,
     "<p>This element specifies the timeout for blocking TCP write operations. If this timeout expires then the connection is closed.</p>" },
+  { LEAF ("SendQueueSize"), 1, "1 MiB", ABSOFF (tcp_sendq_size), 0, uf_memsize, 0, pf_memsize,
+    "<p>This element specifies the maximum number of bytes queued for transmission on a single TCP connection when its socket buffer is full. Queued data is written by the receive thread once the socket becomes writable, in batches of several messages, so that a slow peer does not block transmission to others. Messages offered when the queue is full are dropped, and the connection is closed if the queue has not drained within the WriteTimeout. A value of 0 restores blocking writes.</p>" },
   END_MARKER
 };
 
@@ -1492,6 +1520,28 @@ static int uf_sched_class (struct cfgst *cfgst, void *parent, struct cfgelem con
   return 1;
 }
 
+static int uf_cpu_affinity (struct cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, UNUSED_ARG (int first), const char *value)
+{
+  char **elem = cfg_address (cfgst, parent, cfgelem);
+  os_threadAttr tattr;
+  os_threadAttrInit (&tattr);
+  if (os_threadAttrSetCpuAffinity (&tattr, value) != os_resultSuccess)
+    return cfg_error (cfgst, "'%s': invalid CPU list", value);
+  *elem = os_strdup (value);
+  return 1;
+}
+
+static int uf_memory_policy (struct cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, UNUSED_ARG (int first), const char *value)
+{
+  char **elem = cfg_address (cfgst, parent, cfgelem);
+  os_threadAttr tattr;
+  os_threadAttrInit (&tattr);
+  if (os_threadAttrSetMemPolicy (&tattr, value) != os_resultSuccess)
+    return cfg_error (cfgst, "'%s': invalid memory policy", value);
+  *elem = os_strdup (value);
+  return 1;
+}
+
 static void pf_sched_class (struct cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, int is_default)
 {
   os_schedClass *p = cfg_address (cfgst, parent, cfgelem);
@@ -1706,9 +1756,9 @@ static int uf_natint_255 (struct cfgst *cfgst, void *parent, struct cfgelem cons
 
 static int uf_transport_selector (struct cfgst *cfgst, void *parent, struct cfgelem const * const cfgelem, UNUSED_ARG (int first), const char *value)
 {
-  static const char *vs[] = { "default", "udp", "udp6", "tcp", "tcp6", "raweth", NULL };
+  static const char *vs[] = { "default", "udp", "udp6", "tcp", "tcp6", "raweth", "shm", NULL };
   static const enum transport_selector ms[] = {
-    TRANS_DEFAULT, TRANS_UDP, TRANS_UDP6, TRANS_TCP, TRANS_TCP6, TRANS_RAWETH, 0,
+    TRANS_DEFAULT, TRANS_UDP, TRANS_UDP6, TRANS_TCP, TRANS_TCP6, TRANS_RAWETH, TRANS_SHM, 0,
   };
   enum transport_selector *elem = cfg_address (cfgst, parent, cfgelem);
   int idx = list_index (vs, value);
@@ -1731,6 +1781,7 @@ static void pf_transport_selector (struct cfgst *cfgst, void *parent, struct cfg
     case TRANS_TCP: str = "tcp"; break;
     case TRANS_TCP6: str = "tcp6"; break;
     case TRANS_RAWETH: str = "raweth"; break;
+    case TRANS_SHM: str = "shm"; break;
   }
   cfg_log (cfgst, "%s%s", str, is_default ? " [def]" : "");
 }
@@ -2613,6 +2664,7 @@ struct cfgst * config_init
         ok1 = !(cfgst->cfg->compat_tcp_enable == BOOLDEF_TRUE || cfgst->cfg->compat_use_ipv6 == BOOLDEF_FALSE);
         break;
       case TRANS_RAWETH:
+      case TRANS_SHM:
         ok1 = !(cfgst->cfg->compat_tcp_enable == BOOLDEF_TRUE || cfgst->cfg->compat_use_ipv6 == BOOLDEF_TRUE);
         break;
     }
@@ -106,6 +106,8 @@ struct config_thread_properties_listelem {
   os_schedClass sched_class;
   struct config_maybe_int32 sched_priority;
   struct config_maybe_uint32 stack_size;
+  char *cpu_affinity;
+  char *memory_policy;
 };
 
 struct config_peer_listelem
@@ -132,7 +134,8 @@ enum transport_selector {
   TRANS_UDP6,
   TRANS_TCP,
   TRANS_TCP6,
-  TRANS_RAWETH
+  TRANS_RAWETH,
+  TRANS_SHM
 };
 
 enum many_sockets_mode {
@@ -191,6 +194,7 @@ struct config
   unsigned secondary_reorder_maxsamples;
 
   unsigned delivery_queue_maxsamples;
+  os_int64 delivery_queue_spin_time;
 
   float servicelease_expiry_time;
   float servicelease_update_factor;
@@ -215,6 +219,13 @@ struct config
   int tcp_port;
   os_int64 tcp_read_timeout;
   os_int64 tcp_write_timeout;
+  os_uint32 tcp_sendq_size;
+
+  /* Raw ethernet transport configuration */
+  int raweth_ring_enable;
+  os_uint32 raweth_ring_block_size;
+  os_uint32 raweth_ring_blocks;
+  os_int64 raweth_ring_block_timeout;
 
 #ifdef DDSI_INCLUDE_SSL
 
@@ -276,9 +287,11 @@ struct config
   os_int64 nack_delay;
   os_int64 preemptive_ack_delay;
   os_int64 schedule_time_rounding;
+  os_int64 control_coalescing_delay;
   os_uint32 max_queued_rexmit_bytes;
   unsigned max_queued_rexmit_msgs;
   unsigned ddsi2direct_max_threads;
+  unsigned recv_threads;
   int late_ack_mode;
   struct config_maybe_int64 retry_on_reject_duration;
   int retry_on_reject_besteffort;
@@ -1789,7 +1789,14 @@ int builtins_dqueue_handler (const struct nn_rsample_info *sampleinfo, const str
   nn_plist_t qos;
   unsigned char *datap;
   int needs_free;
-  os_uint32 datasz = sampleinfo->size;
+  os_uint32 datasz;
+
+  if (sampleinfo == NULL)
+  {
+    /* end of a batch: nothing is held back */
+    return 0;
+  }
+  datasz = sampleinfo->size;
   needs_free = defragment (&datap, fragchain, sampleinfo->size);
 
   /* Luckily, most of the Data and DataFrag headers are the same - and
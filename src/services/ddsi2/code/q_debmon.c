@@ -324,6 +324,33 @@ static int print_proxy_participants (struct thread_state1 *self, ddsi_tran_conn_
   return x;
 }
 
+struct print_lock_profile_arg {
+  ddsi_tran_conn_t conn;
+  int count;
+};
+
+static void print_lock_profile_site (const os_mutexProfileSummary *s, void *varg)
+{
+  struct print_lock_profile_arg *arg = varg;
+  const double us = 1e3;
+  arg->count += cpf (arg->conn, "  %s contended %"PA_PRIu64" timed %"PA_PRIu64" wait avg %.1f max %.1f hold avg %.1f max %.1f\n",
+                     s->siteName ? s->siteName : "unknown", s->contended, s->sampled,
+                     s->sampled ? (double) s->waitTotal / (double) s->sampled / us : 0.0, (double) s->waitMax / us,
+                     s->sampled ? (double) s->holdTotal / (double) s->sampled / us : 0.0, (double) s->holdMax / us);
+}
+
+static int print_lock_profile (ddsi_tran_conn_t conn)
+{
+  struct print_lock_profile_arg arg;
+  os_uint32 rate;
+  if ((rate = os_mutexProfileGetRate ()) == 0)
+    return 0;
+  arg.conn = conn;
+  arg.count = cpf (conn, "lock contention (sample rate %u, times in us)\n", rate);
+  os_mutexProfileWalk (print_lock_profile_site, &arg);
+  return arg.count;
+}
+
 static void *debmon_main (void *vdm)
 {
   struct debug_monitor *dm = vdm;
@@ -339,6 +366,8 @@ static void *debmon_main (void *vdm)
       r += print_participants (dm->servts, conn);
       if (r == 0)
         r += print_proxy_participants (dm->servts, conn);
+      if (r == 0)
+        r += print_lock_profile (conn);
 
       /* Note: can only add plugins (at the tail) */
       os_mutexLock (&dm->lock);
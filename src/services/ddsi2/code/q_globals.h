@@ -53,6 +53,7 @@ extern "C" {
 struct nn_xmsgpool;
 struct serstatepool;
 struct nn_dqueue;
+struct deliver_batch;
 struct nn_reorder;
 struct nn_defrag;
 struct addrset;
@@ -63,6 +64,7 @@ struct lease;
 struct ddsi_tran_conn;
 struct ddsi_tran_listener;
 struct ddsi_tran_factory;
+struct recv_thread_arg;
 struct ut_thread_pool_s;
 
 typedef struct ospl_in_addr_node {
@@ -134,9 +136,9 @@ struct q_globals {
 
   /* Receive thread triggering: must have a socket per receive thread
      because all receive threads must be triggered, even though each
-     receive thread takes the trigger message from the socket. With one
-     trigger socket, we can only have one receive thread (which enables
-     other optimisations that we don't currently do). */
+     receive thread takes the trigger message from the socket. This is
+     the waitset of the primary receive thread, any additional ones
+     have their own in recv_threads. */
   os_sockWaitset waitset;
 
   /* In many sockets mode, the receive threads maintain a local array
@@ -207,12 +209,12 @@ struct q_globals {
   os_mutex lock;
 
 
-  /* Receive thread. (We can only has one for now, cos of the signal
-     trigger socket.) Receive buffer pool is per receive thread,
-     practical considerations led to it being a global variable
-     TEMPORARILY. */
-  struct thread_state1 *recv_ts;
-  struct nn_rbufpool *rbufpool;
+  /* Receive threads, each with its own buffer pool and waitset. The
+     first one handles all shared sockets and uses "waitset"; the
+     others each read from a unicast data socket that shares the port
+     of data_conn_uc via SO_REUSEPORT (see Internal/ReceiveThreads). */
+  unsigned n_recv_threads;
+  struct recv_thread_arg *recv_threads;
 
   /* Listener thread for connection based transports */
   struct thread_state1 *listen_ts;
@@ -266,8 +268,10 @@ struct q_globals {
   os_uint32 networkQueueId;
   struct thread_state1 *channel_reader_ts;
 
-  /* Application data gets its own delivery queue */
+  /* Application data gets its own delivery queue, the handler of
+     which batches samples in user_dqueue_batch */
   struct nn_dqueue *user_dqueue;
+  struct deliver_batch *user_dqueue_batch;
 
   /* Transmit side: pools for the serializer & transmit messages and a
      transmit queue*/
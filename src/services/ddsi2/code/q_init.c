@@ -72,6 +72,7 @@
 #include "ddsi_udp.h"
 #include "ddsi_tcp.h"
 #include "ddsi_raweth.h"
+#include "ddsi_shm.h"
 #include "ddsi_mcgroup.h"
 
 static void add_peer_addresses (struct addrset *as, const struct config_peer_listelem *list)
@@ -117,11 +118,16 @@ static int make_uc_sockets (os_uint32 * pdisc, os_uint32 * pdata, int ppid)
   gv.disc_conn_uc = ddsi_factory_create_conn (gv.m_factory, *pdisc, NULL);
   if (gv.disc_conn_uc)
   {
-    /* Check not configured to use same unicast port for data and discovery */
+    /* Check not configured to use same unicast port for data and
+       discovery; with additional receive threads the data socket must
+       be a separate one that allows sharing its port */
 
-    if (*pdata != 0 && (*pdata != *pdisc))
+    if ((*pdata != 0 && (*pdata != *pdisc)) || (*pdata == 0 && config.recv_threads > 1))
     {
-      gv.data_conn_uc = ddsi_factory_create_conn (gv.m_factory, *pdata, NULL);
+      ddsi_tran_qos_t qos = ddsi_tran_create_qos ();
+      qos->m_reuseport = (config.recv_threads > 1);
+      gv.data_conn_uc = ddsi_factory_create_conn (gv.m_factory, *pdata, qos);
+      ddsi_tran_free_qos (qos);
     }
     else
     {
@@ -380,6 +386,14 @@ static int set_ext_address_and_mask (void)
 }
 
 
+static int is_extra_recv_thread_name (const char *name)
+{
+  /* Additional receive threads are named "recv.1", "recv.2", ... */
+  unsigned idx;
+  int pos;
+  return sscanf (name, "recv.%u%n", &idx, &pos) == 1 && name[pos] == 0 && idx > 0 && idx < config.recv_threads;
+}
+
 static int check_thread_properties (void)
 {
   static const char *fixed[] = { "recv", "tev", "gc", "lease", "dq.builtins", "xmit.user", "dq.user", "debmon", NULL };
@@ -390,7 +404,7 @@ static int check_thread_properties (void)
     for (i = 0; fixed[i]; i++)
       if (strcmp (fixed[i], e->name) == 0)
         break;
-    if (fixed[i] == NULL)
+    if (fixed[i] == NULL && !is_extra_recv_thread_name (e->name))
     {
       NN_ERROR1 ("config: DDSI2Service/Threads/Thread[@name=\"%s\"]: unknown thread\n", e->name);
       ok = 0;
@@ -463,6 +477,26 @@ int rtps_config_prep (struct cfgst *cfgst)
     goto err_config_late_error;
   }
 
+  if (config.recv_threads == 0)
+  {
+    NN_ERROR0 ("Internal/ReceiveThreads must be at least 1\n");
+    goto err_config_late_error;
+  }
+  if (config.recv_threads > 1 &&
+      ((config.transport_selector != TRANS_UDP && config.transport_selector != TRANS_UDP6) ||
+       config.many_sockets_mode == MSM_NO_UNICAST))
+  {
+    NN_WARNING0 ("Internal/ReceiveThreads: additional receive threads require UDP with unicast sockets, using one\n");
+    config.recv_threads = 1;
+  }
+#ifndef SO_REUSEPORT
+  if (config.recv_threads > 1)
+  {
+    NN_WARNING0 ("Internal/ReceiveThreads: additional receive threads require SO_REUSEPORT, which this platform lacks, using one\n");
+    config.recv_threads = 1;
+  }
+#endif
+
   if (config.besmode == BESMODE_MINIMAL && config.many_sockets_mode == MSM_MANY_UNICAST)
   {
     /* These two are incompatible because minimal bes mode can result
@@ -533,7 +567,7 @@ int rtps_config_prep (struct cfgst *cfgst)
   */
 #define USER_MAX_THREADS 0
 
-    const unsigned max_threads = 9 + USER_MAX_THREADS + config.ddsi2direct_max_threads;
+    const unsigned max_threads = 8 + config.recv_threads + USER_MAX_THREADS + config.ddsi2direct_max_threads;
     thread_states_init (max_threads);
   }
 
@@ -624,6 +658,52 @@ err_disc:
   return 0;
 }
 
+static void setup_recv_threads (void)
+{
+  /* The primary receive thread serves all shared sockets through
+     gv.waitset; each additional one gets a unicast data socket of its
+     own, sharing the port of data_conn_uc, so that the kernel spreads
+     the unicast flows over the threads. Ordering per proxy writer is
+     unaffected: all receive threads serialise on the proxy writer's
+     lock for reordering and delivery. */
+  unsigned i, n = config.recv_threads;
+  if (n > 1 && (!gv.m_factory->m_connless || gv.data_conn_uc == gv.disc_conn_uc))
+  {
+    NN_WARNING0 ("Internal/ReceiveThreads: no separate unicast data socket, using one receive thread\n");
+    n = 1;
+  }
+  gv.recv_threads = os_malloc (n * sizeof (*gv.recv_threads));
+  gv.n_recv_threads = 0;
+  for (i = 0; i < n; i++)
+  {
+    struct recv_thread_arg *arg = &gv.recv_threads[i];
+    arg->ts = NULL;
+    if (i == 0)
+    {
+      arg->conn = NULL;
+      arg->waitset = gv.waitset;
+    }
+    else
+    {
+      ddsi_tran_qos_t qos = ddsi_tran_create_qos ();
+      qos->m_reuseport = TRUE;
+      arg->conn = ddsi_factory_create_conn (gv.m_factory, ddsi_tran_port (gv.data_conn_uc), qos);
+      ddsi_tran_free_qos (qos);
+      if (arg->conn == NULL)
+      {
+        NN_WARNING2 ("rtps_init: failed to create data socket for receive thread %u, using %u receive threads\n", i, i);
+        break;
+      }
+      arg->waitset = os_sockWaitsetNew ();
+    }
+    if ((arg->rbpool = nn_rbufpool_new (config.rbuf_size, config.rmsg_chunk_size)) == NULL)
+    {
+      NN_FATAL0 ("rtps_init: can't allocate receive buffer pool\n");
+    }
+    gv.n_recv_threads++;
+  }
+}
+
 int rtps_init (void)
 {
   os_uint32 port_disc_uc = 0;
@@ -695,6 +775,17 @@ int rtps_init (void)
         goto err_udp_tcp_init;
       gv.m_factory = ddsi_factory_find ("raweth");
       break;
+    case TRANS_SHM:
+      /* Like raweth: one mailbox per port, "multicast" reaches all
+         services on the host */
+      config.publish_uc_locators = 1;
+      config.enable_uc_locators = 0;
+      config.participantIndex = PARTICIPANT_INDEX_NONE;
+      config.many_sockets_mode = MSM_NO_UNICAST;
+      if (ddsi_shm_init () < 0)
+        goto err_udp_tcp_init;
+      gv.m_factory = ddsi_factory_find ("shm");
+      break;
   }
 
   if (!find_own_ip (config.networkAddressString))
@@ -853,6 +944,8 @@ int rtps_init (void)
       {
         gv.data_conn_uc = gv.data_conn_mc;
         gv.disc_conn_uc = gv.disc_conn_mc;
+        ddsi_conn_locator (gv.disc_conn_uc, &gv.loc_meta_uc);
+        ddsi_conn_locator (gv.data_conn_uc, &gv.loc_default_uc);
       }
 
       /* Set multicast locators */
@@ -925,13 +1018,10 @@ int rtps_init (void)
 
   gv.gcreq_queue = gcreq_queue_new ();
 
-  /* We create the rbufpool for the receive thread, and so we'll
-     become the initial owner thread. The receive thread will change
-     it before it does anything with it. */
-  if ((gv.rbufpool = nn_rbufpool_new (config.rbuf_size, config.rmsg_chunk_size)) == NULL)
-  {
-    NN_FATAL0 ("rtps_init: can't allocate receive buffer pool\n");
-  }
+  /* We create the rbufpools for the receive threads, and so we'll
+     become the initial owner thread. The receive threads will change
+     it before they do anything with it. */
+  setup_recv_threads ();
 
   gv.rtps_keepgoing = 1;
   os_rwlockInit (&gv.qoslock, NULL);
@@ -945,9 +1035,21 @@ int rtps_init (void)
     }
   }
 
-  gv.user_dqueue = nn_dqueue_new ("user", config.delivery_queue_maxsamples, user_dqueue_handler, NULL);
+  gv.user_dqueue_batch = deliver_batch_new ();
+  gv.user_dqueue = nn_dqueue_new ("user", config.delivery_queue_maxsamples, user_dqueue_handler, gv.user_dqueue_batch);
 
-  gv.recv_ts = create_thread ("recv", (void * (*) (void *)) recv_thread, gv.rbufpool);
+  {
+    unsigned i;
+    for (i = 0; i < gv.n_recv_threads; i++)
+    {
+      char name[16];
+      if (i == 0)
+        (void) snprintf (name, sizeof (name), "recv");
+      else
+        (void) snprintf (name, sizeof (name), "recv.%u", i);
+      gv.recv_threads[i].ts = create_thread (name, (void * (*) (void *)) recv_thread, &gv.recv_threads[i]);
+    }
+  }
   if (gv.listener)
   {
     gv.listen_ts = create_thread ("listen", (void * (*) (void *)) listen_thread, gv.listener);
@@ -1038,6 +1140,7 @@ static void builtins_dqueue_ready_cb (void *varg)
 
 void rtps_term_prep (void)
 {
+  unsigned i;
   /* Stop all I/O */
   os_mutexLock (&gv.lock);
   if (gv.rtps_keepgoing)
@@ -1045,7 +1148,8 @@ void rtps_term_prep (void)
     gv.rtps_keepgoing = 0; /* so threads will stop once they get round to checking */
     pa_fence ();
     /* can't wake up throttle_writer, currently, but it'll check every few seconds */
-    os_sockWaitsetTrigger (gv.waitset);
+    for (i = 0; i < gv.n_recv_threads; i++)
+      os_sockWaitsetTrigger (gv.recv_threads[i].waitset);
   }
   os_mutexUnlock (&gv.lock);
 }
@@ -1053,10 +1157,12 @@ void rtps_term_prep (void)
 void rtps_term (void)
 {
   struct thread_state1 *self = lookup_thread_state ();
+  unsigned i;
 
   /* Stop all I/O */
   rtps_term_prep ();
-  join_thread (gv.recv_ts, NULL);
+  for (i = 0; i < gv.n_recv_threads; i++)
+    join_thread (gv.recv_threads[i].ts, NULL);
 
   if (gv.listener)
   {
@@ -1166,12 +1272,18 @@ void rtps_term (void)
   nn_dqueue_free (gv.builtins_dqueue);
 
   nn_dqueue_free (gv.user_dqueue);
+  deliver_batch_free (gv.user_dqueue_batch);
 
   xeventq_free (gv.xevents);
 
 
   ut_thread_pool_free (gv.thread_pool);
 
+  for (i = 1; i < gv.n_recv_threads; i++)
+  {
+    os_sockWaitsetFree (gv.recv_threads[i].waitset);
+    ddsi_conn_free (gv.recv_threads[i].conn);
+  }
   os_sockWaitsetFree (gv.waitset);
 
   (void) joinleave_spdp_defmcip (0);
@@ -1206,7 +1318,9 @@ void rtps_term (void)
      been dropped, which only happens once all receive threads have
      stopped, defrags and reorders have been freed, and all delivery
      queues been drained.  I.e., until very late in the game. */
-  nn_rbufpool_free (gv.rbufpool);
+  for (i = 0; i < gv.n_recv_threads; i++)
+    nn_rbufpool_free (gv.recv_threads[i].rbpool);
+  os_free (gv.recv_threads);
 
   ephash_free (gv.guid_hash);
   deleted_participants_admin_fini ();
@@ -43,6 +43,7 @@
 #include "q_feature_check.h"
 #include "ut_avl.h"
 #include "ddsi_ipaddr.h"
+#include "ddsi_shm.h"
 
 static void print_sockerror (const char *msg)
 {
@@ -191,6 +192,27 @@ static int set_reuse_options (os_socket socket)
   return 0;
 }
 
+static int set_reuseport_option (os_socket socket)
+{
+  /* Set REUSEPORT for unicast sockets that are to be sharded over
+     multiple receive threads: the kernel then distributes incoming
+     datagrams over the sockets by source address. */
+#ifdef SO_REUSEPORT
+  int one = 1;
+
+  if (os_sockSetsockopt (socket, SOL_SOCKET, SO_REUSEPORT, (char *) &one, sizeof (one)) != os_resultSuccess)
+  {
+    print_sockerror ("SO_REUSEPORT");
+    return -2;
+  }
+  return 0;
+#else
+  /* never requested: rtps_config_prep limits ReceiveThreads to 1 */
+  (void) socket;
+  return 0;
+#endif
+}
+
 static int bind_socket (os_socket socket, unsigned short port)
 {
   int rc;
@@ -327,7 +349,8 @@ int make_socket
   os_socket * sock,
   unsigned short port,
   c_bool stream,
-  c_bool reuse
+  c_bool reuse,
+  c_bool reuseport
 )
 {
   int rc = -2;
@@ -359,6 +382,11 @@ int make_socket
     goto fail;
   }
 
+  if (reuseport && ((rc = set_reuseport_option (*sock)) < 0))
+  {
+    goto fail;
+  }
+
   if
   (
     (rc = set_rcvbuf (*sock) < 0) ||
@@ -507,6 +535,11 @@ int find_own_ip (const char *requested_address)
       memset(l->address, 0, 10);
       memcpy(l->address + 10, ((struct sockaddr_ll *)&tmpip)->sll_addr, 6);
     }
+    else if (tmpip.ss_family == AF_UNIX)
+    {
+      /* shared memory pseudo-interface, address is host & process specific */
+      ddsi_shm_own_locator (&gv.interfaces[gv.n_interfaces].loc);
+    }
     else
 #endif
     {
@@ -38,7 +38,7 @@ struct nn_interface {
   char *name;
 };
 
-int make_socket (os_socket *socket, unsigned short port, c_bool stream, c_bool reuse);
+int make_socket (os_socket *socket, unsigned short port, c_bool stream, c_bool reuse, c_bool reuseport);
 int find_own_ip (const char *requested_address);
 
 #if defined (__cplusplus)
@@ -2116,6 +2116,58 @@ v_message deserialize (const struct sertopic * topic, const void *vsrc, size_t v
   return NULL;
 }
 
+v_message deserialize_fragments (const struct sertopic * topic, unsigned nfrags, struct sd_cdrFragment *frags)
+{
+  /* Deserializes the concatenation of FRAGS[0 .. NFRAGS-1], which must
+     start with the complete CDR header; FRAGS[0] is updated to skip
+     it. */
+  deserialize1_t df;
+  v_message msg;
+  char *dst;
+  const char *src;
+  size_t srcsize;
+  assert (nfrags > 0);
+  if (!deserialize_prep (&msg, &dst, &df, &src, &srcsize, topic, frags[0].data, frags[0].size))
+    goto fail;
+  frags[0].data = src;
+  frags[0].size = (os_uint32) srcsize;
+#if USE_PRIVATE_SERIALIZER
+  {
+    char *buf;
+    os_uint32 sz = 0;
+    unsigned i;
+    int rc;
+    for (i = 0; i < nfrags; i++)
+      sz += frags[i].size;
+    buf = os_malloc (sz);
+    for (i = 0, sz = 0; i < nfrags; i++)
+    {
+      memcpy (buf + sz, frags[i].data, frags[i].size);
+      sz += frags[i].size;
+    }
+    rc = df (topic->type, dst, buf, 0, sz);
+    os_free (buf);
+    if (rc < 0)
+      goto fail;
+  }
+#else
+  if (df == deserialize1)
+  {
+    if (sd_cdrDeserializeRawFragments (dst, topic->ci, nfrags, frags) < 0)
+      goto fail;
+  }
+  else
+  {
+    if (sd_cdrDeserializeRawFragmentsBSwap (dst, topic->ci, nfrags, frags) < 0)
+      goto fail;
+  }
+#endif
+  return msg;
+ fail:
+  if (msg) c_free (msg);
+  return NULL;
+}
+
 v_message deserialize_from_key (const struct sertopic * topic, const void *vsrc, size_t vsrcsize)
 {
   /* v_topic has a messageKeyList which is an array of 'c_field's,
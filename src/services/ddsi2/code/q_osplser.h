@@ -23,6 +23,8 @@
 #include "kernelModuleI.h"
 #include "ddsi_ser.h"
 
+struct sd_cdrFragment;
+
 extern sertopic_t osplser_topic4u;
 extern sertopic_t osplser_topicpmd;
 extern c_type osplser_topicpmd_type;
@@ -42,6 +44,7 @@ serdata_t serialize_key (serstatepool_t pool, const struct sertopic * tp, C_STRU
 serdata_t serialize_empty (serstatepool_t pool, unsigned statusinfo, C_STRUCT (v_message) const *msg);
 
 v_message deserialize (const struct sertopic * topic, const void *vsrc, size_t vsrcsize);
+v_message deserialize_fragments (const struct sertopic * topic, unsigned nfrags, struct sd_cdrFragment *frags);
 v_message deserialize_from_key (const struct sertopic * topic, const void *vsrc, size_t vsrcsize);
 v_message deserialize_from_keyhash (const struct sertopic * topic, const void *vsrc, size_t vsrcsize);
 
@@ -963,6 +963,12 @@ static int locator_address_prefix12_zero (const nn_locator_t *loc)
   return (u[0] == 0 && u[1] == 0 && u[2] == 0);
 }
 
+static int locator_address_prefix10_zero (const nn_locator_t *loc)
+{
+  static const unsigned char zero[10] = { 0 };
+  return memcmp (loc->address, zero, sizeof (zero)) == 0;
+}
+
 static int locator_address_zero (const nn_locator_t *loc)
 {
   /* see locator_address_prefix12_zero */
@@ -1015,6 +1021,25 @@ static int do_locator
         return ERR_INVALID;
       }
       break;
+    case NN_LOCATOR_KIND_SHM:
+      if (loc.port <= 0 || loc.port > 65535)
+      {
+        TRACE (("plist/do_locator[kind=SHM]: invalid port (%d)\n", (int) loc.port));
+        return ERR_INVALID;
+      }
+      break;
+    case NN_LOCATOR_KIND_RAWETH:
+      if (loc.port <= 0 || loc.port > 65535)
+      {
+        TRACE (("plist/do_locator[kind=RAWETH]: invalid port (%d)\n", (int) loc.port));
+        return ERR_INVALID;
+      }
+      if (!locator_address_prefix10_zero (&loc))
+      {
+        TRACE (("plist/do_locator[kind=RAWETH]: junk in address prefix\n"));
+        return ERR_INVALID;
+      }
+      break;
     case NN_LOCATOR_KIND_INVALID:
       if (!locator_address_zero (&loc))
       {
@@ -122,6 +122,7 @@ struct cdrstring {
 #define NN_LOCATOR_KIND_TCPv4 4
 #define NN_LOCATOR_KIND_TCPv6 8
 #define NN_LOCATOR_KIND_RAWETH 0x8000 /* proposed vendor-specific */
+#define NN_LOCATOR_KIND_SHM 0x8001 /* vendor-specific, host-local shared memory */
 #define NN_LOCATOR_PORT_INVALID 0
 
 #define NN_VENDORID_UNKNOWN           {{ 0x00, 0x00 }}
@@ -18,6 +18,7 @@
  *
  */
 #include <ctype.h>
+#include <string.h>
 #include <stddef.h>
 #include <stdarg.h>
 #include <limits.h>
@@ -51,6 +52,7 @@
 #include "q_radmin.h"
 #include "q_bitset.h"
 #include "q_thread.h"
+#include "q_time.h"
 #include "q_globals.h" /* for mattr, cattr */
 
 #include "sysdeps.h"
@@ -389,13 +391,6 @@ struct nn_rbufpool *nn_rbufpool_new (os_uint32 rbuf_size, os_uint32 max_rmsg_siz
   return NULL;
 }
 
-void nn_rbufpool_setowner (UNUSED_ARG_NDEBUG (struct nn_rbufpool *rbp), UNUSED_ARG_NDEBUG (os_threadId tid))
-{
-#ifndef NDEBUG
-  rbp->owner_tid = tid;
-#endif
-}
-
 void nn_rbufpool_free (struct nn_rbufpool *rbp)
 {
 #if 0
@@ -473,6 +468,30 @@ static struct nn_rbuf *nn_rbuf_new (struct nn_rbufpool *rbufpool)
   return rb;
 }
 
+void nn_rbufpool_setowner (struct nn_rbufpool *rbp, os_threadId tid)
+{
+#ifndef NDEBUG
+  rbp->owner_tid = tid;
+#endif
+  /* The pool is created before its owning thread is started, so the
+     initial rbuf was allocated by another thread and possibly on
+     another NUMA node. If the new owner takes over the pool while the
+     current rbuf is still unused, replace it by one it allocates
+     itself, so the memory is placed according to the owner's memory
+     policy. */
+  if (os_threadEqual (tid, os_threadIdSelf ()) && rbp->current->freeptr == rbp->current->u.raw)
+  {
+    struct nn_rbuf *rb;
+    if ((rb = nn_rbuf_alloc_new (rbp)) != NULL)
+    {
+      os_mutexLock (&rbp->lock);
+      nn_rbuf_release (rbp->current);
+      rbp->current = rb;
+      os_mutexUnlock (&rbp->lock);
+    }
+  }
+}
+
 static void nn_rbuf_release (struct nn_rbuf *rbuf)
 {
   struct nn_rbufpool *rbp = rbuf->rbufpool;
@@ -1645,7 +1664,21 @@ int nn_defrag_nackmap (struct nn_defrag *defrag, os_int64 seq, os_uint32 maxfrag
    admins that accepted it, less BIAS for the initial reference.  We
    can't use the original sample because of [CASE I], so we adjust
    based on the fragment chain instead of the sample.  Example code is
-   in the overview comment at the top of this file. */
+   in the overview comment at the top of this file.
+
+   Besides the interval tree, the reorder admin keeps a bitmap of which
+   of the sequence numbers in [next_seq,next_seq+REORDER_WINDOW) are
+   covered by an interval, stored as a ring indexed by sequence number
+   modulo the window size, most significant bit first like a NACK
+   bitmap.  With a few samples missing in a dense stream, that answers
+   duplicate checks, nn_reorder_wantsample and nn_reorder_nackmap
+   without going through the tree, and it tells which neighbouring
+   intervals need to be looked up when inserting.  Intervals beyond
+   the window are only in the tree; they enter the bitmap when
+   next_seq advances.  The window covers the largest NACK bitmap, so
+   with base = next_seq a nackmap never needs the tree. */
+
+#define REORDER_WINDOW 256 /* power of 2, >= 256 */
 
 struct nn_reorder {
   ut_avlTree_t sampleivtree;
@@ -1654,6 +1687,7 @@ struct nn_reorder {
   enum nn_reorder_mode mode;
   os_uint32 max_samples;
   os_uint32 n_samples;
+  os_uint32 window[REORDER_WINDOW / 32];
 };
 
 static const ut_avlTreedef_t reorder_sampleivtree_treedef =
@@ -1670,6 +1704,7 @@ struct nn_reorder *nn_reorder_new (enum nn_reorder_mode mode, os_uint32 max_samp
   r->mode = mode;
   r->max_samples = max_samples;
   r->n_samples = 0;
+  memset (r->window, 0, sizeof (r->window));
   return r;
 }
 
@@ -1713,7 +1748,97 @@ static void reorder_add_rsampleiv (struct nn_reorder *reorder, struct nn_rsample
   ut_avlInsertIPath (&reorder_sampleivtree_treedef, &reorder->sampleivtree, rsample, &path);
 }
 
+static int reorder_in_window (const struct nn_reorder *reorder, os_int64 seq)
+{
+  return seq >= reorder->next_seq && seq < reorder->next_seq + REORDER_WINDOW;
+}
+
+static int reorder_window_isset (const struct nn_reorder *reorder, os_int64 seq)
+{
+  const unsigned idx = (unsigned) seq & (REORDER_WINDOW - 1);
+  assert (reorder_in_window (reorder, seq));
+  return (int) ((reorder->window[idx / 32] >> (31 - idx % 32)) & 1);
+}
+
+static void reorder_window_update (struct nn_reorder *reorder, os_int64 min, os_int64 maxp1, int covered)
+{
+  /* Marks the part of [min,maxp1) that is in the window as covered by
+     an interval or not */
+  if (min < reorder->next_seq)
+    min = reorder->next_seq;
+  if (maxp1 > reorder->next_seq + REORDER_WINDOW)
+    maxp1 = reorder->next_seq + REORDER_WINDOW;
+  while (min < maxp1)
+  {
+    const unsigned idx = (unsigned) min & (REORDER_WINDOW - 1);
+    const unsigned n = (maxp1 - min < 32 - idx % 32) ? (unsigned) (maxp1 - min) : 32 - idx % 32;
+    const os_uint32 mask = (n == 32) ? ~0u : ((1u << n) - 1) << (32 - idx % 32 - n);
+    if (covered)
+      reorder->window[idx / 32] |= mask;
+    else
+      reorder->window[idx / 32] &= ~mask;
+    min += n;
+  }
+}
+
+static os_uint32 reorder_window_get32 (const struct nn_reorder *reorder, os_int64 seq)
+{
+  /* Returns the bits for [seq,seq+32), seq in the most significant
+     bit, with everything outside the window reading as not covered */
+  const unsigned idx = (unsigned) seq & (REORDER_WINDOW - 1);
+  const unsigned w = idx / 32, b = idx % 32;
+  os_uint32 v = reorder->window[w] << b;
+  if (b > 0)
+    v |= reorder->window[(w + 1) % (REORDER_WINDOW / 32)] >> (32 - b);
+  if (seq < reorder->next_seq)
+    v = (reorder->next_seq - seq >= 32) ? 0 : v & (~0u >> (reorder->next_seq - seq));
+  if (seq + 32 > reorder->next_seq + REORDER_WINDOW)
+    v = (seq >= reorder->next_seq + REORDER_WINDOW) ? 0 : v & (~0u << (seq + 32 - reorder->next_seq - REORDER_WINDOW));
+  return v;
+}
+
+static void reorder_set_next_seq (struct nn_reorder *reorder, os_int64 next_seq)
+{
+  const os_int64 old = reorder->next_seq;
+  if (next_seq <= old)
+  {
+    /* Only in the modes that never store anything */
+    assert (reorder->max_sampleiv == NULL);
+    reorder->next_seq = next_seq;
+  }
+  else
+  {
+    /* What drops out of the window at the start becomes the new end,
+       which may hold intervals that until now were beyond the window.
+       The tree must be up-to-date already. */
+    const os_int64 lo = (old + REORDER_WINDOW > next_seq) ? old + REORDER_WINDOW : next_seq;
+    reorder_window_update (reorder, old, next_seq, 0);
+    reorder->next_seq = next_seq;
+    if (reorder->max_sampleiv != NULL && reorder->max_sampleiv->u.reorder.maxp1 > lo)
+    {
+      struct nn_rsample *iv;
+      if ((iv = ut_avlLookupPredEq (&reorder_sampleivtree_treedef, &reorder->sampleivtree, &lo)) == NULL)
+        iv = ut_avlFindMin (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
+      for (; iv && iv->u.reorder.min < next_seq + REORDER_WINDOW; iv = ut_avlFindSucc (&reorder_sampleivtree_treedef, &reorder->sampleivtree, iv))
+        reorder_window_update (reorder, iv->u.reorder.min, iv->u.reorder.maxp1, 1);
+    }
+  }
+}
+
 #ifndef NDEBUG
+static int reorder_window_consistent (const struct nn_reorder *reorder)
+{
+  struct nn_reorder tmp;
+  struct nn_rsample *iv;
+  tmp.next_seq = reorder->next_seq;
+  memset (tmp.window, 0, sizeof (tmp.window));
+  for (iv = ut_avlFindMin (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
+       iv && iv->u.reorder.min < reorder->next_seq + REORDER_WINDOW;
+       iv = ut_avlFindSucc (&reorder_sampleivtree_treedef, &reorder->sampleivtree, iv))
+    reorder_window_update (&tmp, iv->u.reorder.min, iv->u.reorder.maxp1, 1);
+  return memcmp (tmp.window, reorder->window, sizeof (tmp.window)) == 0;
+}
+
 static int rsample_is_singleton (const struct nn_rsample_reorder *s)
 {
   assert (s->min < s->maxp1);
@@ -1838,6 +1963,7 @@ static void delete_last_sample (struct nn_reorder *reorder)
        recalc max_sampleiv. */
     TRACE_RADMIN (("  delete_last_sample: in singleton interval\n"));
     fragchain = last->sc.first->fragchain;
+    reorder_window_update (reorder, last->min, last->maxp1, 0);
     ut_avlDelete (&reorder_sampleivtree_treedef, &reorder->sampleivtree, reorder->max_sampleiv);
     reorder->max_sampleiv = ut_avlFindMax (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
     /* No harm done if it the sampleivtree is empty, except that we
@@ -1867,6 +1993,7 @@ static void delete_last_sample (struct nn_reorder *reorder)
     last->sc.last = pe;
     last->maxp1--;
     last->n_samples--;
+    reorder_window_update (reorder, last->maxp1, last->maxp1 + 1, 0);
   }
 
   nn_fragchain_unref (fragchain);
@@ -1882,6 +2009,7 @@ nn_reorder_result_t nn_reorder_rsample (struct nn_rsample_chain *sc, struct nn_r
 
      refcount_adjust is incremented if the sample is not discarded. */
   struct nn_rsample_reorder *s = &rsampleiv->u.reorder;
+  const os_int64 seq = s->min;
 
   TRACE_RADMIN (("reorder_sample(%p %c, %lld @ %p) expecting %lld:\n", (void *) reorder, reorder_mode_as_char (reorder), rsampleiv->u.reorder.min, (void *) rsampleiv, reorder->next_seq));
 
@@ -1900,6 +2028,7 @@ nn_reorder_result_t nn_reorder_rsample (struct nn_rsample_chain *sc, struct nn_r
             (reorder->max_sampleiv != NULL && min != NULL));
   }
 #endif
+  assert (reorder_window_consistent (reorder));
   assert ((!!ut_avlIsEmpty (&reorder->sampleivtree)) == (reorder->max_sampleiv == NULL));
   assert (reorder->max_sampleiv == NULL || reorder->max_sampleiv == ut_avlFindMax (&reorder_sampleivtree_treedef, &reorder->sampleivtree));
   assert (reorder->n_samples <= reorder->max_samples);
@@ -1925,15 +2054,17 @@ nn_reorder_result_t nn_reorder_rsample (struct nn_rsample_chain *sc, struct nn_r
     /* 's' is next sample to be delivered; maybe we can append the
        first interval in the tree to it.  We can avoid all processing
        if the index is empty, which is the normal case.  Unreliable
-       out-of-order either ends up here or in discard.)  */
-    if (reorder->max_sampleiv != NULL)
+       out-of-order either ends up here or in discard.)  The window
+       tells us whether there is an interval starting right after it. */
+    if (reorder->max_sampleiv != NULL &&
+        !(reorder_in_window (reorder, s->maxp1) && !reorder_window_isset (reorder, s->maxp1)))
     {
       struct nn_rsample *min = ut_avlFindMin (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
       TRACE_RADMIN (("  try append_and_discard\n"));
       if (reorder_try_append_and_discard (reorder, rsampleiv, min))
         reorder->max_sampleiv = NULL;
     }
-    reorder->next_seq = s->maxp1;
+    reorder_set_next_seq (reorder, s->maxp1);
     *sc = rsampleiv->u.reorder.sc;
     (*refcount_adjust)++;
     TRACE_RADMIN (("  return [%lld,%lld)\n", s->min, s->maxp1));
@@ -1970,6 +2101,7 @@ nn_reorder_result_t nn_reorder_rsample (struct nn_rsample_chain *sc, struct nn_r
       reorder_add_rsampleiv (reorder, rsampleiv);
       reorder->max_sampleiv = rsampleiv;
       reorder->n_samples++;
+      reorder_window_update (reorder, seq, seq + 1, 1);
     }
   }
   else if (s->min == reorder->max_sampleiv->u.reorder.maxp1)
@@ -1989,6 +2121,7 @@ nn_reorder_result_t nn_reorder_rsample (struct nn_rsample_chain *sc, struct nn_r
     {
       append_rsample_interval (reorder->max_sampleiv, rsampleiv);
       reorder->n_samples++;
+      reorder_window_update (reorder, seq, seq + 1, 1);
     }
     else
     {
@@ -2010,6 +2143,7 @@ nn_reorder_result_t nn_reorder_rsample (struct nn_rsample_chain *sc, struct nn_r
       reorder_add_rsampleiv (reorder, rsampleiv);
       reorder->max_sampleiv = rsampleiv;
       reorder->n_samples++;
+      reorder_window_update (reorder, seq, seq + 1, 1);
     }
     else
     {
@@ -2025,7 +2159,11 @@ nn_reorder_result_t nn_reorder_rsample (struct nn_rsample_chain *sc, struct nn_r
        - if m <= s->min < n we discard it (duplicate)
        - if n=s->min we can append s to predeq
        - if immsucc exists we can prepend s to immsucc
-       - and possibly join predeq, s, and immsucc */
+       - and possibly join predeq, s, and immsucc
+
+       Inside the window, s->min-1 resp. s->maxp1 not being covered
+       means there is no predeq resp. immsucc that we care about, and
+       the lookups can be skipped. */
     struct nn_rsample *predeq, *immsucc;
     TRACE_RADMIN (("  hard case ...\n"));
 
@@ -2035,7 +2173,17 @@ nn_reorder_result_t nn_reorder_rsample (struct nn_rsample_chain *sc, struct nn_r
       return NN_REORDER_REJECT;
     }
 
-    predeq = ut_avlLookupPredEq (&reorder_sampleivtree_treedef, &reorder->sampleivtree, &s->min);
+    if (!reorder_in_window (reorder, s->min))
+      predeq = ut_avlLookupPredEq (&reorder_sampleivtree_treedef, &reorder->sampleivtree, &s->min);
+    else if (reorder_window_isset (reorder, s->min))
+    {
+      TRACE_RADMIN (("  discard: in window\n"));
+      return NN_REORDER_REJECT;
+    }
+    else if (reorder_window_isset (reorder, s->min - 1))
+      predeq = ut_avlLookupPredEq (&reorder_sampleivtree_treedef, &reorder->sampleivtree, &s->min);
+    else
+      predeq = NULL;
     if (predeq)
       TRACE_RADMIN (("  predeq = [%lld,%lld) @ %p\n",
                      predeq->u.reorder.min, predeq->u.reorder.maxp1, (void *) predeq));
@@ -2048,7 +2196,10 @@ nn_reorder_result_t nn_reorder_rsample (struct nn_rsample_chain *sc, struct nn_r
       return NN_REORDER_REJECT;
     }
 
-    immsucc = ut_avlLookup (&reorder_sampleivtree_treedef, &reorder->sampleivtree, &s->maxp1);
+    if (reorder_in_window (reorder, s->maxp1) && !reorder_window_isset (reorder, s->maxp1))
+      immsucc = NULL;
+    else
+      immsucc = ut_avlLookup (&reorder_sampleivtree_treedef, &reorder->sampleivtree, &s->maxp1);
     if (immsucc)
       TRACE_RADMIN (("  immsucc = [%lld,%lld) @ %p\n",
                      immsucc->u.reorder.min, immsucc->u.reorder.maxp1, (void *) immsucc));
@@ -2096,6 +2247,7 @@ nn_reorder_result_t nn_reorder_rsample (struct nn_rsample_chain *sc, struct nn_r
       TRACE_RADMIN (("  new interval\n"));
       reorder_add_rsampleiv (reorder, rsampleiv);
     }
+    reorder_window_update (reorder, seq, seq + 1, 1);
 
     /* do not let radmin grow beyond max_samples; now that we've
        inserted it (and possibly have grown the radmin beyond its max
@@ -2223,6 +2375,7 @@ nn_reorder_result_t nn_reorder_gap (struct nn_rsample_chain *sc, struct nn_reord
   TRACE_RADMIN (("reorder_gap(%p %c, [%lld,%lld) data %p) expecting %lld:\n",
                  (void *) reorder, reorder_mode_as_char (reorder),
                  min, maxp1, (void *) rdata, reorder->next_seq));
+  assert (reorder_window_consistent (reorder));
 
   if (maxp1 <= reorder->next_seq)
   {
@@ -2243,7 +2396,7 @@ nn_reorder_result_t nn_reorder_gap (struct nn_rsample_chain *sc, struct nn_reord
     if (min <= reorder->next_seq)
     {
       TRACE_RADMIN (("  next expected: %lld\n", maxp1));
-      reorder->next_seq = maxp1;
+      reorder_set_next_seq (reorder, maxp1);
       res = NN_REORDER_ACCEPT;
     }
     else if (reorder->n_samples == reorder->max_samples &&
@@ -2262,6 +2415,7 @@ nn_reorder_result_t nn_reorder_gap (struct nn_rsample_chain *sc, struct nn_reord
     {
       TRACE_RADMIN (("  storing gap\n"));
       res = NN_REORDER_ACCEPT;
+      reorder_window_update (reorder, min, maxp1, 1);
       /* do not let radmin grow beyond max_samples; there is a small
          possibility that we insert it & delete it immediately
          afterward. */
@@ -2282,8 +2436,8 @@ nn_reorder_result_t nn_reorder_gap (struct nn_rsample_chain *sc, struct nn_reord
     ut_avlDelete (&reorder_sampleivtree_treedef, &reorder->sampleivtree, coalesced);
     if (coalesced->u.reorder.min <= reorder->next_seq)
       assert (min <= reorder->next_seq);
-    reorder->next_seq = coalesced->u.reorder.maxp1;
     reorder->max_sampleiv = ut_avlFindMax (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
+    reorder_set_next_seq (reorder, coalesced->u.reorder.maxp1);
     TRACE_RADMIN (("  next expected: %lld\n", reorder->next_seq));
     *sc = coalesced->u.reorder.sc;
 
@@ -2297,6 +2451,7 @@ nn_reorder_result_t nn_reorder_gap (struct nn_rsample_chain *sc, struct nn_reord
   {
     TRACE_RADMIN (("  coalesced = [%lld,%lld) @ %p - that is all\n",
                    coalesced->u.reorder.min, coalesced->u.reorder.maxp1, (void *) coalesced));
+    reorder_window_update (reorder, coalesced->u.reorder.min, coalesced->u.reorder.maxp1, 1);
     reorder->max_sampleiv = ut_avlFindMax (&reorder_sampleivtree_treedef, &reorder->sampleivtree);
     return valuable ? NN_REORDER_ACCEPT : NN_REORDER_REJECT;
   }
@@ -2308,6 +2463,8 @@ int nn_reorder_wantsample (struct nn_reorder *reorder, os_int64 seq)
   if (seq < reorder->next_seq)
     /* trivially not interesting */
     return 0;
+  else if (reorder_in_window (reorder, seq))
+    return !reorder_window_isset (reorder, seq);
   /* Find interval that contains seq, if we know seq.  We are
      interested if seq is outside this interval (if any). */
   s = ut_avlLookupPredEq (&reorder_sampleivtree_treedef, &reorder->sampleivtree, &seq);
@@ -2351,6 +2508,32 @@ unsigned nn_reorder_nackmap (struct nn_reorder *reorder, os_int64 base, os_int64
     map->numbits = maxsz;
   else
     map->numbits = (os_uint32) (maxseq + 1 - base);
+
+  if (base + map->numbits <= reorder->next_seq + REORDER_WINDOW)
+  {
+    /* Everything is in the window (the normal case, with base =
+       next_seq), so the bitmap is simply the complement of the window,
+       with anything before next_seq missing.  Without the tail, the bitmap stops at the
+       end of the last interval. */
+    os_uint32 k;
+    assert (reorder_window_consistent (reorder));
+    if (notail)
+    {
+      if (reorder->max_sampleiv == NULL)
+        map->numbits = 0;
+      else if (reorder->max_sampleiv->u.reorder.maxp1 < base + map->numbits)
+        map->numbits = (unsigned) (reorder->max_sampleiv->u.reorder.maxp1 - base);
+    }
+    for (k = 0; 32 * k < map->numbits; k++)
+    {
+      os_uint32 m = ~reorder_window_get32 (reorder, base + 32 * k);
+      if (map->numbits - 32 * k < 32)
+        m &= ~(~0u >> (map->numbits - 32 * k));
+      map->bits[k] = m;
+    }
+    return map->numbits;
+  }
+
   nn_bitset_zero (map->numbits, map->bits);
 
   if ((iv = ut_avlFindMin (&reorder_sampleivtree_treedef, &reorder->sampleivtree)) != NULL)
@@ -2398,6 +2581,8 @@ struct nn_dqueue {
   char *name;
   os_uint32 max_samples;
   pa_uint32_t nof_samples;
+  pa_uint32_t paused;
+  int stopping;
 };
 
 enum dqueue_elem_kind {
@@ -2441,6 +2626,49 @@ static enum dqueue_elem_kind dqueue_elem_kind (const struct nn_rsample_chain_ele
     return DQEK_BUBBLE;
 }
 
+static void dqueue_spin (struct nn_dqueue *q)
+{
+  /* Polls the empty queue for at most Internal/DeliveryQueueSpinTime
+     without holding the lock, so that enqueuing is not slowed down;
+     called and returns with q->lock held. The clock is only read every
+     so many polls because reading it costs more than polling. */
+  struct nn_rsample_chain_elem * volatile *first = &q->sc.first;
+  const nn_mtime_t tend = add_duration_to_mtime (now_mt (), config.delivery_queue_spin_time);
+  unsigned polls = 0;
+  os_mutexUnlock (&q->lock);
+  while (*first == NULL && (++polls % 64 != 0 || now_mt ().v < tend.v))
+    pa_spin_hint ();
+  os_mutexLock (&q->lock);
+}
+
+static int dqueue_pause (struct nn_dqueue *q, struct nn_rsample_chain *sc, struct nn_rsample_chain_elem *e)
+{
+  /* The handler couldn't deliver E: put it back at the head of SC and
+     give the handler some time to recover before retrying it.  Enqueues
+     don't signal a paused queue, so only nn_dqueue_free cuts the wait
+     short.  Once the queue is being stopped, nothing is retried anymore
+     and E is dropped, in which case it returns 0 with the queue no
+     longer paused, so that the STOP bubble does wake it up. */
+  const os_duration retry_delay = OS_DURATION_INIT(0, 10000000);
+  int stopping;
+  os_mutexLock (&q->lock);
+  if (!(stopping = q->stopping))
+  {
+    pa_st32 (&q->paused, 1);
+    (void) os_condTimedWait (&q->cond, &q->lock, retry_delay);
+    stopping = q->stopping;
+  }
+  if (stopping)
+    pa_st32 (&q->paused, 0);
+  os_mutexUnlock (&q->lock);
+  if (stopping)
+    return 0;
+  e->next = sc->first;
+  sc->first = e;
+  pa_inc32 (&q->nof_samples);
+  return 1;
+}
+
 static void *dqueue_thread (struct nn_dqueue *q)
 {
   struct thread_state1 *self = lookup_thread_state ();
@@ -2448,6 +2676,7 @@ static void *dqueue_thread (struct nn_dqueue *q)
   int keepgoing = 1;
   nn_guid_t rdguid, *prdguid = NULL;
   os_uint32 rdguid_count = 0;
+  int batch_pending = 0;
 
   os_mutexLock (&q->lock);
   while (keepgoing)
@@ -2456,6 +2685,8 @@ static void *dqueue_thread (struct nn_dqueue *q)
 
     LOG_THREAD_CPUTIME (next_thread_cputime);
 
+    if (q->sc.first == NULL && config.delivery_queue_spin_time > 0)
+      dqueue_spin (q);
     if (q->sc.first == NULL)
       os_condWait (&q->cond, &q->lock);
     sc = q->sc;
@@ -2473,8 +2704,20 @@ static void *dqueue_thread (struct nn_dqueue *q)
       {
         case DQEK_DATA:
           ret = q->handler (e->sampleinfo, e->fragchain, prdguid, q->handler_arg);
-          (void) ret; /* eliminate set-but-not-used in NDEBUG case */
-          assert (ret == 0); /* so every handler will return 0 */
+          assert (ret == 0 || ret == NN_DQUEUE_HANDLER_PAUSE);
+          if (ret == NN_DQUEUE_HANDLER_PAUSE)
+          {
+            thread_state_asleep (self);
+            if (dqueue_pause (q, &sc, e))
+              continue;
+            thread_state_awake (self);
+          }
+          else
+          {
+            if (pa_ld32 (&q->paused))
+              pa_st32 (&q->paused, 0);
+            batch_pending = 1;
+          }
           /* FALLS THROUGH */
         case DQEK_GAP:
           nn_fragchain_unref (e->fragchain);
@@ -2488,6 +2731,11 @@ static void *dqueue_thread (struct nn_dqueue *q)
         case DQEK_BUBBLE:
           {
             struct nn_dqueue_bubble *b = (struct nn_dqueue_bubble *) e->sampleinfo;
+            if (batch_pending)
+            {
+              (void) q->handler (NULL, NULL, NULL, q->handler_arg);
+              batch_pending = 0;
+            }
             if (b->kind == NN_DQBK_STOP)
             {
               /* Stuff enqueued behind the bubble will still be
@@ -2521,6 +2769,14 @@ static void *dqueue_thread (struct nn_dqueue *q)
       thread_state_asleep (self);
     }
 
+    if (batch_pending)
+    {
+      thread_state_awake (self);
+      (void) q->handler (NULL, NULL, NULL, q->handler_arg);
+      thread_state_asleep (self);
+      batch_pending = 0;
+    }
+
     os_mutexLock (&q->lock);
   }
   os_mutexUnlock (&q->lock);
@@ -2538,6 +2794,8 @@ struct nn_dqueue *nn_dqueue_new (const char *name, os_uint32 max_samples, nn_dqu
     goto fail_name;
   q->max_samples = max_samples;
   pa_st32 (&q->nof_samples, 0);
+  pa_st32 (&q->paused, 0);
+  q->stopping = 0;
   q->handler = handler;
   q->handler_arg = arg;
   q->sc.first = q->sc.last = NULL;
@@ -2572,10 +2830,13 @@ struct nn_dqueue *nn_dqueue_new (const char *name, os_uint32 max_samples, nn_dqu
 
 static int nn_dqueue_enqueue_locked (struct nn_dqueue *q, struct nn_rsample_chain *sc)
 {
+  /* A paused queue thread retries on a timer and picks up whatever got
+     queued in the meantime afterward, waking it up would only make it
+     retry early. */
   int must_signal;
   if (q->sc.first == NULL)
   {
-    must_signal = 1;
+    must_signal = !pa_ld32 (&q->paused);
     q->sc = *sc;
   }
   else
@@ -2659,7 +2920,12 @@ int nn_dqueue_is_full (struct nn_dqueue *q)
      and survive the occasional decision to not queue when it
      could've been queued (we do), it should be ok. */
   const os_uint32 count = pa_ld32 (&q->nof_samples);
-  return (count >= q->max_samples);
+  return (count >= q->max_samples || pa_ld32 (&q->paused));
+}
+
+int nn_dqueue_is_paused (struct nn_dqueue *q)
+{
+  return pa_ld32 (&q->paused) != 0;
 }
 
 void nn_dqueue_free (struct nn_dqueue *q)
@@ -2670,6 +2936,11 @@ void nn_dqueue_free (struct nn_dqueue *q)
      while.  It would be a shame to fail in free() due to a lack of
      heap space, would it not? */
   struct nn_dqueue_bubble b;
+  os_mutexLock (&q->lock);
+  q->stopping = 1;
+  if (pa_ld32 (&q->paused))
+    os_condSignal (&q->cond);
+  os_mutexUnlock (&q->lock);
   b.kind = NN_DQBK_STOP;
   nn_dqueue_enqueue_bubble (q, &b);
 
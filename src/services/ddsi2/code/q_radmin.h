@@ -47,6 +47,22 @@ struct nn_sequence_number_set;
 
 typedef int (*nn_dqueue_handler_t) (const struct nn_rsample_info *sampleinfo, const struct nn_rdata *fragchain, const struct nn_guid *rdguid, void *qarg);
 
+/* Delivery queue handlers return 0 once they are done with a sample,
+   or NN_DQUEUE_HANDLER_PAUSE if it can't be delivered yet: then the
+   sample stays at the head of the queue and the queue is paused (and
+   reports itself as full) until a retry of the handler succeeds.  The
+   pause covers the whole queue, and so all proxy writers delivering
+   through it, not just the one the sample came from: the handler only
+   pauses on a node-wide condition (shared memory running short), in
+   which the samples of the other writers can't be delivered either.
+
+   A handler may hold on to what it makes of the samples (say, to
+   deliver them in batches) until it is called with a null sampleinfo
+   and fragchain, which happens once the queue has worked its way
+   through what was queued at the time and before it processes a
+   bubble. */
+#define NN_DQUEUE_HANDLER_PAUSE 1
+
 struct nn_rmsg_chunk {
   struct nn_rbuf *rbuf;
   struct nn_rmsg_chunk *next;
@@ -240,6 +256,7 @@ void nn_dqueue_enqueue (struct nn_dqueue *q, struct nn_rsample_chain *sc, nn_reo
 void nn_dqueue_enqueue1 (struct nn_dqueue *q, const nn_guid_t *rdguid, struct nn_rsample_chain *sc, nn_reorder_result_t rres);
 void nn_dqueue_enqueue_callback (struct nn_dqueue *q, nn_dqueue_callback_t cb, void *arg);
 int  nn_dqueue_is_full (struct nn_dqueue *q);
+int  nn_dqueue_is_paused (struct nn_dqueue *q);
 
 #if defined (__cplusplus)
 }
@@ -73,6 +73,8 @@
 #include "q_static_assert.h"
 #include "q_init.h"
 
+#include "sd_cdr.h"
+
 #include "sysdeps.h"
 
 /*
@@ -1816,6 +1818,58 @@ static int defragment (unsigned char **datap, const struct nn_rdata *fragchain,
   }
 }
 
+static v_message deserialize_fragchain (const struct sertopic *topic, const struct nn_rdata *fragchain, os_uint32 sz)
+{
+  /* Deserializes straight from the fragments of the sample, rather
+     than copying them into a contiguous buffer first.  That requires
+     the CDR header to be in the first fragment and each fragment to
+     preserve the 4-byte alignment of the data, which is always the
+     case in practice, but if not, defragment it anyway. */
+  struct sd_cdrFragment fragsbuf[32], *frags;
+  const struct nn_rdata *fc;
+  unsigned nfrags = 0;
+  os_uint32 off = 0;
+  v_message vmsg;
+  if (fragchain->nextfrag == NULL)
+  {
+    const unsigned char *datap = NN_RMSG_PAYLOADOFF (fragchain->rmsg, NN_RDATA_PAYLOAD_OFF (fragchain));
+    return deserialize (topic, datap, sz);
+  }
+  for (fc = fragchain; fc; fc = fc->nextfrag)
+    nfrags++;
+  frags = (nfrags <= sizeof (fragsbuf) / sizeof (fragsbuf[0])) ? fragsbuf : os_malloc (nfrags * sizeof (*frags));
+  nfrags = 0;
+  for (fc = fragchain; fc; fc = fc->nextfrag)
+  {
+    assert (fc->min <= off);
+    assert (fc->maxp1 <= sz);
+    if (fc->maxp1 > off)
+    {
+      /* only include if this fragment adds data */
+      const unsigned char *payload = NN_RMSG_PAYLOADOFF (fc->rmsg, NN_RDATA_PAYLOAD_OFF (fc));
+      if (((os_address) payload - fc->min) % 4 != 0)
+        break;
+      frags[nfrags].data = payload + off - fc->min;
+      frags[nfrags].size = fc->maxp1 - off;
+      nfrags++;
+      off = fc->maxp1;
+    }
+  }
+  if (fc == NULL && frags[0].size >= sizeof (struct CDRHeader))
+    vmsg = deserialize_fragments (topic, nfrags, frags);
+  else
+  {
+    unsigned char *datap;
+    int needs_free;
+    needs_free = defragment (&datap, fragchain, sz);
+    vmsg = deserialize (topic, datap, sz);
+    if (needs_free) os_free (datap);
+  }
+  if (frags != fragsbuf)
+    os_free (frags);
+  return vmsg;
+}
+
 static v_message extract_vmsg_from_data
 (
   const struct nn_rsample_info *sampleinfo, unsigned char data_smhdr_flags,
@@ -1830,8 +1884,6 @@ static v_message extract_vmsg_from_data
   if (statusinfo == 0)
   {
     /* normal write */
-    unsigned char *datap;
-    int needs_free;
     if (!(data_smhdr_flags & DATA_FLAG_DATAFLAG) || sampleinfo->size == 0)
     {
       const struct proxy_writer *pwr = sampleinfo->pwr;
@@ -1847,31 +1899,28 @@ static v_message extract_vmsg_from_data
       return NULL;
     }
     failmsg = "data";
-    /* FIXME: defragment should be integrated into deserialize */
-    needs_free = defragment (&datap, fragchain, sampleinfo->size);
-    vmsg = deserialize (topic, datap, sampleinfo->size);
-    if (needs_free) os_free (datap);
+    vmsg = deserialize_fragchain (topic, fragchain, sampleinfo->size);
   }
   else if (sampleinfo->size)
   {
     /* dispose or unregister with included serialized key or data
      (data is a PrismTech extension) -- i.e., dispose or unregister
      as one would expect to receive */
-    unsigned char *datap;
-    int needs_free;
-    needs_free = defragment (&datap, fragchain, sampleinfo->size);
     if (data_smhdr_flags & DATA_FLAG_KEYFLAG)
     {
+      unsigned char *datap;
+      int needs_free;
       failmsg = "key";
+      needs_free = defragment (&datap, fragchain, sampleinfo->size);
       vmsg = deserialize_from_key (topic, datap, sampleinfo->size);
+      if (needs_free) os_free (datap);
     }
     else
     {
       failmsg = "data";
       assert (data_smhdr_flags & DATA_FLAG_DATAFLAG);
-      vmsg = deserialize (topic, datap, sampleinfo->size);
+      vmsg = deserialize_fragchain (topic, fragchain, sampleinfo->size);
     }
-    if (needs_free) os_free (datap);
   }
   else if (data_smhdr_flags & DATA_FLAG_INLINE_QOS)
   {
@@ -1902,6 +1951,11 @@ static v_message extract_vmsg_from_data
                  topic->name, topic->typename,
                  failmsg ? failmsg : "for reasons unknown");
   }
+  else if (topic->ospl_topic)
+  {
+    /* so the group and the readers need not hash the key again */
+    v_messageSetKeyHash (vmsg, topic->ospl_topic);
+  }
   return vmsg;
 }
 
@@ -1910,31 +1964,20 @@ struct do_groupwrite_arg {
   int reliable;
 };
 
-static int do_groupwrite (v_group g, void *varg)
+/* Decides what to do with the result rc of writing msg into g: returns
+   0 if done with it, retrying a rejected write for a while first if so
+   configured, and 1 if it was rejected. */
+static int groupwrite_result (v_group g, v_message msg, int reliable, v_writeResult rc, v_groupInstance *inst, v_resendScope *resendScope)
 {
-  /* Note that do_groupwrite is called by nn_groupset_foreach, which
-   accumulates the non-negative return values and aborts the foreach
-   on a negative one.  We return 0 on success and 1 on a reject:
-   that means a positive result from nn_groupset_foreach indicates a
-   rejection on some group.  There is little value in knowing which
-   group: even if we knew, we still don't know for which reader in
-   the group.
-
-   Native networking retries with resendScope = V_RESEND_NONE all
+  /* Native networking retries with resendScope = V_RESEND_NONE all
    the time, whereas we let v_groupWrite modify it. That at least
    potentially avoids some superfluous reader updates. */
-  int r;
-  v_resendScope resendScope = V_RESEND_NONE;
-  struct do_groupwrite_arg *arg = varg;
-  v_groupInstance inst = NULL;
-  v_writeResult rc;
-  rc = v_groupWriteCheckSampleLost (g, arg->msg, &inst, gv.myNetworkId, &resendScope);
   if (rc != V_WRITE_SUCCESS)
-    TRACE (("write-fail-%d-%x\n", (int) rc, (unsigned) resendScope));
-  if (rc != V_WRITE_REJECTED || !(arg->reliable || config.retry_on_reject_besteffort))
-    r = 0;
+    TRACE (("write-fail-%d-%x\n", (int) rc, (unsigned) *resendScope));
+  if (rc != V_WRITE_REJECTED || !(reliable || config.retry_on_reject_besteffort))
+    return 0;
   else if (config.retry_on_reject_duration.value == 0)
-    r = 1;
+    return 1;
   else
   {
     /* 1kHz repeat rate taken from native networking; "until" is
@@ -1946,14 +1989,149 @@ static int do_groupwrite (v_group g, void *varg)
       thread_state_blocked (lookup_thread_state ());
       os_sleep (sleep);
       thread_state_unblocked (lookup_thread_state ());
-      rc = v_groupResend (g, arg->msg, &inst, &resendScope, gv.myNetworkId);
+      rc = v_groupResend (g, msg, inst, resendScope, gv.myNetworkId);
     } while (rc == V_WRITE_REJECTED && now_mt ().v < until.v && !gv.terminate);
-    r = (rc == V_WRITE_REJECTED) ? 1 : 0;
+    return (rc == V_WRITE_REJECTED) ? 1 : 0;
   }
+}
+
+static int do_groupwrite (v_group g, void *varg)
+{
+  /* Note that do_groupwrite is called by nn_groupset_foreach, which
+   accumulates the non-negative return values and aborts the foreach
+   on a negative one.  We return 0 on success and 1 on a reject:
+   that means a positive result from nn_groupset_foreach indicates a
+   rejection on some group.  There is little value in knowing which
+   group: even if we knew, we still don't know for which reader in
+   the group. */
+  int r;
+  v_resendScope resendScope = V_RESEND_NONE;
+  struct do_groupwrite_arg *arg = varg;
+  v_groupInstance inst = NULL;
+  v_writeResult rc;
+  rc = v_groupWriteCheckSampleLost (g, arg->msg, &inst, gv.myNetworkId, &resendScope);
+  r = groupwrite_result (g, arg->msg, arg->reliable, rc, &inst, &resendScope);
   c_free(inst);
   return r;
 }
 
+/* Samples drained from a delivery queue are handed to the kernel in
+   batches of consecutive samples of a single proxy writer, so that each
+   group gets locked, and each reader triggered, once per batch rather
+   than once per sample. */
+#define DELIVER_BATCH_MAX 32
+
+struct deliver_batch {
+  struct proxy_writer *pwr;
+  unsigned n;
+  v_message msgs[DELIVER_BATCH_MAX];
+  os_int64 seqs[DELIVER_BATCH_MAX];
+  unsigned char rejected[DELIVER_BATCH_MAX];
+};
+
+struct do_groupwrite_batch_arg {
+  struct deliver_batch *batch;
+  int reliable;
+};
+
+static int do_groupwrite_batch (v_group g, void *varg)
+{
+  /* Like do_groupwrite, but the rejections are recorded per sample in
+     the batch, as a rejected sample doesn't stop the later ones from
+     being written */
+  struct do_groupwrite_batch_arg *arg = varg;
+  struct deliver_batch *b = arg->batch;
+  c_ulong i = 0;
+  while (i < b->n)
+  {
+    v_resendScope resendScope = V_RESEND_NONE;
+    v_groupInstance inst = NULL;
+    v_writeResult rc;
+    i += v_groupWriteCheckSampleLostBatch (g, &b->msgs[i], b->n - i, gv.myNetworkId, &rc, &inst, &resendScope);
+    if (i < b->n)
+    {
+      if (groupwrite_result (g, b->msgs[i], arg->reliable, rc, &inst, &resendScope))
+        b->rejected[i] = 1;
+      c_free (inst);
+      i++;
+    }
+  }
+  return 0;
+}
+
+static void deliver_batch_init (struct deliver_batch *b)
+{
+  b->pwr = NULL;
+  b->n = 0;
+}
+
+struct deliver_batch *deliver_batch_new (void)
+{
+  struct deliver_batch *b = os_malloc (sizeof (*b));
+  deliver_batch_init (b);
+  return b;
+}
+
+void deliver_batch_free (struct deliver_batch *b)
+{
+  assert (b->n == 0);
+  os_free (b);
+}
+
+static void deliver_batch_flush (struct deliver_batch *b)
+{
+  struct proxy_writer * const pwr = b->pwr;
+  struct do_groupwrite_batch_arg arg;
+  unsigned i;
+  if (b->n == 0)
+    return;
+  memset (b->rejected, 0, b->n);
+  if (b->n == 1)
+  {
+    /* Nothing to batch: the per-sample path hands the sample itself to
+       the readers' triggers */
+    struct do_groupwrite_arg warg;
+    warg.msg = b->msgs[0];
+    warg.reliable = (pwr->n_reliable_readers > 0);
+    if (nn_groupset_foreach (pwr->groups, do_groupwrite, &warg) != 0)
+      b->rejected[0] = 1;
+  }
+  else
+  {
+    arg.batch = b;
+    arg.reliable = (pwr->n_reliable_readers > 0);
+    (void) nn_groupset_foreach (pwr->groups, do_groupwrite_batch, &arg);
+  }
+  for (i = 0; i < b->n; i++)
+  {
+    if (!b->rejected[i])
+      pa_st32 (&pwr->next_deliv_seq_lowword, (os_uint32) (b->seqs[i] + 1));
+    else if (config.late_ack_mode)
+      TRACE (("batch %"PA_PRId64" rejected\n", b->seqs[i]));
+    else
+    {
+      /* see deliver_user_data */
+      NN_WARNING2 ("incomplete delivery of writer %x:%x:%x:%x sample %"PA_PRId64"\n",
+                   PGUID (pwr->e.guid), b->seqs[i]);
+      pa_st32 (&pwr->next_deliv_seq_lowword, (os_uint32) (b->seqs[i] + 1));
+    }
+    c_free (b->msgs[i]);
+  }
+  b->pwr = NULL;
+  b->n = 0;
+}
+
+static void deliver_batch_add (struct deliver_batch *b, struct proxy_writer *pwr, v_message msg, os_int64 seq)
+{
+  if (b->n > 0 && b->pwr != pwr)
+    deliver_batch_flush (b);
+  b->pwr = pwr;
+  b->msgs[b->n] = c_keep (msg);
+  b->seqs[b->n] = seq;
+  if (++b->n == DELIVER_BATCH_MAX)
+    deliver_batch_flush (b);
+}
+
 static void set_vmsg_header (const struct proxy_writer *pwr, v_message vmsg, const struct nn_prismtech_writer_info *wri, nn_ddsi_time_t timestamp, os_int64 seq, unsigned statusinfo, int have_data)
 {
   nn_wctime_t tstamp;
@@ -2213,59 +2391,42 @@ static void get_writer_info (nn_prismtech_writer_info_t *wri, struct proxy_write
     os_mutexUnlock (&pwr->e.lock);
 }
 
-static int wait_for_memory_threshold (c_base base)
+static void warn_memory_threshold (void)
 {
-  if (c_baseGetMemThresholdStatus (base) == C_MEMTHRESHOLD_OK)
-    return 1;
+  os_uint32 last_threshold_warning_sec = pa_ld32 (&gv.last_threshold_warning_sec);
+  const os_timeM tnowM = os_timeMGet ();
+  do {
+    if (OS_TIMEM_GET_SECONDS(tnowM) < (last_threshold_warning_sec + 10))
+      return;
+  } while (!pa_cas32 (&gv.last_threshold_warning_sec, last_threshold_warning_sec, (os_uint32) OS_TIMEM_GET_SECONDS(tnowM)));
+  NN_WARNING1 ("Shared memory usage has reached threshold, pausing delivery of reliable data until the situation improves (already dropped %"PA_PRIu32" unreliable samples because of shared memory exhaustion).\n", pa_ld32 (&gv.memory_shortage_dropcount));
+}
 
+static void resume_acknacks (const struct nn_dqueue *dqueue)
+{
+  /* Delivery through DQUEUE resumes after a memory shortage: have the
+     readers of the proxy writers delivering through it request the
+     samples rejected in the meantime right away, rather than waiting
+     for the next heartbeat. */
+  struct ephash_enum_proxy_writer est;
+  struct proxy_writer *pwr;
+  const nn_mtime_t tnow = now_mt ();
+  ephash_enum_proxy_writer_init (&est);
+  while ((pwr = ephash_enum_proxy_writer_next (&est)) != NULL)
   {
-    const os_duration reltimeout = OS_DURATION_INIT(0, 500000000);
-    const os_timeM tnowM = os_timeMGet();
-    const os_timeM abstimeout = os_timeMAdd (tnowM, reltimeout);
-    int print_drop_count = 1;
-
-    TRACE (("shmem threshold reached"));
-
-    {
-      os_uint32 last_threshold_warning_sec = pa_ld32 (&gv.last_threshold_warning_sec);
-      do {
-        if (OS_TIMEM_GET_SECONDS(tnowM) < (last_threshold_warning_sec + 10))
-        {
-          print_drop_count = 0;
-          break;
-        }
-      } while (!pa_cas32 (&gv.last_threshold_warning_sec, last_threshold_warning_sec, (os_uint32) OS_TIMEM_GET_SECONDS(tnowM)));
-    }
-
-    if (print_drop_count)
-    {
-      os_uint32 n = pa_ld32 (&gv.memory_shortage_dropcount);
-      NN_WARNING2 ("Shared memory usage has reached threshold, waiting up to %"PA_PRIduration" seconds for the situation to improve (already dropped %"PA_PRIu32" samples because of shared memory exhaustion).\n", OS_DURATION_PRINT(reltimeout), n);
-    }
-
-    do {
-      const os_duration shortdelay = OS_DURATION_INIT(0, 10000000);
-      thread_state_blocked (lookup_thread_state ());
-      os_sleep (shortdelay);
-      thread_state_unblocked (lookup_thread_state ());
-    } while (c_baseGetMemThresholdStatus (base) != C_MEMTHRESHOLD_OK && os_timeMCompare (os_timeMGet(), abstimeout) == OS_LESS);
-
-    if (c_baseGetMemThresholdStatus (base) == C_MEMTHRESHOLD_OK)
-    {
-      os_uint32 n = pa_ld32 (&gv.memory_shortage_dropcount);
-      TRACE ((" - delivering (%"PA_PRIu32")\n", n));
-      return 1;
-    }
-    else
-    {
-      os_uint32 n = pa_inc32_nv (&gv.memory_shortage_dropcount);
-      TRACE ((" - dropping (%"PA_PRIu32")\n", n));
-      return 0;
-    }
+    struct pwr_rd_match *m;
+    if (pwr->dqueue != dqueue)
+      continue;
+    os_mutexLock (&pwr->e.lock);
+    for (m = ut_avlFindMin (&pwr_readers_treedef, &pwr->readers); m; m = ut_avlFindSucc (&pwr_readers_treedef, &pwr->readers, m))
+      if (m->acknack_xevent)
+        (void) resched_xevent_if_earlier (m->acknack_xevent, tnow);
+    os_mutexUnlock (&pwr->e.lock);
   }
+  ephash_enum_proxy_writer_fini (&est);
 }
 
-static int deliver_user_data (const struct nn_rsample_info *sampleinfo, const struct nn_rdata *fragchain, const nn_guid_t *rdguid, int pwr_locked)
+static int deliver_user_data (const struct nn_rsample_info *sampleinfo, const struct nn_rdata *fragchain, const nn_guid_t *rdguid, int pwr_locked, struct deliver_batch *batch)
 {
   struct receiver_state const * const rst = sampleinfo->rst;
   struct proxy_writer * const pwr = sampleinfo->pwr;
@@ -2285,8 +2446,36 @@ static int deliver_user_data (const struct nn_rsample_info *sampleinfo, const st
      pwr->groupset takes care of itself.  FIXME: groupset may be
      taking care of itself, but it is currently doing so in an
      annoyingly simplistic manner ...  */
-  if (!wait_for_memory_threshold (gv.ospl_base))
-    return 0;
+  if (batch != NULL && batch->pwr != pwr)
+    deliver_batch_flush (batch);
+  if (c_baseGetMemThresholdStatus (gv.ospl_base) != C_MEMTHRESHOLD_OK)
+  {
+    /* Reliable data gets back-pressure: the delivery queue pauses
+       until memory becomes available, and in the meantime fills up,
+       causing the reorder admin to reject new samples, stopping
+       acknowledgements and so throttling the writers.  Synchronous
+       delivery can't pause (that is prevented upstream for reliable
+       data) and unreliable data is simply dropped. */
+    warn_memory_threshold ();
+    if (!pwr_locked && pwr->n_reliable_readers > 0)
+    {
+      TRACE (("shmem threshold reached: pausing delivery\n"));
+      if (batch != NULL)
+        deliver_batch_flush (batch);
+      return NN_DQUEUE_HANDLER_PAUSE;
+    }
+    else
+    {
+      os_uint32 n = pa_inc32_nv (&gv.memory_shortage_dropcount);
+      TRACE (("shmem threshold reached: dropping (%"PA_PRIu32")\n", n));
+      return 0;
+    }
+  }
+  else if (!pwr_locked && nn_dqueue_is_paused (pwr->dqueue))
+  {
+    TRACE (("shmem threshold cleared: resuming delivery\n"));
+    resume_acknacks (pwr->dqueue);
+  }
 
   /* FIXME: fragments are now handled by copying the message to
      freshly malloced memory (see defragment()) ... that'll have to
@@ -2420,20 +2609,25 @@ static int deliver_user_data (const struct nn_rsample_info *sampleinfo, const st
 
     TRACE ((" %"PA_PRId64"(%p)=>%p\n", sampleinfo->seq, (void *) fragchain, (void *) pwr->groups));
 
-    arg.msg = payload;
-    arg.reliable = (pwr->n_reliable_readers > 0);
-    if (nn_groupset_foreach (pwr->groups, do_groupwrite, &arg) == 0)
-      pa_st32 (&pwr->next_deliv_seq_lowword, (os_uint32) (sampleinfo->seq + 1));
-    else if (config.late_ack_mode)
-      TRACE ((" rejected\n"));
+    if (batch != NULL && !iscoherent)
+      deliver_batch_add (batch, pwr, payload, sampleinfo->seq);
     else
     {
-      /* "early" ack mode and a rejection means the sample will never
-       be delivered; updating next_deliv_seq_lowword in this case is
-       a formality because it is irrelevant in this mode. */
-      NN_WARNING2 ("incomplete delivery of writer %x:%x:%x:%x sample %"PA_PRId64"\n",
-                   PGUID (pwr->e.guid), sampleinfo->seq);
-      pa_st32 (&pwr->next_deliv_seq_lowword, (os_uint32) (sampleinfo->seq + 1));
+      arg.msg = payload;
+      arg.reliable = (pwr->n_reliable_readers > 0);
+      if (nn_groupset_foreach (pwr->groups, do_groupwrite, &arg) == 0)
+        pa_st32 (&pwr->next_deliv_seq_lowword, (os_uint32) (sampleinfo->seq + 1));
+      else if (config.late_ack_mode)
+        TRACE ((" rejected\n"));
+      else
+      {
+        /* "early" ack mode and a rejection means the sample will never
+         be delivered; updating next_deliv_seq_lowword in this case is
+         a formality because it is irrelevant in this mode. */
+        NN_WARNING2 ("incomplete delivery of writer %x:%x:%x:%x sample %"PA_PRId64"\n",
+                     PGUID (pwr->e.guid), sampleinfo->seq);
+        pa_st32 (&pwr->next_deliv_seq_lowword, (os_uint32) (sampleinfo->seq + 1));
+      }
     }
   }
   c_free (payload);
@@ -2442,15 +2636,23 @@ static int deliver_user_data (const struct nn_rsample_info *sampleinfo, const st
   return 0;
 }
 
-int user_dqueue_handler (const struct nn_rsample_info *sampleinfo, const struct nn_rdata *fragchain, const nn_guid_t *rdguid, UNUSED_ARG (void *qarg))
+int user_dqueue_handler (const struct nn_rsample_info *sampleinfo, const struct nn_rdata *fragchain, const nn_guid_t *rdguid, void *qarg)
 {
+  struct deliver_batch *batch = qarg;
   int res;
-  res = deliver_user_data (sampleinfo, fragchain, rdguid, 0);
+  if (sampleinfo == NULL)
+  {
+    deliver_batch_flush (batch);
+    return 0;
+  }
+  res = deliver_user_data (sampleinfo, fragchain, rdguid, 0, batch);
   return res;
 }
 
 static void deliver_user_data_synchronously (struct nn_rsample_chain *sc)
 {
+  struct deliver_batch batch;
+  deliver_batch_init (&batch);
   while (sc->first)
   {
     struct nn_rsample_chain_elem *e = sc->first;
@@ -2461,10 +2663,11 @@ static void deliver_user_data_synchronously (struct nn_rsample_chain *sc)
          sample_lost events. Also note that the synchronous path is
          _never_ used for historical data, and therefore never has the
          GUID of a reader to deliver to */
-      deliver_user_data (e->sampleinfo, e->fragchain, NULL, 1);
+      deliver_user_data (e->sampleinfo, e->fragchain, NULL, 1, &batch);
     }
     nn_fragchain_unref (e->fragchain);
   }
+  deliver_batch_flush (&batch);
 }
 
 static void clean_defrag (struct proxy_writer *pwr)
@@ -2542,8 +2745,17 @@ static void handle_regular (struct receiver_state *rst, nn_etime_t tnow, struct
     struct nn_rsample_chain sc;
     struct nn_rdata *fragchain = nn_rsample_fragchain (rsample);
     nn_reorder_result_t rres;
-
-    rres = nn_reorder_rsample (&sc, pwr->reorder, rsample, &refc_adjust, nn_dqueue_is_full (pwr->dqueue));
+    int delivery_queue_full_p;
+
+    /* Synchronous delivery can't wait for shared memory to become
+       available, so reject reliable data upfront when it is scarce,
+       leaving it to the writer to retransmit it later */
+    if (pwr->deliver_synchronously && pwr->n_reliable_readers > 0 &&
+        c_baseGetMemThresholdStatus (gv.ospl_base) != C_MEMTHRESHOLD_OK)
+      delivery_queue_full_p = 1;
+    else
+      delivery_queue_full_p = nn_dqueue_is_full (pwr->dqueue);
+    rres = nn_reorder_rsample (&sc, pwr->reorder, rsample, &refc_adjust, delivery_queue_full_p);
 
     if (rres == NN_REORDER_ACCEPT && pwr->n_reliable_readers == 0)
     {
@@ -2593,7 +2805,7 @@ static void handle_regular (struct receiver_state *rst, nn_etime_t tnow, struct
           continue;
         if (!reuse_rsample_dup)
           rsample_dup = nn_reorder_rsample_dup (rmsg, rsample);
-        rres2 = nn_reorder_rsample (&sc, wn->u.not_in_sync.reorder, rsample_dup, &refc_adjust, nn_dqueue_is_full (pwr->dqueue));
+        rres2 = nn_reorder_rsample (&sc, wn->u.not_in_sync.reorder, rsample_dup, &refc_adjust, delivery_queue_full_p);
         switch (rres2)
         {
           case NN_REORDER_TOO_OLD:
@@ -3522,9 +3734,11 @@ void * listen_thread (struct ddsi_tran_listener * listener)
   return NULL;
 }
 
-void * recv_thread (struct nn_rbufpool * rbpool)
+void * recv_thread (struct recv_thread_arg *arg)
 {
   struct thread_state1 *self = lookup_thread_state ();
+  struct nn_rbufpool *rbpool = arg->rbpool;
+  os_sockWaitset waitset = arg->waitset;
   struct local_participant_set lps;
   unsigned num_fixed = 0;
   nn_mtime_t next_thread_cputime = { 0 };
@@ -3534,23 +3748,29 @@ void * recv_thread (struct nn_rbufpool * rbpool)
   local_participant_set_init (&lps);
   nn_rbufpool_setowner (rbpool, os_threadIdSelf ());
 
-  if (gv.m_factory->m_connless)
+  if (arg->conn)
+  {
+    /* additional receive thread: just its own share of the unicast data */
+    os_sockWaitsetAdd (waitset, arg->conn);
+    num_fixed = 1;
+  }
+  else if (gv.m_factory->m_connless)
   {
     if (config.many_sockets_mode == MSM_NO_UNICAST)
     {
       /* we only have one - disc, data, uc and mc all alias each other */
-      os_sockWaitsetAdd (gv.waitset, gv.disc_conn_uc);
+      os_sockWaitsetAdd (waitset, gv.disc_conn_uc);
       num_fixed = 1;
     }
     else
     {
-      os_sockWaitsetAdd (gv.waitset, gv.disc_conn_uc);
-      os_sockWaitsetAdd (gv.waitset, gv.data_conn_uc);
+      os_sockWaitsetAdd (waitset, gv.disc_conn_uc);
+      os_sockWaitsetAdd (waitset, gv.data_conn_uc);
       num_fixed = 1 + (gv.disc_conn_uc != gv.data_conn_uc);
       if (config.allowMulticast)
       {
-        os_sockWaitsetAdd (gv.waitset, gv.disc_conn_mc);
-        os_sockWaitsetAdd (gv.waitset, gv.data_conn_mc);
+        os_sockWaitsetAdd (waitset, gv.disc_conn_mc);
+        os_sockWaitsetAdd (waitset, gv.data_conn_mc);
         num_fixed += 2;
     }
     }
@@ -3560,22 +3780,22 @@ void * recv_thread (struct nn_rbufpool * rbpool)
   {
     LOG_THREAD_CPUTIME (next_thread_cputime);
 
-    if (pa_ld32 (&gv.participant_set_generation) != lps.gen && config.many_sockets_mode == MSM_MANY_UNICAST)
+    if (arg->conn == NULL && pa_ld32 (&gv.participant_set_generation) != lps.gen && config.many_sockets_mode == MSM_MANY_UNICAST)
     {
       /* first rebuild local participant set - unless someone's toggling "deafness", this
          only happens when the participant set has changed, so might as well rebuild it */
       rebuild_local_participant_set (self, &lps);
-      os_sockWaitsetPurge (gv.waitset, num_fixed);
+      os_sockWaitsetPurge (waitset, num_fixed);
       for (i = 0; i < lps.nps; i++)
       {
         if (lps.ps[i].m_conn)
         {
-          os_sockWaitsetAdd (gv.waitset, lps.ps[i].m_conn);
+          os_sockWaitsetAdd (waitset, lps.ps[i].m_conn);
         }
       }
     }
 
-    ctx = os_sockWaitsetWait (gv.waitset);
+    ctx = os_sockWaitsetWait (waitset);
     if (ctx)
     {
       int idx;
@@ -3583,21 +3803,31 @@ void * recv_thread (struct nn_rbufpool * rbpool)
 
       while ((idx = os_sockWaitsetNextEvent (ctx, &conn)) >= 0)
       {
+        const nn_guid_prefix_t *guid_prefix;
         c_bool ret;
         if (((unsigned)idx < num_fixed) || config.many_sockets_mode != MSM_MANY_UNICAST)
         {
-          ret = do_packet (self, conn, NULL, rbpool);
+          guid_prefix = NULL;
         }
         else
         {
-          ret = do_packet (self, conn, &lps.ps[(unsigned)idx - num_fixed].guid_prefix, rbpool);
+          guid_prefix = &lps.ps[(unsigned)idx - num_fixed].guid_prefix;
+        }
+        ret = do_packet (self, conn, guid_prefix, rbpool);
+
+        /* Process packets already buffered by the transport (e.g., the
+           remainder of a packet ring block) without waiting again */
+
+        while (ret && ddsi_conn_pending (conn))
+        {
+          ret = do_packet (self, conn, guid_prefix, rbpool);
         }
 
         /* Clean out connection if failed or closed */
 
         if (! ret && ! conn->m_connless)
         {
-          os_sockWaitsetRemove (gv.waitset, conn);
+          os_sockWaitsetRemove (waitset, conn);
           ddsi_conn_free (conn);
         }
       }
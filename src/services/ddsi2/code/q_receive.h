@@ -28,11 +28,30 @@ struct nn_rbufpool;
 struct nn_rsample_info;
 struct nn_rdata;
 struct ddsi_tran_listener;
+struct ddsi_tran_conn;
+struct os_sockWaitset;
+struct thread_state1;
+struct deliver_batch;
 
-void *recv_thread (struct nn_rbufpool *rbpool);
+/* Each receive thread owns a buffer pool and a waitset. The primary
+   one (conn == NULL) serves all shared sockets; any additional ones
+   serve just the unicast data socket given in conn. */
+struct recv_thread_arg {
+  struct thread_state1 *ts;
+  struct nn_rbufpool *rbpool;
+  struct os_sockWaitset *waitset;
+  struct ddsi_tran_conn *conn;
+};
+
+void *recv_thread (struct recv_thread_arg *arg);
 void *listen_thread (struct ddsi_tran_listener * listener);
 int user_dqueue_handler (const struct nn_rsample_info *sampleinfo, const struct nn_rdata *fragchain, const nn_guid_t *rdguid, void *qarg);
 
+/* Argument for user_dqueue_handler, in which it accumulates samples to
+   be delivered together */
+struct deliver_batch *deliver_batch_new (void);
+void deliver_batch_free (struct deliver_batch *b);
+
 #if defined (__cplusplus)
 }
 #endif
@@ -350,6 +350,7 @@ struct os_sockWaitsetCtx
   os_sockWaitsetSet set;     /* set of connections and descriptors */
   unsigned index;            /* cursor for enumerating */
   fd_set rdset;              /* read file descriptors */
+  fd_set wrset;              /* write file descriptors (queued output) */
 };
 
 struct os_sockWaitset
@@ -373,6 +374,7 @@ static void os_sockWaitsetNewCtx (os_sockWaitsetCtx ctx)
 {
   os_sockWaitsetNewSet (&ctx->set);
   FD_ZERO (&ctx->rdset);
+  FD_ZERO (&ctx->wrset);
 }
 
 os_sockWaitset os_sockWaitsetNew (void)
@@ -581,6 +583,7 @@ os_sockWaitsetCtx os_sockWaitsetWait (os_sockWaitset ws)
   int err;
   int fdmax;
   fd_set * rdset = NULL;
+  fd_set * wrset = NULL;
   os_sockWaitsetCtx ctx = &ws->ctx;
   os_sockWaitsetSet * dst = &ctx->set;
   os_sockWaitsetSet * src = &ws->set;
@@ -605,18 +608,25 @@ os_sockWaitsetCtx os_sockWaitsetWait (os_sockWaitset ws)
 
   os_mutexUnlock (&ws->mutex);
 
-  /* Copy file descriptors into select read set */
+  /* Copy file descriptors into select read set, connections with queued
+     output are also watched for writability */
 
   rdset = &ctx->rdset;
   FD_ZERO (rdset);
+  FD_ZERO (&ctx->wrset);
   for (u = 0; u < dst->n; u++)
   {
     FD_SET (dst->fds[u], rdset);
+    if (u > 0 && ddsi_conn_write_pending (dst->conns[u]))
+    {
+      FD_SET (dst->fds[u], &ctx->wrset);
+      wrset = &ctx->wrset;
+    }
   }
 
   do
   {
-    n = select (fdmax, rdset, NULL, NULL, NULL);
+    n = select (fdmax, rdset, wrset, NULL, NULL);
     if (n < 0)
     {
       err = os_getErrno ();
@@ -631,6 +641,18 @@ os_sockWaitsetCtx os_sockWaitsetWait (os_sockWaitset ws)
 
   if (n > 0)
   {
+    /* Drain queued output before the read events are enumerated */
+    if (wrset)
+    {
+      for (u = 1; u < dst->n; u++)
+      {
+        if (FD_ISSET (dst->fds[u], wrset))
+        {
+          ddsi_conn_flush (dst->conns[u]);
+        }
+      }
+    }
+
     /* this simply skips the trigger fd */
     ctx->index = 1;
     if (FD_ISSET (dst->fds[0], rdset))
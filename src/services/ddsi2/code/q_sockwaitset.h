@@ -84,6 +84,11 @@ void os_sockWaitsetPurge (os_sockWaitset ws, unsigned index);
 /*
   Waits until some of the connections in WS have data to be read.
 
+  Connections reporting queued output (ddsi_conn_write_pending) are also
+  waited on for writability and flushed (ddsi_conn_flush) from within this
+  call once writable; only read events are returned in the context. The
+  WinCE implementation does not support this.
+
   Returns a new wait set context if one or more connections have data to read.
   However, the return may be spurious (NULL) (i.e., no events)
 
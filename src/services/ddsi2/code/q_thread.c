@@ -235,6 +235,10 @@ struct thread_state1 *create_thread (const char *name, void * (*f) (void *arg),
     tattr.schedClass = tprops->sched_class; /* explicit default value in the enum */
     if (!tprops->stack_size.isdefault)
       tattr.stackSize = tprops->stack_size.value;
+    /* both validated when the configuration was read */
+    (void) os_threadAttrSetCpuAffinity (&tattr, tprops->cpu_affinity);
+    (void) os_threadAttrSetMemPolicy (&tattr, tprops->memory_policy);
+    TRACE (("create_thread: %s: affinity %s memory policy %s\n", name, tprops->cpu_affinity, tprops->memory_policy));
   }
   TRACE (("create_thread: %s: class %d priority %d stack %u\n", name, (int) tattr.schedClass, tattr.schedPriority, tattr.stackSize));
   if (u_serviceThreadCreate (&tid, name, &tattr, (void * (*) (void *)) create_thread_wrapper, ctxt) != os_resultSuccess)
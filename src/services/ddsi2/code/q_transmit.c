@@ -104,16 +104,20 @@ os_int64 writer_hbcontrol_intv (const struct writer *wr, UNUSED_ARG (nn_mtime_t
 {
   struct hbcontrol const * const hbc = &wr->hbcontrol;
   os_int64 ret = const_hb_intv_sched;
-  os_size_t n_unacked;
-
-  if (hbc->hbs_since_last_write > 2)
+  os_size_t n_unacked = whc_unacked_bytes (wr->whc);
+  unsigned cnt = hbc->hbs_since_last_write;
+
+  /* Back off after a few heartbeats without new data.  With nothing
+     left unacknowledged, heartbeats only serve readers that have yet
+     to respond to one, and the back off starts right away. */
+  if (n_unacked == 0)
+    cnt += 2;
+  if (cnt > 2)
   {
-    unsigned cnt = hbc->hbs_since_last_write;
     while (cnt-- > 2 && 2 * ret < const_hb_intv_sched_max)
       ret *= 2;
   }
 
-  n_unacked = whc_unacked_bytes (wr->whc);
   if (n_unacked >= wr->whc_low + 3 * (wr->whc_high - wr->whc_low) / 4)
     ret /= 2;
   if (n_unacked >= wr->whc_low + (wr->whc_high - wr->whc_low) / 2)
@@ -167,6 +167,13 @@ struct xeventq {
   os_cond cond;
   ddsi_tran_conn_t tev_conn;
   os_uint32 auxiliary_bandwidth_limit;
+
+  /* Heartbeats and AckNacks generated by the event thread in a cycle
+     of the event queue, added to the packet grouped by destination at
+     the end of the cycle (only with ControlCoalescingDelay set) */
+  struct nn_xmsg **ctrlmsgs;
+  unsigned n_ctrlmsgs;
+  unsigned max_ctrlmsgs;
 };
 
 static void *xevent_thread (struct xeventq *xevq);
@@ -374,10 +381,22 @@ void delete_xevent (struct xevent *ev)
   os_mutexUnlock (&evq->lock);
 }
 
+static nn_mtime_t coalesce_tsched (enum xeventkind kind, nn_mtime_t tsched)
+{
+  /* Heartbeats and AckNacks are scheduled on a shared grid, so that
+     the ones that fall due at about the same time are handled in the
+     same cycle of the event queue and can share packets */
+  if ((kind == XEVK_HEARTBEAT || kind == XEVK_ACKNACK) && config.control_coalescing_delay != 0)
+    return mtime_round_up (tsched, config.control_coalescing_delay);
+  else
+    return tsched;
+}
+
 int resched_xevent_if_earlier (struct xevent *ev, nn_mtime_t tsched)
 {
   struct xeventq *evq = ev->evq;
   int is_resched;
+  tsched = coalesce_tsched (ev->kind, tsched);
   os_mutexLock (&evq->lock);
   assert (tsched.v != TSCHED_DELETE);
   /* If you want to delete it, you to say so by calling the right
@@ -425,6 +444,7 @@ static struct xevent * qxev_common (struct xeventq *evq, nn_mtime_t tsched, enum
     TRACE (("rounded event scheduled for %"PA_PRId64" to %"PA_PRId64"\n", tsched.v, tsched_rounded.v));
     tsched = tsched_rounded;
   }
+  tsched = coalesce_tsched (kind, tsched);
 
   ev->evq = evq;
   ev->tsched = tsched;
@@ -507,6 +527,9 @@ struct xeventq * xeventq_new
   evq->queued_rexmit_bytes = 0;
   evq->queued_rexmit_msgs = 0;
   evq->tev_conn = conn;
+  evq->ctrlmsgs = NULL;
+  evq->n_ctrlmsgs = 0;
+  evq->max_ctrlmsgs = 0;
   os_mutexInit (&evq->lock, NULL);
   os_condInit (&evq->cond, &evq->lock, NULL);
   return evq;
@@ -569,6 +592,8 @@ void xeventq_free (struct xeventq *evq)
   while (!non_timed_xmit_list_is_empty(evq))
     free_xevent_nt (evq, getnext_from_non_timed_xmit_list (evq));
   assert (ut_avlIsEmpty (&evq->msg_xevents));
+  assert (evq->n_ctrlmsgs == 0);
+  os_free (evq->ctrlmsgs);
   os_condDestroy (&evq->cond);
   os_mutexDestroy (&evq->lock);
   os_free (evq);
@@ -576,6 +601,41 @@ void xeventq_free (struct xeventq *evq)
 
 /* EVENT QUEUE EVENT HANDLERS ******************************************************/
 
+static void add_ctrlmsg (struct xeventq *evq, struct nn_xpack *xp, struct nn_xmsg *msg)
+{
+  /* Only ever called from the event thread, without evq->lock held */
+  if (config.control_coalescing_delay == 0)
+    nn_xpack_addmsg (xp, msg, 0);
+  else
+  {
+    if (evq->n_ctrlmsgs == evq->max_ctrlmsgs)
+    {
+      evq->max_ctrlmsgs = (evq->max_ctrlmsgs == 0) ? 16 : 2 * evq->max_ctrlmsgs;
+      evq->ctrlmsgs = os_realloc (evq->ctrlmsgs, evq->max_ctrlmsgs * sizeof (*evq->ctrlmsgs));
+    }
+    evq->ctrlmsgs[evq->n_ctrlmsgs++] = msg;
+  }
+}
+
+static int compare_ctrlmsg (const void *va, const void *vb)
+{
+  struct nn_xmsg * const *a = va;
+  struct nn_xmsg * const *b = vb;
+  return nn_xmsg_compare_dst (*a, *b);
+}
+
+static void flush_ctrlmsgs (struct xeventq *evq, struct nn_xpack *xp)
+{
+  unsigned i;
+  if (evq->n_ctrlmsgs > 1)
+    qsort (evq->ctrlmsgs, evq->n_ctrlmsgs, sizeof (*evq->ctrlmsgs), compare_ctrlmsg);
+  for (i = 0; i < evq->n_ctrlmsgs; i++)
+    nn_xpack_addmsg (xp, evq->ctrlmsgs[i], 0);
+  if (evq->n_ctrlmsgs > 0)
+    TRACE (("xevent: %u heartbeats/acknacks coalesced\n", evq->n_ctrlmsgs));
+  evq->n_ctrlmsgs = 0;
+}
+
 static void handle_xevk_msg (struct nn_xpack *xp, struct xevent_nt *ev)
 {
   assert (!nontimed_xevent_in_queue (ev->evq, ev));
@@ -657,7 +717,7 @@ static void handle_xevk_heartbeat (struct nn_xpack *xp, struct xevent *ev, nn_mt
      and we certainly don't want to hold the lock during that time. */
   if (msg)
   {
-    nn_xpack_addmsg (xp, msg, 0);
+    add_ctrlmsg (ev->evq, xp, msg);
   }
 }
 
@@ -749,6 +809,12 @@ static void add_AckNack (struct nn_xmsg *msg, struct proxy_writer *pwr, struct p
       if (nn_dqueue_is_full (pwr->dqueue))
         notail = 1;
     }
+    /* While short of shared memory, acknowledge only what has been
+       accepted without requesting (re)transmission of data that would
+       be rejected anyway; once delivery resumes, the readers will
+       nack it deliberately */
+    if (c_baseGetMemThresholdStatus (gv.ospl_base) != C_MEMTHRESHOLD_OK)
+      notail = 1;
   }
   else
   {
@@ -954,7 +1020,7 @@ static void handle_xevk_acknack (UNUSED_ARG (struct nn_xpack *xp), struct xevent
   /* nn_xpack_addmsg may sleep (for bandwidth-limited channels), so
      must be outside the lock */
   if (msg)
-    nn_xpack_addmsg (xp, msg, 0);
+    add_ctrlmsg (ev->evq, xp, msg);
   return;
 
  outofmem:
@@ -1353,6 +1419,7 @@ static void * xevent_thread (struct xeventq * xevq)
     /* Send to the network unlocked, as it may sleep due to bandwidth
        limitation */
     os_mutexUnlock (&xevq->lock);
+    flush_ctrlmsgs (xevq, xp);
     nn_xpack_send (xp);
     os_mutexLock (&xevq->lock);
 
@@ -436,6 +436,35 @@ int nn_xmsg_compare_fragid (const struct nn_xmsg *a, const struct nn_xmsg *b)
     return 0;
 }
 
+int nn_xmsg_compare_dst (const struct nn_xmsg *a, const struct nn_xmsg *b)
+{
+  /* Orders messages such that those nn_xpack_addmsg can put in the
+     same packet end up next to each other: the addressing information
+     first, then the source and destination prefixes so that the
+     number of INFO_SRC and INFO_DST submessages is minimal, too.  For
+     sending to a set of addresses, only the sets themselves are
+     compared, not their contents. */
+  int c;
+  assert (a->dstmode != NN_XMSG_DST_UNSET && b->dstmode != NN_XMSG_DST_UNSET);
+  if (a->dstmode != b->dstmode)
+    return (a->dstmode < b->dstmode) ? -1 : 1;
+  if (a->dstmode == NN_XMSG_DST_ONE)
+  {
+    if ((c = memcmp (&a->dstaddr.one.loc, &b->dstaddr.one.loc, sizeof (a->dstaddr.one.loc))) != 0)
+      return c;
+  }
+  else
+  {
+    if (a->dstaddr.all.as != b->dstaddr.all.as)
+      return ((os_address) a->dstaddr.all.as < (os_address) b->dstaddr.all.as) ? -1 : 1;
+    if (a->dstaddr.all.as_group != b->dstaddr.all.as_group)
+      return ((os_address) a->dstaddr.all.as_group < (os_address) b->dstaddr.all.as_group) ? -1 : 1;
+  }
+  if ((c = memcmp (&a->data->src.guid_prefix, &b->data->src.guid_prefix, sizeof (a->data->src.guid_prefix))) != 0)
+    return c;
+  return memcmp (&a->data->dst.guid_prefix, &b->data->dst.guid_prefix, sizeof (a->data->dst.guid_prefix));
+}
+
 size_t nn_xmsg_size (const struct nn_xmsg *m)
 {
   return m->sz;
@@ -109,6 +109,10 @@ void nn_xmsg_setwriterseq_fragid (struct nn_xmsg *msg, const nn_guid_t *wrguid,
    guid, sequence number and fragment id */
 int nn_xmsg_compare_fragid (const struct nn_xmsg *a, const struct nn_xmsg *b);
 
+/* Compares the destinations of two messages, to group messages that
+   can go out in a single packet */
+int nn_xmsg_compare_dst (const struct nn_xmsg *a, const struct nn_xmsg *b);
+
 void nn_xmsg_free (struct nn_xmsg *msg);
 size_t nn_xmsg_size (const struct nn_xmsg *m);
 void *nn_xmsg_payload (size_t *sz, struct nn_xmsg *m);
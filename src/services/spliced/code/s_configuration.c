@@ -430,6 +430,24 @@ static void s_configurationSetStackSize( os_threadAttr *tattr,
     tattr->stackSize = (os_uint32)stackSize;
 }
 
+static void s_configurationSetAffinity( os_threadAttr *tattr,
+                                       const c_char* cpus )
+{
+    if (os_threadAttrSetCpuAffinity(tattr, cpus) != os_resultSuccess) {
+        OS_REPORT(OS_WARNING, OSRPT_CNTXT_SPLICED, 0,
+            "Invalid CPU affinity '%s', expected a list of CPU numbers and ranges such as '0-3,8'; ignored", cpus);
+    }
+}
+
+static void s_configurationSetMemoryPolicy( os_threadAttr *tattr,
+                                           const c_char* policy )
+{
+    if (os_threadAttrSetMemPolicy(tattr, policy) != os_resultSuccess) {
+        OS_REPORT(OS_WARNING, OSRPT_CNTXT_SPLICED, 0,
+            "Invalid memory policy '%s', expected default, local or bind, preferred or interleave followed by ':' and a list of NUMA nodes; ignored", policy);
+    }
+}
+
 /**
  * Sets the transport priority of the Heartbeat writer
  * @param config The configuration struct to store the transport priority in
@@ -584,6 +602,71 @@ s_configurationSetHeartbeatStackSize( s_configuration config,
 }
 
 
+static void
+s_configurationSetKernelManagerAffinity( s_configuration config,
+                                         const c_char* cpus)
+{
+    s_configurationSetAffinity( &config->kernelManagerAttribute, cpus );
+}
+
+static void
+s_configurationSetKernelManagerMemoryPolicy( s_configuration config,
+                                             const c_char* policy)
+{
+    s_configurationSetMemoryPolicy( &config->kernelManagerAttribute, policy );
+}
+
+static void
+s_configurationSetLeaseRenewAffinity( s_configuration config,
+                                      const c_char* cpus)
+{
+    s_configurationSetAffinity( &config->leaseRenewAttribute, cpus );
+}
+
+static void
+s_configurationSetLeaseRenewMemoryPolicy( s_configuration config,
+                                          const c_char* policy)
+{
+    s_configurationSetMemoryPolicy( &config->leaseRenewAttribute, policy );
+}
+
+static void
+s_configurationSetGCAffinity( s_configuration config,
+                              const c_char* cpus)
+{
+    s_configurationSetAffinity( &config->garbageCollectorAttribute, cpus );
+}
+
+static void
+s_configurationSetGCMemoryPolicy( s_configuration config,
+                                  const c_char* policy)
+{
+    s_configurationSetMemoryPolicy( &config->garbageCollectorAttribute, policy );
+}
+
+static void
+s_configurationSetHeartbeatAffinity( s_configuration config,
+                                     const c_char* cpus)
+{
+    if (config->heartbeatAttribute == NULL) {
+         config->heartbeatAttribute = os_malloc(sizeof(*config->heartbeatAttribute));
+         os_threadAttrInit(config->heartbeatAttribute);
+         s_configurationSetStackSize(config->heartbeatAttribute,S_CFG_STACKSIZE_DEFAULT);
+    }
+    s_configurationSetAffinity(config->heartbeatAttribute, cpus );
+}
+
+static void
+s_configurationSetHeartbeatMemoryPolicy( s_configuration config,
+                                         const c_char* policy)
+{
+    if (config->heartbeatAttribute == NULL) {
+         config->heartbeatAttribute = os_malloc(sizeof(*config->heartbeatAttribute));
+         os_threadAttrInit(config->heartbeatAttribute);
+         s_configurationSetStackSize(config->heartbeatAttribute,S_CFG_STACKSIZE_DEFAULT);
+    }
+    s_configurationSetMemoryPolicy(config->heartbeatAttribute, policy );
+}
 
 static void
 s_configurationSetshmMonitorSchedulingClass( s_configuration config,
@@ -1116,15 +1199,21 @@ s_configurationRead(
         s_configurationValueString (config, dcfg, "Watchdog/Scheduling/Class/#text", s_configurationSetLeaseRenewSchedulingClass);
         s_configurationValueLong (config, dcfg, "Watchdog/Scheduling/Priority/#text", s_configurationSetLeaseRenewSchedulingPriority);
         s_configurationValueLong (config, dcfg, "Watchdog/StackSize/#text", s_configurationSetLeaseRenewStackSize);
+        s_configurationValueString (config, dcfg, "Watchdog/Affinity/#text", s_configurationSetLeaseRenewAffinity);
+        s_configurationValueString (config, dcfg, "Watchdog/MemoryPolicy/#text", s_configurationSetLeaseRenewMemoryPolicy);
 
         /* Kernelmanager */
         s_configurationValueString(config, dcfg, "KernelManager/Scheduling/Class/#text", s_configurationSetKernelManagerSchedulingClass);
         s_configurationValueLong(config, dcfg, "KernelManager/Scheduling/Priority/#text", s_configurationSetKernelManagerSchedulingPriority);
         s_configurationValueLong(config, dcfg, "KernelManager/StackSize/#text", s_configurationSetKernelManagerStackSize);
+        s_configurationValueString(config, dcfg, "KernelManager/Affinity/#text", s_configurationSetKernelManagerAffinity);
+        s_configurationValueString(config, dcfg, "KernelManager/MemoryPolicy/#text", s_configurationSetKernelManagerMemoryPolicy);
          /* GarbageCollector */
          s_configurationValueString(config, dcfg, "GarbageCollector/Scheduling/Class/#text", s_configurationSetGCSchedulingClass);
          s_configurationValueLong(config, dcfg, "GarbageCollector/Scheduling/Priority/#text", s_configurationSetGCSchedulingPriority);
          s_configurationValueLong(config, dcfg, "GarbageCollector/StackSize/#text", s_configurationSetGCStackSize);
+         s_configurationValueString(config, dcfg, "GarbageCollector/Affinity/#text", s_configurationSetGCAffinity);
+         s_configurationValueString(config, dcfg, "GarbageCollector/MemoryPolicy/#text", s_configurationSetGCMemoryPolicy);
 
          /* ResendManager */
          s_configurationValueString(config, dcfg, "ResendManager/Scheduling/Class/#text", s_configurationSetResendManagerSchedulingClass);
@@ -1144,6 +1233,8 @@ s_configurationRead(
          s_configurationValueString(config, dcfg, "Heartbeat/Scheduling/Class/#text", s_configurationSetHeartbeatSchedulingClass);
          s_configurationValueLong(config, dcfg, "Heartbeat/Scheduling/Priority/#text", s_configurationSetHeartbeatSchedulingPriority);
          s_configurationValueLong(config, dcfg, "Heartbeat/StackSize/#text", s_configurationSetHeartbeatStackSize);
+         s_configurationValueString(config, dcfg, "Heartbeat/Affinity/#text", s_configurationSetHeartbeatAffinity);
+         s_configurationValueString(config, dcfg, "Heartbeat/MemoryPolicy/#text", s_configurationSetHeartbeatMemoryPolicy);
 
          /* Control and Monitoring Command Receiver */
          iter = u_cfElementXPath(domain,
@@ -56,6 +56,14 @@
 #endif
 
 
+/* Maximum number of startup phases timed by startupPhaseDone */
+#define S_STARTUP_PHASES_MAX 16
+
+struct startupPhase {
+    const c_char *name;
+    os_duration duration;
+};
+
 C_STRUCT(spliced)
 {
     s_configuration         config;
@@ -82,12 +90,61 @@ C_STRUCT(spliced)
     u_service_cmdopts           cfg_handle;
     ut_threads                  threads;
     s_threadsMonitor            threadsMonitor;
+    struct startup {
+        os_timeM                start;
+        os_timeM                mark;
+        os_uint32               nrPhases;
+        struct startupPhase     phases[S_STARTUP_PHASES_MAX];
+    } startup;
 };
 
 /**************************************************************
  * Private functions
  **************************************************************/
 
+/* Records the time spent since the previous phase ended (or since
+ * startup began) as the duration of phase 'name'. */
+static void
+startupPhaseDone(
+    spliced _this,
+    const c_char *name)
+{
+    os_timeM now = os_timeMGet();
+
+    if (_this->startup.nrPhases < S_STARTUP_PHASES_MAX) {
+        _this->startup.phases[_this->startup.nrPhases].name = name;
+        _this->startup.phases[_this->startup.nrPhases].duration = os_timeMDiff(now, _this->startup.mark);
+        _this->startup.nrPhases++;
+    }
+    _this->startup.mark = now;
+}
+
+static void
+startupReport(
+    spliced _this)
+{
+    char phases[1024];
+    size_t pos = 0;
+    os_uint32 i;
+    int n;
+
+    phases[0] = '\0';
+    for (i = 0; i < _this->startup.nrPhases && pos < sizeof(phases); i++) {
+        n = snprintf(phases + pos, sizeof(phases) - pos, "%s %s %.1f ms",
+                     (i == 0) ? "" : ",", _this->startup.phases[i].name,
+                     os_durationToReal(_this->startup.phases[i].duration) * 1e3);
+        if (n < 0) {
+            break;
+        }
+        pos += (size_t)n;
+    }
+    OS_REPORT(OS_INFO, OSRPT_CNTXT_SPLICED, 0,
+              "Domain '%s' started in %.1f ms:%s",
+              splicedGetDomainName(_this),
+              os_durationToReal(os_timeMDiff(_this->startup.mark, _this->startup.start)) * 1e3,
+              phases);
+}
+
 static int
 argumentsCheck(
     spliced _this,
@@ -1422,6 +1479,9 @@ OPENSPLICE_ENTRYPOINT (ospl_spliced)
     }
 
     _this = os_malloc(sizeof *_this);
+    _this->startup.start = os_timeMGet();
+    _this->startup.mark = _this->startup.start;
+    _this->startup.nrPhases = 0;
 
     if((osresult = os_mutexInit(&_this->terminate.mtx, NULL)) != os_resultSuccess){
         OS_REPORT(OS_ERROR, OSRPT_CNTXT_SPLICED, 0,
@@ -1489,6 +1549,7 @@ OPENSPLICE_ENTRYPOINT (ospl_spliced)
         }
         goto err_usplicedNew;
     }
+    startupPhaseDone(_this, "domain");
 
     if (!setState(_this, STATE_INITIALISING)) {
         splicedSignalTerminate(_this, SPLICED_EXIT_CODE_RECOVERABLE_ERROR, SPLICED_SHM_OK);
@@ -1515,6 +1576,7 @@ OPENSPLICE_ENTRYPOINT (ospl_spliced)
     } else {
         _this->shmMonitor = NULL;
     }
+    startupPhaseDone(_this, "configuration");
 
     if((_this->serviceManager = u_serviceManagerNew(u_participant(_this->service))) == NULL){
         /* Error reported by u_serviceManagerNew(...). */
@@ -1529,6 +1591,7 @@ OPENSPLICE_ENTRYPOINT (ospl_spliced)
     }
 
     s_kernelManagerWaitForActive(_this->km);
+    startupPhaseDone(_this, "kernel manager");
 
     if ((_this->gc = s_garbageCollectorNew(_this)) == NULL) {
         OS_REPORT(OS_ERROR, OSRPT_CNTXT_SPLICED, 0,
@@ -1538,6 +1601,7 @@ OPENSPLICE_ENTRYPOINT (ospl_spliced)
     }
 
     s_garbageCollectorWaitForActive(_this->gc);
+    startupPhaseDone(_this, "garbage collector");
 
     if ((_this->serviceMon = serviceMonitorNew(_this)) == NULL) {
         OS_REPORT(OS_ERROR, OSRPT_CNTXT_SPLICED, 0,
@@ -1577,6 +1641,7 @@ OPENSPLICE_ENTRYPOINT (ospl_spliced)
         splicedSignalTerminate(_this, SPLICED_EXIT_CODE_RECOVERABLE_ERROR, SPLICED_SHM_OK);
         goto err_changeStateOperational;
     }
+    startupPhaseDone(_this, "monitoring");
 
     /* Start services */
     if((retCode = startServices(_this)) != SPLICED_EXIT_CODE_CONTINUE){
@@ -1584,11 +1649,15 @@ OPENSPLICE_ENTRYPOINT (ospl_spliced)
         splicedSignalTerminate(_this, retCode, SPLICED_SHM_OK);
         goto err_startServices;
     }
+    startupPhaseDone(_this, "services");
 
     /* Start applications specified in XML on a best effort basis. Note
      * this will only succeed if this is a SingleProcess configuration,
      * and leave warning messages otherwise. */
     startApplications(_this);
+    startupPhaseDone(_this, "applications");
+    startupReport(_this);
+    u_splicedSetInProcessReady();
 
     /**************************************************************************/
     /*                            RUNNING PHASE                               */
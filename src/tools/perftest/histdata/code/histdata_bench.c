@@ -0,0 +1,314 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+/* histdata_bench: measures how late-joining readers of a large transient-local
+ * group affect concurrent writers to that group.
+ *
+ * The group is filled with instances * depth samples, after which a number of
+ * writer threads continuously write to their own set of instances. While they
+ * run, readers are created one after the other; reader creation includes the
+ * delivery of the historical data. The benchmark reports the time taken to
+ * create a reader, the worst write latency observed during that time, and
+ * whether the historical data was complete and in order relative to the live
+ * data written concurrently.
+ */
+
+#include "vortex_os.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "dds_dcps.h"
+#include "HistDataBenchSacDcps.h"
+
+struct writerArg {
+    DDS_Publisher publisher;
+    DDS_Topic topic;
+    DDS_DataWriterQos *qos;
+    DDS_long firstId;
+    DDS_long nrOfIds;
+    volatile int *stop;
+    volatile int measuring;
+    os_duration maxLatency;
+    unsigned long long writes;
+};
+
+static DDS_long instances = 100000;
+static DDS_long depth = 10;
+static int nrOfWriters = 2;
+static int nrOfReaders = 3;
+
+static void
+check(
+    DDS_ReturnCode_t rc,
+    const char *what)
+{
+    if (rc != DDS_RETCODE_OK) {
+        fprintf(stderr, "%s failed: %d\n", what, (int) rc);
+        exit(1);
+    }
+}
+
+static void *
+writerThread(
+    void *varg)
+{
+    struct writerArg *arg = varg;
+    HistDataBench_SampleDataWriter writer;
+    HistDataBench_Sample s;
+    os_timeM t0;
+    os_duration d;
+
+    writer = DDS_Publisher_create_datawriter(arg->publisher, arg->topic, arg->qos, NULL, DDS_STATUS_MASK_NONE);
+    if (writer == NULL) {
+        fprintf(stderr, "create_datawriter failed\n");
+        exit(1);
+    }
+    memset(&s, 0, sizeof(s));
+    while (!*arg->stop) {
+        s.id = arg->firstId + (DDS_long) (s.seq % arg->nrOfIds);
+        t0 = os_timeMGet();
+        check(HistDataBench_SampleDataWriter_write(writer, &s, DDS_HANDLE_NIL), "write");
+        d = os_timeMDiff(os_timeMGet(), t0);
+        if (arg->measuring) {
+            if (d > arg->maxLatency) {
+                arg->maxLatency = d;
+            }
+            arg->writes++;
+        }
+        s.seq++;
+    }
+    (void) DDS_Publisher_delete_datawriter(arg->publisher, writer);
+    return NULL;
+}
+
+/* Counts the samples of the prefilled instances and checks that the samples
+ * of every live instance are in the order in which they were written. */
+static void
+verify(
+    HistDataBench_SampleDataReader reader,
+    DDS_unsigned_long *history,
+    DDS_unsigned_long *outOfOrder)
+{
+    DDS_sequence_HistDataBench_Sample samples = { 0, 0, NULL, FALSE };
+    DDS_SampleInfoSeq infos = { 0, 0, NULL, FALSE };
+    DDS_long *lastSeq;
+    DDS_unsigned_long i;
+    DDS_long id;
+
+    lastSeq = os_malloc(sizeof(*lastSeq) * (size_t) (nrOfWriters * 64));
+    for (i = 0; i < (DDS_unsigned_long) (nrOfWriters * 64); i++) {
+        lastSeq[i] = -1;
+    }
+    *history = 0;
+    *outOfOrder = 0;
+    check(HistDataBench_SampleDataReader_read(reader, &samples, &infos, DDS_LENGTH_UNLIMITED,
+            DDS_ANY_SAMPLE_STATE, DDS_ANY_VIEW_STATE, DDS_ANY_INSTANCE_STATE), "read");
+    for (i = 0; i < samples._length; i++) {
+        if (!infos._buffer[i].valid_data) {
+            continue;
+        }
+        id = samples._buffer[i].id;
+        if (id < instances) {
+            (*history)++;
+        } else {
+            if (samples._buffer[i].seq <= lastSeq[id - instances]) {
+                (*outOfOrder)++;
+            }
+            lastSeq[id - instances] = samples._buffer[i].seq;
+        }
+    }
+    (void) HistDataBench_SampleDataReader_return_loan(reader, &samples, &infos);
+    os_free(lastSeq);
+}
+
+static void
+usage(
+    const char *argv0)
+{
+    fprintf(stderr,
+        "usage: %s [-i instances] [-d depth] [-w writers] [-r readers]\n"
+        "  -i  number of prefilled instances (default %d)\n"
+        "  -d  history depth, samples per instance (default %d)\n"
+        "  -w  number of concurrent writer threads (default %d)\n"
+        "  -r  number of late-joining readers created (default %d)\n",
+        argv0, instances, depth, nrOfWriters, nrOfReaders);
+    exit(2);
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+    DDS_DomainParticipantFactory factory;
+    DDS_DomainParticipant participant;
+    HistDataBench_SampleTypeSupport ts;
+    DDS_TopicQos *tqos;
+    DDS_DataWriterQos *wqos;
+    DDS_DataReaderQos *rqos;
+    DDS_Topic topic;
+    DDS_Publisher publisher;
+    DDS_Subscriber subscriber;
+    HistDataBench_SampleDataWriter writer;
+    HistDataBench_SampleDataReader reader;
+    HistDataBench_Sample s;
+    struct writerArg *wargs;
+    os_threadId *tids;
+    os_threadAttr attr;
+    volatile int stop = 0;
+    char *typeName;
+    os_timeM t0;
+    os_duration created, maxLatency;
+    unsigned long long writes;
+    DDS_unsigned_long history, outOfOrder;
+    int opt, i, r;
+
+    while ((opt = getopt(argc, argv, "i:d:w:r:")) != -1) {
+        switch (opt) {
+        case 'i': instances = atoi(optarg); break;
+        case 'd': depth = atoi(optarg); break;
+        case 'w': nrOfWriters = atoi(optarg); break;
+        case 'r': nrOfReaders = atoi(optarg); break;
+        default: usage(argv[0]);
+        }
+    }
+    if (instances <= 0 || depth <= 0 || nrOfWriters < 0 || nrOfReaders <= 0) {
+        usage(argv[0]);
+    }
+
+    factory = DDS_DomainParticipantFactory_get_instance();
+    participant = DDS_DomainParticipantFactory_create_participant(factory, DDS_DOMAIN_ID_DEFAULT,
+            DDS_PARTICIPANT_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE);
+    if (participant == NULL) {
+        fprintf(stderr, "create_participant failed\n");
+        return 1;
+    }
+    ts = HistDataBench_SampleTypeSupport__alloc();
+    typeName = HistDataBench_SampleTypeSupport_get_type_name(ts);
+    check(HistDataBench_SampleTypeSupport_register_type(ts, participant, typeName), "register_type");
+
+    tqos = DDS_TopicQos__alloc();
+    check(DDS_DomainParticipant_get_default_topic_qos(participant, tqos), "get_default_topic_qos");
+    tqos->durability.kind = DDS_TRANSIENT_LOCAL_DURABILITY_QOS;
+    tqos->reliability.kind = DDS_RELIABLE_RELIABILITY_QOS;
+    tqos->history.kind = DDS_KEEP_LAST_HISTORY_QOS;
+    tqos->history.depth = depth;
+    tqos->durability_service.history_kind = DDS_KEEP_LAST_HISTORY_QOS;
+    tqos->durability_service.history_depth = depth;
+    topic = DDS_DomainParticipant_create_topic(participant, "HistDataBench", typeName, tqos, NULL, DDS_STATUS_MASK_NONE);
+    publisher = DDS_DomainParticipant_create_publisher(participant, DDS_PUBLISHER_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE);
+    subscriber = DDS_DomainParticipant_create_subscriber(participant, DDS_SUBSCRIBER_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE);
+    if (topic == NULL || publisher == NULL || subscriber == NULL) {
+        fprintf(stderr, "entity creation failed\n");
+        return 1;
+    }
+    wqos = DDS_DataWriterQos__alloc();
+    check(DDS_Publisher_get_default_datawriter_qos(publisher, wqos), "get_default_datawriter_qos");
+    check(DDS_Publisher_copy_from_topic_qos(publisher, wqos, tqos), "copy_from_topic_qos");
+    wqos->writer_data_lifecycle.autodispose_unregistered_instances = FALSE;
+    rqos = DDS_DataReaderQos__alloc();
+    check(DDS_Subscriber_get_default_datareader_qos(subscriber, rqos), "get_default_datareader_qos");
+    check(DDS_Subscriber_copy_from_topic_qos(subscriber, rqos, tqos), "copy_from_topic_qos");
+
+    /* Fill the group */
+    t0 = os_timeMGet();
+    writer = DDS_Publisher_create_datawriter(publisher, topic, wqos, NULL, DDS_STATUS_MASK_NONE);
+    if (writer == NULL) {
+        fprintf(stderr, "create_datawriter failed\n");
+        return 1;
+    }
+    memset(&s, 0, sizeof(s));
+    for (s.seq = 0; s.seq < depth; s.seq++) {
+        for (s.id = 0; s.id < instances; s.id++) {
+            check(HistDataBench_SampleDataWriter_write(writer, &s, DDS_HANDLE_NIL), "write");
+        }
+    }
+    printf("fill instances=%d depth=%d samples=%d time_ms=%.1f\n",
+        instances, depth, instances * depth, os_durationToReal(os_timeMDiff(os_timeMGet(), t0)) * 1e3);
+
+    /* Start the concurrent writers, each on 64 instances of its own */
+    wargs = os_malloc(sizeof(*wargs) * (size_t) (nrOfWriters + 1));
+    tids = os_malloc(sizeof(*tids) * (size_t) (nrOfWriters + 1));
+    os_threadAttrInit(&attr);
+    for (i = 0; i < nrOfWriters; i++) {
+        memset(&wargs[i], 0, sizeof(wargs[i]));
+        wargs[i].publisher = publisher;
+        wargs[i].topic = topic;
+        wargs[i].qos = wqos;
+        wargs[i].firstId = instances + 64 * i;
+        wargs[i].nrOfIds = 64;
+        wargs[i].stop = &stop;
+        if (os_threadCreate(&tids[i], "writer", &attr, writerThread, &wargs[i]) != os_resultSuccess) {
+            fprintf(stderr, "os_threadCreate failed\n");
+            return 1;
+        }
+    }
+    os_sleep(OS_DURATION_INIT(0, 200000000));
+
+    for (r = 0; r < nrOfReaders; r++) {
+        for (i = 0; i < nrOfWriters; i++) {
+            wargs[i].maxLatency = 0;
+            wargs[i].writes = 0;
+            wargs[i].measuring = 1;
+        }
+        t0 = os_timeMGet();
+        reader = DDS_Subscriber_create_datareader(subscriber, topic, rqos, NULL, DDS_STATUS_MASK_NONE);
+        created = os_timeMDiff(os_timeMGet(), t0);
+        maxLatency = 0;
+        writes = 0;
+        for (i = 0; i < nrOfWriters; i++) {
+            wargs[i].measuring = 0;
+            if (wargs[i].maxLatency > maxLatency) {
+                maxLatency = wargs[i].maxLatency;
+            }
+            writes += wargs[i].writes;
+        }
+        if (reader == NULL) {
+            fprintf(stderr, "create_datareader failed\n");
+            return 1;
+        }
+        verify(reader, &history, &outOfOrder);
+        printf("reader=%d create_ms=%.1f writer_max_latency_us=%.1f writes_during_create=%llu "
+               "history_samples=%u/%d out_of_order=%u\n",
+            r, os_durationToReal(created) * 1e3, os_durationToReal(maxLatency) * 1e6, writes,
+            history, instances * depth, outOfOrder);
+        (void) DDS_Subscriber_delete_datareader(subscriber, reader);
+    }
+
+    stop = 1;
+    for (i = 0; i < nrOfWriters; i++) {
+        (void) os_threadWaitExit(tids[i], NULL);
+    }
+    os_free(tids);
+    os_free(wargs);
+
+    (void) DDS_Publisher_delete_datawriter(publisher, writer);
+    DDS_free(rqos);
+    DDS_free(wqos);
+    DDS_free(tqos);
+    DDS_free(typeName);
+    DDS_free(ts);
+    (void) DDS_DomainParticipant_delete_contained_entities(participant);
+    (void) DDS_DomainParticipantFactory_delete_participant(factory, participant);
+    return 0;
+}
@@ -0,0 +1,877 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+/* kernel_bench: micro-benchmarks of the individual layers of the data path,
+ * driven directly through the kernel, database and DDSI2 interfaces so that
+ * a regression can be attributed to the layer that caused it.
+ *
+ * The benchmark creates a participant through the user layer, loads its own
+ * type and sets up the entities it needs, and then calls the measured
+ * operations directly: v_writerWrite, v_dataReaderTake, the registration of
+ * an existing type from its XML descriptor, c_tableInsert, the DDSI2
+ * serializer, whc_insert and the DDSI2 defragmentation and reordering admin. The DDSI2 functions are used from libddsi2 in this process, so the
+ * domain must be a single process configuration without a networking
+ * service.
+ *
+ * The reorder_lossy benchmarks drop samples the way DDSI2 does when
+ * XmitLossiness is configured, and recover them through the NACK bitmaps of
+ * the reorder admin and retransmits, as a reliable proxy writer does. The
+ * fraction dropped is set with -l, in the same units as XmitLossiness.
+ *
+ * Each benchmark prints one line of key=value pairs with the time and the
+ * number of heap allocations per operation of the fastest of a number of
+ * repetitions. Allocations are counted with os_heapSetService, so they cover
+ * everything allocated through os_malloc including the heap database, but
+ * also the odd allocation by a background thread of the domain.
+ */
+
+#include "vortex_os.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "u_user.h"
+#include "u_participant.h"
+#include "u_participantQos.h"
+#include "u_topic.h"
+#include "u_topicQos.h"
+#include "u_publisher.h"
+#include "u_subscriber.h"
+#include "u_writer.h"
+#include "u_writerQos.h"
+#include "u_dataReader.h"
+#include "u_readerQos.h"
+#include "u_observable.h"
+#include "u_entity.h"
+#include "u_domain.h"
+
+#include "v_kernel.h"
+#include "v_topic.h"
+#include "v_writer.h"
+#include "v_dataReader.h"
+#include "v_readerSample.h"
+#include "v_message.h"
+#include "c_collection.h"
+#include "os_atomics.h"
+
+#include "q_config.h"
+#include "q_globals.h"
+#include "q_osplser.h"
+#include "q_whc.h"
+#include "q_radmin.h"
+#include "q_rtps.h"
+#include "q_protocol.h"
+#include "q_misc.h"
+#include "q_bitset.h"
+
+#define NR_OF_KEYS (256)
+
+static const char typeDescriptor[] =
+    "<MetaData version=\"1.0.0\"><Module name=\"KernelBench\"><Struct name=\"Sample\">"
+    "<Member name=\"id\"><Long/></Member><Member name=\"seq\"><Long/></Member>"
+    "<Member name=\"payload\"><Array size=\"32\"><Octet/></Array></Member>"
+    "</Struct></Module></MetaData>";
+
+/* In-memory representation of KernelBench::Sample */
+struct sample {
+    c_long id;
+    c_long seq;
+    c_octet payload[32];
+};
+
+struct benchState {
+    os_timeM start;
+    os_duration elapsed;
+    os_uint32 allocsAtStart;
+    os_uint32 allocs;
+
+    u_participant participant;
+    u_publisher publisher;
+    u_subscriber subscriber;
+    u_topic writeTopic;
+    u_topic takeTopic;
+    u_writer writer;
+    u_writer takeWriter;
+    u_dataReader reader;
+    u_dataReader takeReader;
+
+    v_topic topic;
+    v_writer vWriter;
+    v_writer vTakeWriter;
+    v_dataReader vTakeReader;
+    c_type type;
+    v_message messages[NR_OF_KEYS];
+    os_char *topicInfoDescriptor;
+
+    os_library ddsi2;
+    struct q_globals *gv;
+    struct config *config;
+    sertopic_t sertopic;
+    serstatepool_t serpool;
+    serdata_t serdata[NR_OF_KEYS];
+};
+
+struct bench {
+    const char *name;
+    const char *layer;
+    os_uint32 (*run)(struct benchState *st, os_uint32 ops);
+};
+
+static pa_uint32_t allocCount = PA_UINT32_INIT(0);
+static os_uint32 nrOfOps = 100000;
+static int nrOfRepeats = 3;
+static int lossiness = 10;
+
+static void *
+countingMalloc(
+    os_size_t size)
+{
+    pa_inc32(&allocCount);
+    return malloc(size);
+}
+
+static void *
+countingRealloc(
+    void *ptr,
+    os_size_t size)
+{
+    pa_inc32(&allocCount);
+    return realloc(ptr, size);
+}
+
+static void
+benchResume(
+    struct benchState *st)
+{
+    st->allocsAtStart = pa_ld32(&allocCount);
+    st->start = os_timeMGet();
+}
+
+static void
+benchPause(
+    struct benchState *st)
+{
+    st->elapsed += os_timeMDiff(os_timeMGet(), st->start);
+    st->allocs += pa_ld32(&allocCount) - st->allocsAtStart;
+}
+
+static void
+fail(
+    const char *what)
+{
+    fprintf(stderr, "%s failed\n", what);
+    exit(1);
+}
+
+/* ------------------------------- kernel ------------------------------- */
+
+static v_message
+newMessage(
+    v_topic topic,
+    c_long id,
+    c_long seq)
+{
+    v_message message;
+    struct sample *s;
+
+    if ((message = v_topicMessageNew_s(topic)) == NULL) {
+        fail("v_topicMessageNew_s");
+    }
+    s = (struct sample *) (message + 1);
+    s->id = id;
+    s->seq = seq;
+    memset(s->payload, (int) (seq & 0xff), sizeof(s->payload));
+    return message;
+}
+
+static os_uint32
+benchWriterWrite(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    v_message message;
+    os_uint32 i;
+
+    benchResume(st);
+    for (i = 0; i < ops; i++) {
+        message = newMessage(st->vWriter->topic, (c_long) (i % NR_OF_KEYS), (c_long) i);
+        if (v_writerWrite(st->vWriter, message, os_timeWGet(), NULL) != V_WRITE_SUCCESS) {
+            fail("v_writerWrite");
+        }
+        c_free(message);
+    }
+    benchPause(st);
+    return ops;
+}
+
+static v_actionResult
+takeAction(
+    c_object sample,
+    c_voidp arg)
+{
+    os_uint32 *count = arg;
+    v_actionResult result = 0;
+
+    if (sample != NULL) {
+        (*count)++;
+        v_actionResultSet(result, V_PROCEED);
+    }
+    return result;
+}
+
+static os_uint32
+benchReaderTake(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    v_message message;
+    os_uint32 done = 0, count, i;
+
+    while (done < ops) {
+        for (i = 0; i < NR_OF_KEYS; i++) {
+            message = newMessage(st->topic, (c_long) i, (c_long) (done + i));
+            if (v_writerWrite(st->vTakeWriter, message, os_timeWGet(), NULL) != V_WRITE_SUCCESS) {
+                fail("v_writerWrite");
+            }
+            c_free(message);
+        }
+        count = 0;
+        benchResume(st);
+        (void) v_dataReaderTake(st->vTakeReader, V_MASK_ANY, takeAction, &count, OS_DURATION_ZERO);
+        benchPause(st);
+        if (count != NR_OF_KEYS) {
+            fail("v_dataReaderTake");
+        }
+        done += count;
+    }
+    return done;
+}
+
+/* Registers the type of the DCPSTopic built-in topic again, as every
+ * participant that uses a type does. The type already exists, which is the
+ * common case for an application that creates its participants in a domain
+ * that is already up. */
+static os_uint32
+benchLoadXmlDescriptor(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    u_domain domain = u_participantDomain(st->participant);
+    os_uint32 i;
+
+    benchResume(st);
+    for (i = 0; i < ops; i++) {
+        if (u_domain_load_xml_descriptor(domain, st->topicInfoDescriptor) != U_RESULT_OK) {
+            fail("u_domain_load_xml_descriptor");
+        }
+    }
+    benchPause(st);
+    return ops;
+}
+
+/* ------------------------------ database ------------------------------ */
+
+static os_uint32
+tableInsert(
+    struct benchState *st,
+    c_table table,
+    os_uint32 ops)
+{
+    c_object *objects;
+    c_object found;
+    os_uint32 done = 0, batch, i;
+
+    batch = 4 * NR_OF_KEYS;
+    objects = os_malloc(batch * sizeof(*objects));
+    for (i = 0; i < batch; i++) {
+        objects[i] = c_new(st->type);
+        ((struct sample *) objects[i])->id = (c_long) (i * 2654435761U >> 8);
+    }
+    while (done < ops) {
+        benchResume(st);
+        for (i = 0; i < batch; i++) {
+            if (c_tableInsert(table, objects[i]) != objects[i]) {
+                fail("c_tableInsert");
+            }
+        }
+        benchPause(st);
+        for (i = 0; i < batch; i++) {
+            found = c_tableRemove(table, objects[i], NULL, NULL);
+            c_free(found);
+        }
+        done += batch;
+    }
+    for (i = 0; i < batch; i++) {
+        c_free(objects[i]);
+    }
+    os_free(objects);
+    c_free(table);
+    return done;
+}
+
+static os_uint32
+benchTableInsert(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    return tableInsert(st, c_tableNew(st->type, "id"), ops);
+}
+
+static os_uint32
+benchTableInsertHashed(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    return tableInsert(st, c_tableNewHashed(st->type, "id"), ops);
+}
+
+/* -------------------------------- ddsi2 ------------------------------- */
+
+static os_uint32
+benchSerialize(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    serdata_t serdata;
+    os_uint32 i;
+
+    benchResume(st);
+    for (i = 0; i < ops; i++) {
+        if ((serdata = serialize(st->serpool, st->sertopic, st->messages[i % NR_OF_KEYS])) == NULL) {
+            fail("serialize");
+        }
+        ddsi_serdata_unref(serdata);
+    }
+    benchPause(st);
+    return ops;
+}
+
+static os_uint32
+benchDeserialize(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    serdata_t serdata;
+    v_message message;
+    os_uint32 i;
+
+    benchResume(st);
+    for (i = 0; i < ops; i++) {
+        serdata = st->serdata[i % NR_OF_KEYS];
+        message = deserialize(st->sertopic, &serdata->hdr, ddsi_serdata_size(serdata));
+        if (message == NULL) {
+            fail("deserialize");
+        }
+        c_free(message);
+    }
+    benchPause(st);
+    return ops;
+}
+
+/* A keep-last 1 writer history with 64 unacknowledged samples in flight */
+static os_uint32
+benchWhcInsert(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    struct whc *whc;
+    os_int64 seq, acked = 0;
+
+    whc = whc_new(0, 1, 0, 0);
+    for (seq = 1; seq <= (os_int64) ops; seq++) {
+        benchResume(st);
+        if (whc_insert(whc, acked, seq, NULL, st->serdata[seq % NR_OF_KEYS]) < 0) {
+            fail("whc_insert");
+        }
+        benchPause(st);
+        if ((seq % 64) == 0) {
+            (void) whc_remove_acked_messages(whc, seq);
+            acked = seq;
+        }
+    }
+    whc_free(whc);
+    return ops;
+}
+
+/* Runs a sample of 64 bytes through defragmentation and reordering the way
+ * the receive path does for a reliable proxy writer, delivering inline, and
+ * returns the number of samples delivered. */
+static os_uint32
+receiveSample(
+    struct nn_rbufpool *rbufpool,
+    struct nn_defrag *defrag,
+    struct nn_reorder *reorder,
+    os_int64 seq)
+{
+    struct nn_rsample_info sampleinfo;
+    struct nn_rsample_chain sc;
+    struct nn_rsample *rsample;
+    struct nn_rdata *rdata, *fragchain;
+    struct nn_rmsg *rmsg;
+    os_uint32 delivered = 0;
+    int refc_adjust;
+
+    memset(&sampleinfo, 0, sizeof(sampleinfo));
+    sampleinfo.seq = seq;
+    sampleinfo.size = 64;
+    rmsg = nn_rmsg_new(rbufpool);
+    nn_rmsg_setsize(rmsg, sampleinfo.size);
+    memset(NN_RMSG_PAYLOAD(rmsg), 0, sampleinfo.size);
+    rdata = nn_rdata_new(rmsg, 0, sampleinfo.size, 0, 0);
+    if ((rsample = nn_defrag_rsample(defrag, rdata, &sampleinfo)) != NULL) {
+        refc_adjust = 0;
+        fragchain = nn_rsample_fragchain(rsample);
+        if (nn_reorder_rsample(&sc, reorder, rsample, &refc_adjust, 0) > 0) {
+            while (sc.first) {
+                struct nn_rsample_chain_elem *e = sc.first;
+                sc.first = e->next;
+                nn_fragchain_unref(e->fragchain);
+                delivered++;
+            }
+        }
+        nn_fragchain_adjust_refcount(fragchain, refc_adjust);
+    }
+    nn_rmsg_commit(rmsg);
+    return delivered;
+}
+
+/* With swap set, each pair of sequence numbers arrives in reverse order. */
+static os_uint32
+defragReorder(
+    struct benchState *st,
+    os_uint32 ops,
+    int swap)
+{
+    struct nn_rbufpool *rbufpool;
+    struct nn_defrag *defrag;
+    struct nn_reorder *reorder;
+    os_uint32 delivered = 0, i;
+
+    rbufpool = nn_rbufpool_new(1048576, 131072);
+    defrag = nn_defrag_new(NN_DEFRAG_DROP_LATEST, 16);
+    reorder = nn_reorder_new(NN_REORDER_MODE_NORMAL, 128);
+    benchResume(st);
+    for (i = 0; i < ops; i++) {
+        delivered += receiveSample(rbufpool, defrag, reorder, (os_int64) (swap ? (i ^ 1) : i) + 1);
+    }
+    benchPause(st);
+    if (delivered != (ops & ~1u)) {
+        fail("nn_reorder_rsample");
+    }
+    nn_reorder_free(reorder);
+    nn_defrag_free(defrag);
+    nn_rbufpool_free(rbufpool);
+    return ops;
+}
+
+static os_uint32
+benchDefragReorder(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    return defragReorder(st, ops & ~1u, 0);
+}
+
+static os_uint32
+benchDefragReorderSwapped(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    return defragReorder(st, ops & ~1u, 1);
+}
+
+/* Decides whether a transmission is lost, the way DDSI2 does it for
+ * XmitLossiness. */
+static int
+dropped(
+    const struct benchState *st)
+{
+    return st->config->xmit_lossiness > 0 && (random() % 1000) < st->config->xmit_lossiness;
+}
+
+union nackmap {
+    struct nn_sequence_number_set set;
+    char space[sizeof(struct nn_sequence_number_set) + 256 / 8];
+};
+
+/* Sends ops samples over a lossy link to a reliable proxy writer with a
+ * heartbeat every 64 samples, to which the reader responds with the NACK
+ * bitmap of its reorder admin, after which the writer retransmits what is
+ * missing (over the same lossy link). Time and allocations per original
+ * sample include those of the retransmits and NACK bitmaps. */
+static os_uint32
+benchReorderLossy(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    struct nn_rbufpool *rbufpool;
+    struct nn_defrag *defrag;
+    struct nn_reorder *reorder;
+    union nackmap nack;
+    os_uint32 delivered = 0, i, j, numbits;
+    os_int64 base, seq = 0;
+
+    srandom(1);
+    rbufpool = nn_rbufpool_new(1048576, 131072);
+    defrag = nn_defrag_new(NN_DEFRAG_DROP_LATEST, 16);
+    reorder = nn_reorder_new(NN_REORDER_MODE_NORMAL, 256);
+    benchResume(st);
+    while (delivered < ops) {
+        for (i = 0; i < 64 && seq < (os_int64) ops; i++) {
+            if (!dropped(st)) {
+                delivered += receiveSample(rbufpool, defrag, reorder, seq + 1);
+            }
+            seq++;
+        }
+        numbits = nn_reorder_nackmap(reorder, nn_reorder_next_seq(reorder), seq, &nack.set, 256, 0);
+        base = fromSN(nack.set.bitmap_base);
+        for (j = 0; j < numbits; j++) {
+            if (nn_bitset_isset(numbits, nack.set.bits, j) && !dropped(st)) {
+                delivered += receiveSample(rbufpool, defrag, reorder, base + j);
+            }
+        }
+    }
+    benchPause(st);
+    if (delivered != ops || nn_reorder_next_seq(reorder) != (os_int64) ops + 1) {
+        fail("nn_reorder_rsample");
+    }
+    nn_reorder_free(reorder);
+    nn_defrag_free(defrag);
+    nn_rbufpool_free(rbufpool);
+    return ops;
+}
+
+/* Generates the NACK bitmap for a reorder admin holding the samples of a
+ * full bitmap, with the first one and the ones lost on the link missing. */
+static os_uint32
+benchReorderNackmap(
+    struct benchState *st,
+    os_uint32 ops)
+{
+    struct nn_rbufpool *rbufpool;
+    struct nn_defrag *defrag;
+    struct nn_reorder *reorder;
+    union nackmap nack;
+    os_uint32 i, numbits = 0;
+    os_int64 seq;
+
+    srandom(1);
+    rbufpool = nn_rbufpool_new(1048576, 131072);
+    defrag = nn_defrag_new(NN_DEFRAG_DROP_LATEST, 16);
+    reorder = nn_reorder_new(NN_REORDER_MODE_NORMAL, 256);
+    for (seq = 2; seq <= 256; seq++) {
+        if (!dropped(st)) {
+            (void) receiveSample(rbufpool, defrag, reorder, seq);
+        }
+    }
+    benchResume(st);
+    for (i = 0; i < ops; i++) {
+        numbits += nn_reorder_nackmap(reorder, 1, 256, &nack.set, 256, 0);
+    }
+    benchPause(st);
+    if (numbits != 256 * ops || !nn_bitset_isset(nack.set.numbits, nack.set.bits, 0)) {
+        fail("nn_reorder_nackmap");
+    }
+    nn_reorder_free(reorder);
+    nn_defrag_free(defrag);
+    nn_rbufpool_free(rbufpool);
+    return ops;
+}
+
+static const struct bench benches[] = {
+    { "v_writerWrite", "kernel", benchWriterWrite },
+    { "v_dataReaderTake", "kernel", benchReaderTake },
+    { "load_xml_descriptor", "kernel", benchLoadXmlDescriptor },
+    { "c_tableInsert", "database", benchTableInsert },
+    { "c_tableInsert_hashed", "database", benchTableInsertHashed },
+    { "serialize", "ddsi2", benchSerialize },
+    { "deserialize", "ddsi2", benchDeserialize },
+    { "whc_insert", "ddsi2", benchWhcInsert },
+    { "defrag_reorder", "ddsi2", benchDefragReorder },
+    { "defrag_reorder_swapped", "ddsi2", benchDefragReorderSwapped },
+    { "reorder_lossy", "ddsi2", benchReorderLossy },
+    { "reorder_nackmap", "ddsi2", benchReorderNackmap }
+};
+
+/* ------------------------------- set up ------------------------------- */
+
+static void
+getTopic(
+    v_public p,
+    void *arg)
+{
+    struct benchState *st = arg;
+    st->topic = c_keep(v_topic(p));
+    st->type = c_keep(v_topicDataType(st->topic));
+}
+
+static void
+getWriter(
+    v_public p,
+    void *arg)
+{
+    *(v_writer *) arg = c_keep(v_writer(p));
+}
+
+static void
+getReader(
+    v_public p,
+    void *arg)
+{
+    *(v_dataReader *) arg = c_keep(v_dataReader(p));
+}
+
+static void
+setUp(
+    struct benchState *st)
+{
+    u_participantQos pqos;
+    u_topicQos tqos;
+    u_writerQos wqos;
+    u_readerQos rqos;
+    os_libraryAttr attr;
+    os_uint32 i;
+
+    if (u_userInitialise() != U_RESULT_OK) {
+        fail("u_userInitialise");
+    }
+    pqos = u_participantQosNew(NULL);
+    st->participant = u_participantNew(NULL, U_DOMAIN_ID_ANY, 30, "kernel_bench", pqos, TRUE);
+    u_participantQosFree(pqos);
+    if (st->participant == NULL) {
+        fail("u_participantNew");
+    }
+    if (u_domain_load_xml_descriptor(u_participantDomain(st->participant), typeDescriptor) != U_RESULT_OK) {
+        fail("u_domain_load_xml_descriptor");
+    }
+    st->topicInfoDescriptor = u_domain_get_xml_descriptor(u_participantDomain(st->participant), "kernelModule::v_topicInfo");
+    if (st->topicInfoDescriptor == NULL) {
+        fail("u_domain_get_xml_descriptor");
+    }
+    tqos = u_topicQosNew(NULL);
+    tqos->reliability.v.kind = V_RELIABILITY_RELIABLE;
+    st->writeTopic = u_topicNew(st->participant, "KernelBench_write", "KernelBench::Sample", "id", tqos);
+    st->takeTopic = u_topicNew(st->participant, "KernelBench_take", "KernelBench::Sample", "id", tqos);
+    u_topicQosFree(tqos);
+    st->publisher = u_publisherNew(st->participant, "publisher", NULL, TRUE);
+    st->subscriber = u_subscriberNew(st->participant, "subscriber", NULL, TRUE);
+    if (st->writeTopic == NULL || st->takeTopic == NULL || st->publisher == NULL || st->subscriber == NULL) {
+        fail("entity creation");
+    }
+
+    wqos = u_writerQosNew(NULL);
+    wqos->reliability.v.kind = V_RELIABILITY_RELIABLE;
+    st->writer = u_writerNew(st->publisher, "writer", st->writeTopic, wqos);
+    st->takeWriter = u_writerNew(st->publisher, "takeWriter", st->takeTopic, wqos);
+    u_writerQosFree(wqos);
+    rqos = u_readerQosNew(NULL);
+    rqos->reliability.v.kind = V_RELIABILITY_RELIABLE;
+    st->reader = u_dataReaderNew(st->subscriber, "reader", "select * from KernelBench_write", NULL, rqos, TRUE);
+    rqos->history.v.kind = V_HISTORY_KEEPALL;
+    st->takeReader = u_dataReaderNew(st->subscriber, "takeReader", "select * from KernelBench_take", NULL, rqos, TRUE);
+    u_readerQosFree(rqos);
+    if (st->writer == NULL || st->takeWriter == NULL || st->reader == NULL || st->takeReader == NULL) {
+        fail("reader/writer creation");
+    }
+    if (u_entityEnable(u_entity(st->writer)) != U_RESULT_OK ||
+        u_entityEnable(u_entity(st->takeWriter)) != U_RESULT_OK) {
+        fail("u_entityEnable");
+    }
+
+    (void) u_observableAction(u_observable(st->writeTopic), getTopic, st);
+    (void) u_observableAction(u_observable(st->writer), getWriter, &st->vWriter);
+    (void) u_observableAction(u_observable(st->takeWriter), getWriter, &st->vTakeWriter);
+    (void) u_observableAction(u_observable(st->takeReader), getReader, &st->vTakeReader);
+    if (st->topic == NULL || st->vWriter == NULL || st->vTakeWriter == NULL || st->vTakeReader == NULL) {
+        fail("u_observableAction");
+    }
+    if (c_typeSize(st->type) != sizeof(struct sample)) {
+        fail("type layout check");
+    }
+    for (i = 0; i < NR_OF_KEYS; i++) {
+        st->messages[i] = newMessage(st->topic, (c_long) i, (c_long) i);
+    }
+
+    /* The serializer and the writer history are taken from the DDSI2
+     * library, which must not be in use by a service in this process. The
+     * library is linked symbolically, so its globals are looked up in the
+     * library itself rather than referenced from here: a reference from the
+     * executable would resolve to a copy the library never reads. */
+    os_libraryAttrInit(&attr);
+    if ((st->ddsi2 = os_libraryOpen("ddsi2", &attr)) == NULL) {
+        fail("os_libraryOpen(ddsi2)");
+    }
+    st->gv = (struct q_globals *) os_libraryGetSymbol(st->ddsi2, "gv");
+    st->config = (struct config *) os_libraryGetSymbol(st->ddsi2, "config");
+    if (st->gv == NULL || st->config == NULL) {
+        fail("os_libraryGetSymbol(ddsi2)");
+    }
+    if (st->gv->ospl_base != NULL) {
+        fail("check for a DDSI2 service in this process");
+    }
+    st->gv->ospl_base = c_getBase(st->topic);
+    if (st->config->fragment_size == 0) {
+        st->config->fragment_size = 1280;
+    }
+    st->config->xmit_lossiness = lossiness;
+    if (osplser_init() != 0) {
+        fail("osplser_init");
+    }
+    if ((st->sertopic = deftopic(st->topic)) == NULL) {
+        fail("deftopic");
+    }
+    st->serpool = ddsi_serstatepool_new();
+    for (i = 0; i < NR_OF_KEYS; i++) {
+        st->serdata[i] = serialize(st->serpool, st->sertopic, st->messages[i]);
+    }
+}
+
+static void
+tearDown(
+    struct benchState *st)
+{
+    os_uint32 i;
+
+    for (i = 0; i < NR_OF_KEYS; i++) {
+        ddsi_serdata_unref(st->serdata[i]);
+        c_free(st->messages[i]);
+    }
+    ddsi_serstatepool_free(st->serpool);
+    osplser_fini();
+    st->gv->ospl_base = NULL;
+    (void) os_libraryClose(st->ddsi2);
+    c_free(st->vTakeReader);
+    c_free(st->vTakeWriter);
+    c_free(st->vWriter);
+    c_free(st->type);
+    c_free(st->topic);
+    (void) u_objectFree(u_object(st->takeReader));
+    (void) u_objectFree(u_object(st->reader));
+    (void) u_objectFree(u_object(st->takeWriter));
+    (void) u_objectFree(u_object(st->writer));
+    (void) u_objectFree(u_object(st->subscriber));
+    (void) u_objectFree(u_object(st->publisher));
+    (void) u_objectFree(u_object(st->takeTopic));
+    (void) u_objectFree(u_object(st->writeTopic));
+    (void) u_objectFree(u_object(st->participant));
+    os_free(st->topicInfoDescriptor);
+}
+
+static void
+usage(
+    const char *argv0)
+{
+    os_uint32 i;
+
+    fprintf(stderr,
+        "usage: %s [-n ops] [-r repeats] [-l lossiness] [name ...]\n"
+        "  -n  number of operations per repetition (default %u)\n"
+        "  -r  number of repetitions, the fastest is reported (default %d)\n"
+        "  -l  fraction of samples lost in reorder_lossy and reorder_nackmap,\n"
+        "      in units of 1e-3 as XmitLossiness (default %d)\n"
+        "  name  run only the named benchmarks, from:\n",
+        argv0, nrOfOps, nrOfRepeats, lossiness);
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        fprintf(stderr, "        %s (%s)\n", benches[i].name, benches[i].layer);
+    }
+    exit(2);
+}
+
+static int
+selected(
+    const char *name,
+    int argc,
+    char *argv[])
+{
+    int i;
+
+    if (optind == argc) {
+        return 1;
+    }
+    for (i = optind; i < argc; i++) {
+        if (strcmp(argv[i], name) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+    struct benchState st;
+    double nsPerOp, best, allocsPerOp, bestAllocs;
+    os_uint32 ops, i;
+    int opt, r;
+
+    while ((opt = getopt(argc, argv, "n:r:l:")) != -1) {
+        switch (opt) {
+        case 'n': nrOfOps = (os_uint32) atoi(optarg); break;
+        case 'r': nrOfRepeats = atoi(optarg); break;
+        case 'l': lossiness = atoi(optarg); break;
+        default: usage(argv[0]);
+        }
+    }
+    if (nrOfOps < 2 || nrOfRepeats <= 0 || lossiness < 0 || lossiness >= 1000) {
+        usage(argv[0]);
+    }
+    for (r = optind; r < argc; r++) {
+        for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+            if (strcmp(argv[r], benches[i].name) == 0) {
+                break;
+            }
+        }
+        if (i == sizeof(benches) / sizeof(benches[0])) {
+            usage(argv[0]);
+        }
+    }
+
+    memset(&st, 0, sizeof(st));
+    os_heapSetService(countingMalloc, countingRealloc, free);
+    setUp(&st);
+    for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+        if (!selected(benches[i].name, argc, argv)) {
+            continue;
+        }
+        best = bestAllocs = 0.0;
+        ops = 0;
+        for (r = 0; r < nrOfRepeats; r++) {
+            st.elapsed = 0;
+            st.allocs = 0;
+            ops = benches[i].run(&st, nrOfOps);
+            nsPerOp = (double) st.elapsed / ops;
+            allocsPerOp = (double) st.allocs / ops;
+            if (r == 0 || nsPerOp < best) {
+                best = nsPerOp;
+                bestAllocs = allocsPerOp;
+            }
+        }
+        printf("bench=%s layer=%s ops=%u repeats=%d ns_per_op=%.1f allocs_per_op=%.2f\n",
+            benches[i].name, benches[i].layer, ops, nrOfRepeats, best, bestAllocs);
+        fflush(stdout);
+    }
+    tearDown(&st);
+    os_heapSetService(NULL, NULL, NULL);
+    return 0;
+}
@@ -0,0 +1,20 @@
+#
+# included by bld/$(SPLICE_HOST)/makefile
+
+TARGET_EXEC	:= kernel_bench
+
+include	$(OSPL_HOME)/setup/makefiles/target.mak
+
+LDLIBS	+= -lddsi2 -l$(DDS_CORE)
+
+CINCS	+= -I$(OSPL_HOME)/src/database/database/include
+CINCS	+= -I$(OSPL_HOME)/src/database/serialization/include
+CINCS	+= -I$(OSPL_HOME)/src/kernel/include
+CINCS	+= -I$(OSPL_HOME)/src/kernel/code
+CINCS	+= -I$(OSPL_HOME)/src/user/include
+CINCS	+= -I$(OSPL_HOME)/src/user/code
+CINCS	+= -I$(OSPL_HOME)/src/configuration/config/include
+CINCS	+= -I$(OSPL_HOME)/src/utilities/include
+CINCS	+= -I$(OSPL_HOME)/src/services/ddsi2/code
+
+-include $(DEPENDENCIES)
@@ -0,0 +1,314 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+/* pingpong_bench: measures the round-trip latency of a waitset based
+ * ping-pong for the different waiting modes of DDS_WaitSet_set_spin.
+ *
+ * A pong thread waits for samples on the ping topic and echoes them on the
+ * pong topic, the main thread writes a ping and waits for its pong. Each
+ * round trip therefore contains two waitset wake-ups. The round trips are
+ * repeated with both waitsets blocking immediately, spinning for a fixed
+ * time and spinning adaptively. For each mode the benchmark reports the
+ * round-trip percentiles and the process CPU time spent per round trip.
+ * A delay between the round trips shows how the modes behave when events
+ * arrive too far apart for spinning to pay off.
+ */
+
+#include "vortex_os.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "dds_dcps.h"
+#include "PingPongBenchSacDcps.h"
+
+struct endpoint {
+    PingPongBench_SampleDataWriter writer;
+    PingPongBench_SampleDataReader reader;
+    DDS_ReadCondition condition;
+    DDS_WaitSet waitset;
+};
+
+struct mode {
+    const char *name;
+    DDS_Duration_t limit;
+    DDS_boolean adaptive;
+};
+
+static int roundTrips = 10000;
+static int spinUs = 50;
+static int delayUs = 0;
+
+static void
+check(
+    DDS_ReturnCode_t rc,
+    const char *what)
+{
+    if (rc != DDS_RETCODE_OK) {
+        fprintf(stderr, "%s failed: %d\n", what, (int) rc);
+        exit(1);
+    }
+}
+
+static void
+endpointInit(
+    struct endpoint *ep,
+    DDS_Publisher publisher,
+    DDS_Subscriber subscriber,
+    DDS_Topic writeTopic,
+    DDS_Topic readTopic,
+    const DDS_DataWriterQos *wqos,
+    const DDS_DataReaderQos *rqos)
+{
+    ep->writer = DDS_Publisher_create_datawriter(publisher, writeTopic, wqos, NULL, DDS_STATUS_MASK_NONE);
+    ep->reader = DDS_Subscriber_create_datareader(subscriber, readTopic, rqos, NULL, DDS_STATUS_MASK_NONE);
+    if (ep->writer == NULL || ep->reader == NULL) {
+        fprintf(stderr, "endpoint creation failed\n");
+        exit(1);
+    }
+    ep->condition = DDS_DataReader_create_readcondition(ep->reader,
+            DDS_NOT_READ_SAMPLE_STATE, DDS_ANY_VIEW_STATE, DDS_ANY_INSTANCE_STATE);
+    ep->waitset = DDS_WaitSet__alloc();
+    check(DDS_WaitSet_attach_condition(ep->waitset, ep->condition), "attach_condition");
+}
+
+static void
+endpointFini(
+    struct endpoint *ep)
+{
+    check(DDS_WaitSet_detach_condition(ep->waitset, ep->condition), "detach_condition");
+    DDS_free(ep->waitset);
+}
+
+/* Waits for the next sample and takes it; returns its seq. */
+static DDS_long
+receive(
+    struct endpoint *ep)
+{
+    static const DDS_Duration_t timeout = { 10, 0 };
+    DDS_sequence_PingPongBench_Sample samples = { 0, 0, NULL, FALSE };
+    DDS_SampleInfoSeq infos = { 0, 0, NULL, FALSE };
+    DDS_ConditionSeq *active;
+    DDS_long seq = -1;
+
+    active = DDS_ConditionSeq__alloc();
+    while (seq < 0) {
+        check(DDS_WaitSet_wait(ep->waitset, active, &timeout), "wait");
+        check(PingPongBench_SampleDataReader_take_w_condition(ep->reader, &samples, &infos,
+                DDS_LENGTH_UNLIMITED, ep->condition), "take");
+        if (samples._length > 0) {
+            seq = samples._buffer[samples._length - 1].seq;
+        }
+        (void) PingPongBench_SampleDataReader_return_loan(ep->reader, &samples, &infos);
+    }
+    DDS_free(active);
+    return seq;
+}
+
+static void *
+pongThread(
+    void *varg)
+{
+    struct endpoint *ep = varg;
+    PingPongBench_Sample s;
+
+    memset(&s, 0, sizeof(s));
+    do {
+        s.seq = receive(ep);
+        check(PingPongBench_SampleDataWriter_write(ep->writer, &s, DDS_HANDLE_NIL), "write");
+    } while (s.seq != 0);
+    return NULL;
+}
+
+static os_duration
+cpuTime(void)
+{
+    struct rusage u;
+
+    (void) getrusage(RUSAGE_SELF, &u);
+    return (os_duration) (u.ru_utime.tv_sec + u.ru_stime.tv_sec) * OS_DURATION_SECOND +
+           (os_duration) (u.ru_utime.tv_usec + u.ru_stime.tv_usec) * 1000;
+}
+
+static int
+compareDuration(
+    const void *va,
+    const void *vb)
+{
+    const os_duration *a = va, *b = vb;
+    return (*a < *b) ? -1 : (*a > *b);
+}
+
+static void
+usage(
+    const char *argv0)
+{
+    fprintf(stderr,
+        "usage: %s [-n roundtrips] [-s spin_us] [-d delay_us]\n"
+        "  -n  number of round trips per mode (default %d)\n"
+        "  -s  spin limit of the fixed and adaptive modes in us (default %d)\n"
+        "  -d  delay between round trips in us (default %d)\n",
+        argv0, roundTrips, spinUs, delayUs);
+    exit(2);
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+    DDS_DomainParticipantFactory factory;
+    DDS_DomainParticipant participant;
+    PingPongBench_SampleTypeSupport ts;
+    DDS_TopicQos *tqos;
+    DDS_DataWriterQos *wqos;
+    DDS_DataReaderQos *rqos;
+    DDS_Topic pingTopic, pongTopic;
+    DDS_Publisher publisher;
+    DDS_Subscriber subscriber;
+    struct endpoint ping, pong;
+    struct mode modes[3];
+    PingPongBench_Sample s;
+    os_duration *rtt, cpu;
+    os_threadId tid;
+    os_threadAttr attr;
+    os_timeM t0;
+    char *typeName;
+    int opt, m, i;
+
+    while ((opt = getopt(argc, argv, "n:s:d:")) != -1) {
+        switch (opt) {
+        case 'n': roundTrips = atoi(optarg); break;
+        case 's': spinUs = atoi(optarg); break;
+        case 'd': delayUs = atoi(optarg); break;
+        default: usage(argv[0]);
+        }
+    }
+    if (roundTrips <= 0 || spinUs <= 0 || spinUs >= 1000000 || delayUs < 0) {
+        usage(argv[0]);
+    }
+    modes[0].name = "block";
+    modes[0].limit.sec = 0;
+    modes[0].limit.nanosec = 0;
+    modes[0].adaptive = FALSE;
+    modes[1].name = "spin";
+    modes[1].limit.sec = 0;
+    modes[1].limit.nanosec = (DDS_unsigned_long) spinUs * 1000;
+    modes[1].adaptive = FALSE;
+    modes[2].name = "adaptive";
+    modes[2].limit = modes[1].limit;
+    modes[2].adaptive = TRUE;
+
+    factory = DDS_DomainParticipantFactory_get_instance();
+    participant = DDS_DomainParticipantFactory_create_participant(factory, DDS_DOMAIN_ID_DEFAULT,
+            DDS_PARTICIPANT_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE);
+    if (participant == NULL) {
+        fprintf(stderr, "create_participant failed\n");
+        return 1;
+    }
+    ts = PingPongBench_SampleTypeSupport__alloc();
+    typeName = PingPongBench_SampleTypeSupport_get_type_name(ts);
+    check(PingPongBench_SampleTypeSupport_register_type(ts, participant, typeName), "register_type");
+
+    tqos = DDS_TopicQos__alloc();
+    check(DDS_DomainParticipant_get_default_topic_qos(participant, tqos), "get_default_topic_qos");
+    tqos->reliability.kind = DDS_RELIABLE_RELIABILITY_QOS;
+    tqos->history.kind = DDS_KEEP_ALL_HISTORY_QOS;
+    pingTopic = DDS_DomainParticipant_create_topic(participant, "PingPongBench_ping", typeName, tqos, NULL, DDS_STATUS_MASK_NONE);
+    pongTopic = DDS_DomainParticipant_create_topic(participant, "PingPongBench_pong", typeName, tqos, NULL, DDS_STATUS_MASK_NONE);
+    publisher = DDS_DomainParticipant_create_publisher(participant, DDS_PUBLISHER_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE);
+    subscriber = DDS_DomainParticipant_create_subscriber(participant, DDS_SUBSCRIBER_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE);
+    if (pingTopic == NULL || pongTopic == NULL || publisher == NULL || subscriber == NULL) {
+        fprintf(stderr, "entity creation failed\n");
+        return 1;
+    }
+    wqos = DDS_DataWriterQos__alloc();
+    check(DDS_Publisher_get_default_datawriter_qos(publisher, wqos), "get_default_datawriter_qos");
+    check(DDS_Publisher_copy_from_topic_qos(publisher, wqos, tqos), "copy_from_topic_qos");
+    rqos = DDS_DataReaderQos__alloc();
+    check(DDS_Subscriber_get_default_datareader_qos(subscriber, rqos), "get_default_datareader_qos");
+    check(DDS_Subscriber_copy_from_topic_qos(subscriber, rqos, tqos), "copy_from_topic_qos");
+
+    endpointInit(&ping, publisher, subscriber, pingTopic, pongTopic, wqos, rqos);
+    endpointInit(&pong, publisher, subscriber, pongTopic, pingTopic, wqos, rqos);
+
+    rtt = os_malloc(sizeof(*rtt) * (size_t) roundTrips);
+    cpu = 0;
+    memset(&s, 0, sizeof(s));
+    os_threadAttrInit(&attr);
+    for (m = 0; m < 3; m++) {
+        check(DDS_WaitSet_set_spin(ping.waitset, &modes[m].limit, modes[m].adaptive), "set_spin");
+        check(DDS_WaitSet_set_spin(pong.waitset, &modes[m].limit, modes[m].adaptive), "set_spin");
+        if (os_threadCreate(&tid, "pong", &attr, pongThread, &pong) != os_resultSuccess) {
+            fprintf(stderr, "os_threadCreate failed\n");
+            return 1;
+        }
+        /* Warm up, then measure; seq 0 tells the pong thread to stop */
+        for (i = -roundTrips / 10; i < roundTrips; i++) {
+            if (delayUs > 0) {
+                os_sleep(OS_DURATION_INIT(delayUs / 1000000, (delayUs % 1000000) * 1000));
+            }
+            if (i == 0) {
+                cpu = cpuTime();
+            }
+            s.seq = i + roundTrips + 1;
+            t0 = os_timeMGet();
+            check(PingPongBench_SampleDataWriter_write(ping.writer, &s, DDS_HANDLE_NIL), "write");
+            if (receive(&ping) != s.seq) {
+                fprintf(stderr, "unexpected pong\n");
+                return 1;
+            }
+            if (i >= 0) {
+                rtt[i] = os_timeMDiff(os_timeMGet(), t0);
+            }
+        }
+        cpu = cpuTime() - cpu;
+        s.seq = 0;
+        check(PingPongBench_SampleDataWriter_write(ping.writer, &s, DDS_HANDLE_NIL), "write");
+        (void) receive(&ping);
+        (void) os_threadWaitExit(tid, NULL);
+
+        qsort(rtt, (size_t) roundTrips, sizeof(*rtt), compareDuration);
+        printf("mode=%s spin_us=%d delay_us=%d roundtrips=%d rtt_us min=%.1f p50=%.1f p90=%.1f p99=%.1f max=%.1f "
+               "cpu_us_per_roundtrip=%.1f\n",
+            modes[m].name, (m == 0) ? 0 : spinUs, delayUs, roundTrips,
+            os_durationToReal(rtt[0]) * 1e6,
+            os_durationToReal(rtt[roundTrips / 2]) * 1e6,
+            os_durationToReal(rtt[(roundTrips * 9) / 10]) * 1e6,
+            os_durationToReal(rtt[(roundTrips * 99) / 100]) * 1e6,
+            os_durationToReal(rtt[roundTrips - 1]) * 1e6,
+            os_durationToReal(cpu) * 1e6 / roundTrips);
+    }
+    os_free(rtt);
+
+    endpointFini(&ping);
+    endpointFini(&pong);
+    DDS_free(rqos);
+    DDS_free(wqos);
+    DDS_free(tqos);
+    DDS_free(typeName);
+    DDS_free(ts);
+    (void) DDS_DomainParticipant_delete_contained_entities(participant);
+    (void) DDS_DomainParticipantFactory_delete_participant(factory, participant);
+    return 0;
+}
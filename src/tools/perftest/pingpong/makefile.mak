@@ -0,0 +1,17 @@
+#
+# included by bld/$(SPLICE_HOST)/makefile
+
+TARGET_EXEC	:= pingpong_bench
+
+include	$(OSPL_HOME)/setup/makefiles/test_idl_c.mak
+include	$(OSPL_HOME)/setup/makefiles/target.mak
+
+LDLIBS	+= -l$(DDS_DCPSSAC) -l$(DDS_CORE)
+
+CINCS	+= -I$(OSPL_HOME)/src/api/dcps/sac/include
+CINCS	+= -I$(OSPL_HOME)/src/api/dcps/sac/bld/$(SPLICE_TARGET)
+CINCS	+= -I$(OSPL_HOME)/src/database/database/include
+CINCS	+= -I$(OSPL_HOME)/src/kernel/include
+CINCS	+= -I$(OSPL_HOME)/src/user/include
+
+-include $(DEPENDENCIES)
@@ -169,6 +169,8 @@ C_STRUCT(u_waitset) {
     u_bool eventsEnabled;
     os_boolean notifyDetached;
     pa_uint32_t useCount;
+    os_duration spinLimit;
+    u_bool spinAdaptive;
 };
 
 C_STRUCT(u_listener) {
@@ -51,6 +51,7 @@
 #include "v_cfData.h"
 #include "v_processInfo.h"
 #include "v_typeRepresentation.h"
+#include "v_latencyTrace.h"
 #include "os_atomics.h"
 
 #define IGNORE_THREAD_MESSAGE os_threadMemFree(OS_THREAD_WARNING)
@@ -364,6 +365,25 @@ GetDomainConfig(
                     } /* No attribute enabled, so use default value */
                 } /* No 'PriorityInheritance' element, so use default value */
 
+                child = cf_element(cf_elementChild(dc, CFG_LOCKPROFILING));
+                if (child != NULL) {
+                    child = cf_element(cf_elementChild(child, CFG_SAMPLERATE));
+                    if (child != NULL) {
+                        elementData = cf_data(cf_elementChild(child, "#text"));
+                        if (elementData != NULL) {
+                            os_uint32 rate;
+                            value = cf_dataValue(elementData);
+                            if (sscanf(value.is.String, "%u", &rate) == 1) {
+                                os_mutexProfileSetRate(rate);
+                            } else {
+                                OS_REPORT(OS_WARNING, OSRPT_CNTXT_USER, U_RESULT_ILL_PARAM,
+                                    "Incorrect <LockProfiling/SampleRate> parameter for Domain: \"%s\","
+                                    " lock contention profiling remains disabled",value.is.String);
+                            }
+                        }
+                    }
+                } /* No 'LockProfiling' element, so profiling remains disabled */
+
                 GetDomainConfigSystemId(dc, domainConfig);
 
                 child = cf_element(cf_elementChild(dc, CFG_REPORT));
@@ -1102,6 +1122,31 @@ u__userDetachWrapper(void)
     u_userDetach(U_USER_DELETE_ENTITIES);
 }
 
+/* Sleeps before the next attempt to attach to a domain that may still be
+ * under construction. The delay starts short and doubles up to a second, so
+ * an attach that races with the startup of spliced completes promptly while
+ * a long wait does not poll excessively. Returns FALSE once the deadline has
+ * passed.
+ */
+static os_boolean
+u__domainAttachBackoff(
+    os_timeM deadline,
+    os_duration *delay)
+{
+    os_duration left = os_timeMDiff(deadline, os_timeMGet());
+
+    if (left <= 0) {
+        return OS_FALSE;
+    }
+    os_sleep((*delay < left) ? *delay : left);
+    if (*delay < OS_DURATION_SECOND / 2) {
+        *delay *= 2;
+    } else {
+        *delay = OS_DURATION_SECOND;
+    }
+    return OS_TRUE;
+}
+
 u_result
 u__domainOpen(
     u_domain *domain,
@@ -1311,16 +1356,18 @@ u__domainOpen(
             u_userSetupSignalHandling(FALSE);
             result = startSplicedWithinProcess(&spliced_thread, uri);
             if (result == U_RESULT_OK) {
-                int count = 0;
-                os_duration delay_100ms = OS_DURATION_INIT(0, 100000000);
-
-                /* wait for up to 5 seconds for the domain to be available in this process */
-                while (count < 50) {
-                    os_sleep(delay_100ms);
+                os_timeM deadline = os_timeMAdd(os_timeMGet(), OS_DURATION_INIT(5, 0));
+                os_duration delay_10ms = OS_DURATION_INIT(0, 10000000);
+
+                /* wait for up to 5 seconds for spliced to have completed its
+                 * startup in this process, bail out early if it has already
+                 * given up again */
+                do {
+                    os_sleep(delay_10ms);
                     if (*domain == NULL) {
                         *domain = u_userLookupDomain(domainCfg.id);
                     }
-                    if ((*domain != NULL) && (count > 10)) {
+                    if ((*domain != NULL) && u_splicedInProcessReady()) {
                         os_free(domainCfg.name);
                         (*domain)->spliced_thread = spliced_thread;
 #ifdef INCLUDE_PLUGGABLE_REPORTING
@@ -1328,8 +1375,9 @@ u__domainOpen(
 #endif
                         return U_RESULT_OK;
                     }
-                    count++;
-                }
+                } while (((*domain == NULL) || u_splicedInProcess()) &&
+                         (os_timeMCompare(os_timeMGet(), deadline) == OS_LESS));
+                *domain = NULL;
                 result = U_RESULT_INTERNAL_ERROR;
                 OS_REPORT_WID(OS_ERROR,"user::u_domain::u_domainOpen",result,domainCfg.id,
                             "Domain '%s' has not been started successfully\n", domainCfg.name);
@@ -1365,15 +1413,17 @@ u__domainOpen(
  * Try to attach to existing shared memory segment.
  */
         if (result == U_RESULT_OK) {
-            os_duration pollDelay = OS_DURATION_INIT(1,0);
+            os_duration pollDelay = OS_DURATION_INIT(0, 10000000);
+            os_timeM deadline = os_timeMGet();
             os_result osr;
 
+            if (timeout > 0) {
+                deadline = os_timeMAdd(deadline, OS_DURATION_INIT(timeout, 0));
+            }
             osr = os_sharedMemoryAttach(shm);
             IGNORE_THREAD_MESSAGE;
-            while ((timeout > 0) && (osr != os_resultSuccess)) {
-                os_sleep(pollDelay);
+            while ((osr != os_resultSuccess) && u__domainAttachBackoff(deadline, &pollDelay)) {
                 osr = os_sharedMemoryAttach(shm);
-                timeout--;
                 PRINT_THREAD_MESSAGE("u_domainOpen");
             }
             if (osr != os_resultSuccess) {
@@ -1391,10 +1441,8 @@ u__domainOpen(
                 v_kernel kernel;
 
                 base = c_open(DATABASE_NAME, os_sharedAddress(shm));
-                while ((timeout > 0) && (base == NULL)) {
-                    os_sleep(pollDelay);
+                while ((base == NULL) && u__domainAttachBackoff(deadline, &pollDelay)) {
                     base = c_open(DATABASE_NAME, os_sharedAddress(shm));
-                    timeout--;
                 }
                 if (base == NULL) {
                     result = U_RESULT_INTERNAL_ERROR;
@@ -1406,10 +1454,8 @@ u__domainOpen(
  */
                 if (result == U_RESULT_OK) {
                     kernel = v_kernelAttach(base, KERNEL_NAME, &procInfo);
-                    while ((timeout > 0) && (kernel == NULL)) {
-                        os_sleep(pollDelay);
+                    while ((kernel == NULL) && u__domainAttachBackoff(deadline, &pollDelay)) {
                         kernel = v_kernelAttach(base, KERNEL_NAME, &procInfo);
-                        timeout--;
                     }
                     if (kernel == NULL) {
                         result = U_RESULT_INTERNAL_ERROR;
@@ -2704,6 +2750,26 @@ u_domainEnableStatistics(
     return result;
 }
 
+u_result
+u_domainSetLatencyTraceRate(
+    const u_domain _this,
+    os_uint32 rate)
+{
+    v_kernel kernel;
+    u_result result;
+
+    assert(_this != NULL);
+
+    result = u_observableReadClaim(u_observable(_this), (v_public*)(&kernel), C_MM_RESERVATION_NO_CHECK);
+    if (result == U_RESULT_OK) {
+        assert(kernel);
+        v_latencyTraceSetRate(kernel, rate);
+        u_observableRelease(u_observable(_this), C_MM_RESERVATION_NO_CHECK);
+    }
+
+    return result;
+}
+
 void
 u_domainIdSetThreadSpecific(
     _In_ u_domain domain)
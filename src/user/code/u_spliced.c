@@ -37,8 +37,13 @@
 
 #include "v_leaseManager.h"
 #include "os_report.h"
+#include "os_atomics.h"
 
 static u_bool splicedStartedInThisProcess = FALSE;
+/* Set by spliced once its startup sequence has completed, so that an
+ * application that started spliced within its own process does not have to
+ * guess how long that takes. */
+static pa_uint32_t splicedReadyInThisProcess = PA_UINT32_INIT(0);
 
 /**************************************************************
  * Private functions
@@ -359,6 +364,7 @@ void
 u_splicedSetInProcess(c_bool flag)
 {
     splicedStartedInThisProcess = flag;
+    pa_st32(&splicedReadyInThisProcess, 0);
 }
 
 u_bool
@@ -367,6 +373,19 @@ u_splicedInProcess(void)
     return splicedStartedInThisProcess;
 }
 
+void
+u_splicedSetInProcessReady(void)
+{
+    assert(splicedStartedInThisProcess);
+    pa_st32(&splicedReadyInThisProcess, 1);
+}
+
+u_bool
+u_splicedInProcessReady(void)
+{
+    return (pa_ld32(&splicedReadyInThisProcess) != 0);
+}
+
 u_result
 u_splicedCleanupProcessInfo(
     const u_spliced spliced,
@@ -179,6 +179,8 @@ u_waitsetNew(void)
         _this->eventsEnabled = OS_TRUE;
         _this->notifyDetached = OS_FALSE;
         pa_st32(&_this->useCount, 0);
+        _this->spinLimit = OS_DURATION_ZERO;
+        _this->spinAdaptive = FALSE;
 
         os_mutexInit(&_this->mutex, NULL);
         os_condInit(&_this->cv, &_this->mutex, NULL);
@@ -548,6 +550,9 @@ u_waitsetAttach(
             if (result == U_RESULT_OK) {
                 entry = u_waitsetEntryNew(_this, domain, _this->eventMask);
                 if (entry != NULL) {
+                    if (_this->spinLimit != OS_DURATION_ZERO) {
+                        (void)u_waitsetEntrySetSpin(entry, _this->spinLimit, _this->spinAdaptive);
+                    }
                     _this->entries = c_iterInsert(_this->entries, entry);
                     changed = TRUE;
                 }
@@ -728,6 +733,54 @@ u_waitsetSetEventMask(
     return result;
 }
 
+struct spinArg {
+    os_duration limit;
+    u_bool adaptive;
+};
+
+static void
+set_spin(
+    void *o,
+    c_iterResolveCompareArg arg)
+{
+    struct spinArg *spin = (struct spinArg *)arg;
+    u_result result;
+
+    result = u_waitsetEntrySetSpin(u_waitsetEntry(o), spin->limit, spin->adaptive);
+    assert(result == U_RESULT_OK);
+    OS_UNUSED_ARG(result);
+}
+
+u_result
+u_waitsetSetSpin(
+    const u_waitset _this,
+    os_duration limit,
+    u_bool adaptive)
+{
+    struct spinArg spin;
+    u_result result;
+    os_result osr;
+
+    assert(_this != NULL);
+    assert(OS_DURATION_ISPOSITIVE(limit));
+
+    osr = os_mutexLock_s(&_this->mutex);
+    if (osr == os_resultSuccess) {
+        _this->spinLimit = limit;
+        _this->spinAdaptive = adaptive;
+        spin.limit = limit;
+        spin.adaptive = adaptive;
+        c_iterWalk(_this->entries, set_spin, &spin);
+        os_mutexUnlock(&_this->mutex);
+        result = U_RESULT_OK;
+    } else {
+        result = U_RESULT_INTERNAL_ERROR;
+        OS_REPORT(OS_WARNING, "u_waitsetSetSpin", result,
+                  "Could not claim waitset.");
+    }
+    return result;
+}
+
 u_result
 u_waitsetDetachFromDomain(
     _Inout_ u_waitset _this,
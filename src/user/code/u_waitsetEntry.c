@@ -501,3 +501,37 @@ u_waitsetEntrySetEventMask(
     return result;
 }
 
+u_result
+u_waitsetEntrySetSpin(
+    const u_waitsetEntry _this,
+    os_duration limit,
+    u_bool adaptive)
+{
+    v_waitset kWaitset;
+    u_result result;
+    u_domain domain;
+
+    assert(_this != NULL);
+
+    domain = u_observableDomain(u_observable(_this));
+    result = u_domainProtect(domain);
+    if (result == U_RESULT_OK) {
+        result = u_handleClaim(_this->handle, &kWaitset);
+        if (result == U_RESULT_OK) {
+            assert(kWaitset);
+            if (C_TYPECHECK(kWaitset,v_waitset)) {
+                v_waitsetSetSpin(kWaitset, limit, adaptive);
+            } else {
+                result = U_RESULT_CLASS_MISMATCH;
+                OS_REPORT(OS_ERROR, "u_waitsetEntrySetSpin", result,
+                          "Class mismatch.");
+            }
+            (void)u_handleRelease(_this->handle);
+        } else {
+            OS_REPORT(OS_ERROR, "u_waitsetEntrySetSpin", result,
+                      "Could not claim waitset.");
+        }
+        u_domainUnprotect();
+    }
+    return result;
+}
@@ -78,4 +78,10 @@ u_waitsetEntrySetEventMask(
     const u_waitsetEntry _this,
     c_ulong eventMask);
 
+u_result
+u_waitsetEntrySetSpin(
+    const u_waitsetEntry _this,
+    os_duration limit,
+    u_bool adaptive);
+
 #endif
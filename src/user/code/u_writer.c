@@ -303,9 +303,10 @@ u_writeWithHandleAction(
                 if (message) {
                     to = (void *) (message + 1);
                     copyResult = copy(v_topicDataType(writer->topic), data, to);
-                    V_MESSAGE_STAMP(message,writerAllocTime);
 
-                    if (!V_COPYIN_RESULT_IS_OK(copyResult)) {
+                    if (V_COPYIN_RESULT_IS_OK(copyResult)) {
+                        v_messageSetKeyHash(message, writer->topic);
+                    } else {
                         c_free(message);
                         if (V_COPYIN_RESULT_IS_OUT_OF_MEMORY(copyResult)) {
                             result = U_RESULT_OUT_OF_MEMORY;
@@ -386,6 +387,84 @@ u_writerWrite(
     return result;
 }
 
+/* -------------------------------- u_writerWriteBatch ---------------------- */
+
+u_result
+u_writerWriteBatch(
+    const u_writer _this,
+    u_writerCopy copy,
+    void *data[],
+    os_uint32 length,
+    os_timeW timestamp)
+{
+    u_result result;
+    v_writer writer;
+    v_message *messages;
+    v_copyin_result copyResult;
+    os_uint32 i, n;
+
+    assert(_this != NULL);
+    assert(copy != NULL);
+    assert((data != NULL) || (length == 0));
+
+    if (!u_entityEnabled(u_entity(_this))) {
+        result = U_RESULT_PRECONDITION_NOT_MET;
+        OS_REPORT(OS_ERROR, "u_writerWriteBatch", result,
+                  "Precondition not met: DataWriter is not enabled");
+        return result;
+    }
+    if (length == 0) {
+        return U_RESULT_OK;
+    }
+    messages = os_malloc(length * sizeof(*messages));
+
+    result = u_observableWriteClaim(u_observable(_this), (v_public *)(&writer), C_MM_RESERVATION_ZERO);
+    if ((result == U_RESULT_OK) && (writer != NULL)) {
+        for (n = 0; (n < length) && (result == U_RESULT_OK); n++) {
+            if (data[n] == NULL) {
+                result = U_RESULT_ILL_PARAM;
+                OS_REPORT(OS_ERROR, "u_writerWriteBatch", result,
+                          "Bad parameter: Data = NULL");
+            } else if ((messages[n] = v_topicMessageNew_s(writer->topic)) == NULL) {
+                result = U_RESULT_OUT_OF_MEMORY;
+                OS_REPORT(OS_ERROR, "u_writerWriteBatch", result,
+                          "Out of memory: unable to create message for Topic '%s'.",
+                          u_writerTopicName(writer));
+            } else {
+                copyResult = copy(v_topicDataType(writer->topic), data[n], (void *)(messages[n] + 1));
+                if (V_COPYIN_RESULT_IS_OK(copyResult)) {
+                    v_messageSetKeyHash(messages[n], writer->topic);
+                } else {
+                    c_free(messages[n]);
+                    if (V_COPYIN_RESULT_IS_OUT_OF_MEMORY(copyResult)) {
+                        result = U_RESULT_OUT_OF_MEMORY;
+                        OS_REPORT(OS_ERROR, "u_writerWriteBatch", result,
+                                  "Out of memory: unable to create message for Topic '%s'.",
+                                  u_writerTopicName(writer));
+                    } else {
+                        result = U_RESULT_ILL_PARAM;
+                        OS_REPORT(OS_ERROR, "u_writerWriteBatch", result,
+                                  "Bad parameter: Data is invalid.");
+                    }
+                }
+            }
+        }
+        if (result == U_RESULT_OK) {
+            result = u_resultFromKernelWriteResult(
+                         v_writerWriteBatch(writer, messages, length, timestamp));
+        } else {
+            /* The failed message has not been created or is freed already */
+            n--;
+        }
+        for (i = 0; i < n; i++) {
+            c_free(messages[i]);
+        }
+        u_observableRelease(u_observable(_this), C_MM_RESERVATION_ZERO);
+    }
+    os_free(messages);
+    return result;
+}
+
 /* -------------------------------- u_writerDispose ------------------------- */
 
 u_result
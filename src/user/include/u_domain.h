@@ -267,6 +267,14 @@ u_domainEnableStatistics(
     const u_domain _this,
     const os_char *categoryName);
 
+/* Sets the sample rate of the kernel latency tracer for all processes in the
+ * domain: 0 disables tracing, N traces 1 in N messages. See v_latencyTrace.h.
+ */
+OS_API u_result
+u_domainSetLatencyTraceRate(
+    const u_domain _this,
+    os_uint32 rate);
+
 #undef OS_API
 
 #if defined (__cplusplus)
@@ -86,6 +86,18 @@ u_splicedSetInProcess(
 OS_API u_bool
 u_splicedInProcess(void);
 
+/**
+ * \brief Marks the spliced running in this process as fully started.
+ *
+ * Called by spliced after its services and applications have been started;
+ * reset by u_splicedSetInProcess.
+ */
+OS_API void
+u_splicedSetInProcessReady(void);
+
+OS_API u_bool
+u_splicedInProcessReady(void);
+
 OS_API u_result
 u_splicedCleanupProcessInfo(
     const u_spliced spliced,
@@ -98,6 +98,18 @@ u_waitsetSetEventMask(
     const u_waitset _this,
     u_eventMask eventMask);
 
+/**
+ * Makes waits on this waitset poll for events for at most limit before
+ * blocking. OS_DURATION_ZERO (the default) disables spinning. When adaptive
+ * is set, limit is an upper bound and the actual spin time follows the
+ * recently observed wait times.
+ */
+OS_API u_result
+u_waitsetSetSpin(
+    const u_waitset _this,
+    os_duration limit,
+    u_bool adaptive);
+
 OS_API os_int32
 u_waitsetGetDomainId(
     u_waitset _this);
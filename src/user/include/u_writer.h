@@ -104,6 +104,30 @@ u_writerWrite (
     os_timeW timestamp,
     u_instanceHandle handle);
 
+/**
+ * \brief Writes a batch of samples.
+ *
+ * Equivalent to calling u_writerWrite with a nil instance handle for each
+ * sample in turn, but the writer is claimed and locked once and readers are
+ * triggered once for the whole batch. All samples get the same timestamp.
+ * Writing stops at the first sample that cannot be written.
+ *
+ * \param _this     The writer.
+ * \param copy      The copy method, invoked for each element of data.
+ * \param data      The samples, in the form expected by copy.
+ * \param length    The number of samples in data.
+ * \param timestamp The source timestamp of the samples.
+ * \return          The result of the first sample that failed, or
+ *                  U_RESULT_OK.
+ */
+OS_API u_result
+u_writerWriteBatch (
+    const u_writer _this,
+    u_writerCopy copy,
+    void *data[],
+    os_uint32 length,
+    os_timeW timestamp);
+
 OS_API u_result
 u_writerDispose (
     const u_writer _this,
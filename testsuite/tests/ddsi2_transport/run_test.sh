@@ -0,0 +1,104 @@
+#!/bin/sh
+#
+# Runs a publisher and a subscriber as two processes, each with its own
+# single process domain and DDSI2 service, and checks that all samples make
+# it across the DDSI2 transport under test:
+#
+#   run_test.sh shm        shared memory transport (General/Transport=shm)
+#   run_test.sh udp        plain UDP on the loopback interface, as a
+#                          reference
+#   run_test.sh raweth [IF1 IF2]
+#                          raw ethernet with the packet receive ring
+#                          (Internal/PacketRing/Enable), publisher on IF1
+#                          and subscriber on IF2. Without interfaces, a
+#                          veth pair is created for the duration of the
+#                          test, which requires root. Raw ethernet needs
+#                          broadcast capable interfaces, so loopback won't
+#                          do. PACKET_RING=false disables the ring.
+#
+# Requires a release.com'd environment (OSPL_HOME, idlpp on PATH) and a C
+# compiler. SAMPLES and PAYLOAD override the number and size of the samples,
+# CC, CFLAGS and LDFLAGS the way the test program is built.
+
+TRANSPORT=${1:-shm}
+SAMPLES=${SAMPLES:-2000}
+PAYLOAD=${PAYLOAD:-1000}
+
+if [ -z "$OSPL_HOME" ]; then
+    echo "OSPL_HOME not set"
+    exit 2
+fi
+
+case $TRANSPORT in
+    shm)
+        PUB_INTERFACE=auto
+        SUB_INTERFACE=auto
+        TRANSPORT_TEST_MULTICAST=true
+        TRANSPORT_TEST_PEER=[all]
+        TRANSPORT_TEST_PACKET_RING=false
+        TRANSPORT_TEST_MAX_MESSAGE_SIZE=4096B
+        ;;
+    udp)
+        PUB_INTERFACE=127.0.0.1
+        SUB_INTERFACE=127.0.0.1
+        TRANSPORT_TEST_MULTICAST=false
+        TRANSPORT_TEST_PEER=127.0.0.1
+        TRANSPORT_TEST_PACKET_RING=false
+        TRANSPORT_TEST_MAX_MESSAGE_SIZE=4096B
+        ;;
+    raweth)
+        if [ -n "$2" ] && [ -n "$3" ]; then
+            PUB_INTERFACE=$2
+            SUB_INTERFACE=$3
+        else
+            PUB_INTERFACE=ddsi2tt0
+            SUB_INTERFACE=ddsi2tt1
+            ip link add $PUB_INTERFACE type veth peer name $SUB_INTERFACE || exit 2
+            trap "ip link del $PUB_INTERFACE" EXIT
+            ip link set $PUB_INTERFACE up && ip link set $SUB_INTERFACE up || exit 2
+        fi
+        TRANSPORT_TEST_MULTICAST=true
+        TRANSPORT_TEST_PEER=[ff:ff:ff:ff:ff:ff]
+        TRANSPORT_TEST_PACKET_RING=${PACKET_RING:-true}
+        # Frames must fit the MTU of the interfaces
+        TRANSPORT_TEST_MAX_MESSAGE_SIZE=1400B
+        ;;
+    *)
+        echo "unknown transport $TRANSPORT"
+        exit 2
+        ;;
+esac
+TRANSPORT_TEST_TRANSPORT=$TRANSPORT
+export TRANSPORT_TEST_TRANSPORT TRANSPORT_TEST_MULTICAST TRANSPORT_TEST_PEER TRANSPORT_TEST_PACKET_RING
+export TRANSPORT_TEST_MAX_MESSAGE_SIZE
+
+SRC_DIR=`cd \`dirname $0\` && pwd`
+WORK_DIR=${WORK_DIR:-`mktemp -d`}
+mkdir -p $WORK_DIR
+cd $WORK_DIR || exit 2
+
+# Build the test program
+idlpp -S -l c $SRC_DIR/TransportTest.idl || exit 2
+${CC:-cc} -o transport_test -I. $CFLAGS \
+    -I$OSPL_HOME/include -I$OSPL_HOME/include/sys -I$OSPL_HOME/include/dcps/C/SAC \
+    $SRC_DIR/transport_test.c TransportTestSacDcps.c TransportTestSplDcps.c \
+    $LDFLAGS -L$OSPL_HOME/lib -ldcpssac -lddskernel || exit 2
+
+OSPL_URI=file://$SRC_DIR/ospl_transport.xml
+export OSPL_URI
+
+TRANSPORT_TEST_INTERFACE=$SUB_INTERFACE TRANSPORT_TEST_TRACE=$WORK_DIR/ddsi2-sub.log ./transport_test sub $SAMPLES $PAYLOAD > sub.out 2>&1 &
+SUB_PID=$!
+sleep 2
+TRANSPORT_TEST_INTERFACE=$PUB_INTERFACE TRANSPORT_TEST_TRACE=$WORK_DIR/ddsi2-pub.log ./transport_test pub $SAMPLES $PAYLOAD > pub.out 2>&1
+PUB_RESULT=$?
+wait $SUB_PID
+SUB_RESULT=$?
+
+cat pub.out sub.out
+if [ $PUB_RESULT -eq 0 ] && [ $SUB_RESULT -eq 0 ]; then
+    echo "PASS: ddsi2 $TRANSPORT transport, $SAMPLES samples of $PAYLOAD bytes"
+    exit 0
+fi
+echo "FAIL: ddsi2 $TRANSPORT transport (logs in $WORK_DIR)"
+exit 1
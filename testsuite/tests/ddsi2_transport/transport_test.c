@@ -0,0 +1,247 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+/* transport_test: publisher and subscriber of a reliable, keep-all topic,
+ * run as two processes that each have their own single process domain and
+ * thus their own DDSI2 service. Everything they exchange therefore crosses
+ * the transport configured for DDSI2.
+ *
+ *   transport_test pub <samples> <payload size>
+ *   transport_test sub <samples> <payload size>
+ *
+ * The subscriber checks that every sample arrives exactly once, in order and
+ * with an intact payload, and exits with 0 only if that is the case. The
+ * publisher keeps its DDSI2 service running until the subscriber has left.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "dds_dcps.h"
+#include "TransportTestSacDcps.h"
+
+#define TOPIC_NAME "TransportTest"
+
+static int
+fail(
+    const char *what)
+{
+    fprintf(stderr, "transport_test: %s failed\n", what);
+    return 1;
+}
+
+static DDS_octet
+payloadByte(
+    DDS_long seq,
+    DDS_unsigned_long i)
+{
+    return (DDS_octet) ((DDS_unsigned_long) seq * 31u + i);
+}
+
+static int
+publish(
+    DDS_DomainParticipant dp,
+    DDS_Topic topic,
+    const DDS_TopicQos *tqos,
+    DDS_long samples,
+    DDS_unsigned_long size)
+{
+    DDS_Publisher pub;
+    DDS_DataWriterQos *wqos;
+    TransportTest_MsgDataWriter writer;
+    DDS_PublicationMatchedStatus status;
+    DDS_Duration_t ackTimeout = { 30, 0 };
+    TransportTest_Msg msg;
+    DDS_long i;
+    DDS_unsigned_long j;
+    int tries = 0;
+
+    if ((pub = DDS_DomainParticipant_create_publisher(dp, DDS_PUBLISHER_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE)) == NULL) {
+        return fail("create_publisher");
+    }
+    wqos = DDS_DataWriterQos__alloc();
+    (void) DDS_Publisher_get_default_datawriter_qos(pub, wqos);
+    (void) DDS_Publisher_copy_from_topic_qos(pub, wqos, tqos);
+    writer = DDS_Publisher_create_datawriter(pub, topic, wqos, NULL, DDS_STATUS_MASK_NONE);
+    DDS_free(wqos);
+    if (writer == NULL) {
+        return fail("create_datawriter");
+    }
+
+    /* Wait (up to 30s) for the subscriber to be discovered */
+    do {
+        usleep(100000);
+        (void) DDS_DataWriter_get_publication_matched_status(writer, &status);
+    } while (status.current_count == 0 && ++tries < 300);
+    if (status.current_count == 0) {
+        return fail("discovery of the subscriber");
+    }
+    /* Matching is reported as soon as the remote reader is known here, give
+     * the subscriber's DDSI2 service time to learn about this writer too. */
+    sleep(1);
+
+    memset(&msg, 0, sizeof(msg));
+    msg.writer = (DDS_long) getpid();
+    msg.payload._buffer = DDS_sequence_octet_allocbuf(size);
+    msg.payload._length = size;
+    msg.payload._maximum = size;
+    for (i = 0; i < samples; i++) {
+        msg.seq = i;
+        for (j = 0; j < size; j++) {
+            msg.payload._buffer[j] = payloadByte(i, j);
+        }
+        if (TransportTest_MsgDataWriter_write(writer, &msg, DDS_HANDLE_NIL) != DDS_RETCODE_OK) {
+            return fail("write");
+        }
+    }
+    DDS_free(msg.payload._buffer);
+    if (DDS_DataWriter_wait_for_acknowledgments(writer, &ackTimeout) != DDS_RETCODE_OK) {
+        return fail("wait_for_acknowledgments");
+    }
+
+    /* The acknowledgments only cover the local part of the path: DDSI2 may
+     * still be retransmitting, so stay around until the subscriber has
+     * gone (up to 90s), which it does once it has everything. */
+    tries = 0;
+    do {
+        usleep(100000);
+        (void) DDS_DataWriter_get_publication_matched_status(writer, &status);
+    } while (status.current_count != 0 && ++tries < 900);
+    printf("transport_test: published %d samples of %u bytes\n", samples, size);
+    return 0;
+}
+
+static int
+subscribe(
+    DDS_DomainParticipant dp,
+    DDS_Topic topic,
+    const DDS_TopicQos *tqos,
+    DDS_long samples,
+    DDS_unsigned_long size)
+{
+    DDS_Subscriber sub;
+    DDS_DataReaderQos *rqos;
+    TransportTest_MsgDataReader reader;
+    DDS_sequence_TransportTest_Msg data = { 0, 0, NULL, FALSE };
+    DDS_SampleInfoSeq info = { 0, 0, NULL, FALSE };
+    DDS_long next = 0;
+    DDS_unsigned_long k, j;
+    int idle = 0, bad = 0;
+
+    if ((sub = DDS_DomainParticipant_create_subscriber(dp, DDS_SUBSCRIBER_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE)) == NULL) {
+        return fail("create_subscriber");
+    }
+    rqos = DDS_DataReaderQos__alloc();
+    (void) DDS_Subscriber_get_default_datareader_qos(sub, rqos);
+    (void) DDS_Subscriber_copy_from_topic_qos(sub, rqos, tqos);
+    reader = DDS_Subscriber_create_datareader(sub, topic, rqos, NULL, DDS_STATUS_MASK_NONE);
+    DDS_free(rqos);
+    if (reader == NULL) {
+        return fail("create_datareader");
+    }
+
+    /* Give up after 60s without data */
+    while (next < samples && idle < 1200) {
+        if (TransportTest_MsgDataReader_take(reader, &data, &info, DDS_LENGTH_UNLIMITED,
+                DDS_ANY_SAMPLE_STATE, DDS_ANY_VIEW_STATE, DDS_ANY_INSTANCE_STATE) == DDS_RETCODE_OK) {
+            for (k = 0; k < data._length; k++) {
+                if (!info._buffer[k].valid_data) {
+                    continue;
+                }
+                if (data._buffer[k].seq != next || data._buffer[k].payload._length != size) {
+                    bad++;
+                } else {
+                    for (j = 0; j < size; j++) {
+                        if (data._buffer[k].payload._buffer[j] != payloadByte(next, j)) {
+                            bad++;
+                            break;
+                        }
+                    }
+                }
+                next = data._buffer[k].seq + 1;
+            }
+            (void) TransportTest_MsgDataReader_return_loan(reader, &data, &info);
+            idle = 0;
+        } else {
+            usleep(50000);
+            idle++;
+        }
+    }
+    printf("transport_test: received %d of %d samples, %d bad\n", next, samples, bad);
+    return (next == samples && bad == 0) ? 0 : 1;
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+    DDS_DomainParticipantFactory factory;
+    DDS_DomainParticipant dp;
+    TransportTest_MsgTypeSupport ts;
+    DDS_TopicQos *tqos;
+    DDS_Topic topic;
+    DDS_long samples;
+    DDS_unsigned_long size;
+    char *typeName;
+    int result;
+
+    if (argc != 4 || (strcmp(argv[1], "pub") != 0 && strcmp(argv[1], "sub") != 0)) {
+        fprintf(stderr, "usage: %s pub|sub <samples> <payload size>\n", argv[0]);
+        return 2;
+    }
+    samples = (DDS_long) atoi(argv[2]);
+    size = (DDS_unsigned_long) atoi(argv[3]);
+
+    factory = DDS_DomainParticipantFactory_get_instance();
+    dp = DDS_DomainParticipantFactory_create_participant(factory, DDS_DOMAIN_ID_DEFAULT,
+            DDS_PARTICIPANT_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE);
+    if (dp == NULL) {
+        return fail("create_participant");
+    }
+    ts = TransportTest_MsgTypeSupport__alloc();
+    typeName = TransportTest_MsgTypeSupport_get_type_name(ts);
+    if (TransportTest_MsgTypeSupport_register_type(ts, dp, typeName) != DDS_RETCODE_OK) {
+        return fail("register_type");
+    }
+    tqos = DDS_TopicQos__alloc();
+    (void) DDS_DomainParticipant_get_default_topic_qos(dp, tqos);
+    tqos->reliability.kind = DDS_RELIABLE_RELIABILITY_QOS;
+    tqos->history.kind = DDS_KEEP_ALL_HISTORY_QOS;
+    topic = DDS_DomainParticipant_create_topic(dp, TOPIC_NAME, typeName, tqos, NULL, DDS_STATUS_MASK_NONE);
+    if (topic == NULL) {
+        return fail("create_topic");
+    }
+
+    if (strcmp(argv[1], "pub") == 0) {
+        result = publish(dp, topic, tqos, samples, size);
+    } else {
+        result = subscribe(dp, topic, tqos, samples, size);
+    }
+
+    DDS_free(tqos);
+    DDS_free(typeName);
+    DDS_free(ts);
+    (void) DDS_DomainParticipant_delete_contained_entities(dp);
+    (void) DDS_DomainParticipantFactory_delete_participant(factory, dp);
+    return result;
+}
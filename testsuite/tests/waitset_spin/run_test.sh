@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+# Deletes a waitset while a thread waiting on it is spinning, and checks
+# that neither the wait nor the deletion hangs.
+#
+# Requires a release.com'd environment (OSPL_HOME, OSPL_URI, idlpp on PATH)
+# and a C compiler. CC, CFLAGS and LDFLAGS override the way the test program
+# is built.
+
+if [ -z "$OSPL_HOME" ]; then
+    echo "OSPL_HOME not set"
+    exit 2
+fi
+
+SRC_DIR=`cd \`dirname $0\` && pwd`
+WORK_DIR=${WORK_DIR:-`mktemp -d`}
+mkdir -p $WORK_DIR
+cd $WORK_DIR || exit 2
+
+# Build the test program
+idlpp -S -l c $SRC_DIR/WaitsetSpinTest.idl || exit 2
+${CC:-cc} -o waitset_spin_test -I. $CFLAGS \
+    -I$OSPL_HOME/include -I$OSPL_HOME/include/sys -I$OSPL_HOME/include/dcps/C/SAC \
+    $SRC_DIR/waitset_spin_test.c WaitsetSpinTestSacDcps.c WaitsetSpinTestSplDcps.c \
+    $LDFLAGS -L$OSPL_HOME/lib -ldcpssac -lddskernel -lpthread || exit 2
+
+if ./waitset_spin_test; then
+    echo "PASS: waitset deleted while spinning"
+    exit 0
+fi
+echo "FAIL: waitset deleted while spinning (files in $WORK_DIR)"
+exit 1
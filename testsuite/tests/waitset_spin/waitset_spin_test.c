@@ -0,0 +1,139 @@
+/*
+ *                         OpenSplice DDS
+ *
+ *   This software and documentation are Copyright 2006 to TO_YEAR PrismTech
+ *   Limited, its affiliated companies and licensors. All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+/* Deletes a waitset while another thread waits on it and is still spinning
+ * (DDS_WaitSet_set_spin), and checks that both the wait and the deletion
+ * return promptly instead of the waiter looping or blocking until its
+ * timeout. The spin limit is fixed: an adaptive waitset does not spin until
+ * it has seen events.
+ */
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+#include "dds_dcps.h"
+#include "WaitsetSpinTest.h"
+
+/* The waiter must still be spinning when the waitset is deleted. */
+#define SPIN_LIMIT_SEC (10)
+#define WAIT_TIMEOUT_SEC (30)
+#define DELETE_AFTER_MSEC (200)
+/* Both the wait and the deletion must be done well within the spin limit. */
+#define MAX_RETURN_SEC (2.0)
+
+struct waiter {
+    DDS_WaitSet waitset;
+    DDS_ReturnCode_t result;
+    double returned;
+    int done;
+};
+
+static double
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void *
+waiter_main(void *arg)
+{
+    struct waiter *w = arg;
+    DDS_ConditionSeq *active = DDS_ConditionSeq__alloc();
+    DDS_Duration_t timeout = { WAIT_TIMEOUT_SEC, 0 };
+
+    w->result = DDS_WaitSet_wait(w->waitset, active, &timeout);
+    w->returned = now();
+    w->done = 1;
+    DDS_free(active);
+    return NULL;
+}
+
+int
+main(void)
+{
+    DDS_DomainParticipantFactory dpf;
+    DDS_DomainParticipant dp;
+    WaitsetSpinTest_MsgTypeSupport ts;
+    DDS_Topic tp;
+    DDS_Subscriber sub;
+    DDS_DataReader rd;
+    DDS_ReadCondition rc;
+    DDS_Duration_t limit = { SPIN_LIMIT_SEC, 0 };
+    DDS_ReturnCode_t result;
+    struct waiter w;
+    pthread_t tid;
+    double deleting, deleted;
+    char *typeName;
+    int ok = 1;
+
+    dpf = DDS_DomainParticipantFactory_get_instance();
+    dp = DDS_DomainParticipantFactory_create_participant(dpf, DDS_DOMAIN_ID_DEFAULT, DDS_PARTICIPANT_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE);
+    if (dp == NULL) {
+        printf("waitset_spin_test: could not create participant\n");
+        return 2;
+    }
+    ts = WaitsetSpinTest_MsgTypeSupport__alloc();
+    typeName = WaitsetSpinTest_MsgTypeSupport_get_type_name(ts);
+    WaitsetSpinTest_MsgTypeSupport_register_type(ts, dp, typeName);
+    tp = DDS_DomainParticipant_create_topic(dp, "WaitsetSpinTest", typeName, DDS_TOPIC_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE);
+    sub = DDS_DomainParticipant_create_subscriber(dp, DDS_SUBSCRIBER_QOS_DEFAULT, NULL, DDS_STATUS_MASK_NONE);
+    rd = DDS_Subscriber_create_datareader(sub, tp, DDS_DATAREADER_QOS_USE_TOPIC_QOS, NULL, DDS_STATUS_MASK_NONE);
+    /* Nothing is ever written, so the condition never triggers. */
+    rc = DDS_DataReader_create_readcondition(rd, DDS_ANY_SAMPLE_STATE, DDS_ANY_VIEW_STATE, DDS_ANY_INSTANCE_STATE);
+
+    w.waitset = DDS_WaitSet__alloc();
+    w.done = 0;
+    DDS_WaitSet_attach_condition(w.waitset, rc);
+    if ((result = DDS_WaitSet_set_spin(w.waitset, &limit, FALSE)) != DDS_RETCODE_OK) {
+        printf("waitset_spin_test: set_spin failed (%d)\n", (int)result);
+        return 2;
+    }
+
+    pthread_create(&tid, NULL, waiter_main, &w);
+    {
+        struct timespec delay = { 0, DELETE_AFTER_MSEC * 1000000 };
+        nanosleep(&delay, NULL);
+    }
+    if (w.done) {
+        printf("waitset_spin_test: wait returned (%d) before the waitset was deleted\n", (int)w.result);
+        ok = 0;
+    }
+    deleting = now();
+    DDS_free(w.waitset);
+    deleted = now();
+    pthread_join(tid, NULL);
+
+    printf("waitset_spin_test: delete took %.3f s, wait returned after %.3f s (%d)\n",
+           deleted - deleting,
+           w.returned - deleting, (int)w.result);
+    if (deleted - deleting > MAX_RETURN_SEC) {
+        ok = 0;
+    }
+    if (w.returned - deleting > MAX_RETURN_SEC || w.result == DDS_RETCODE_TIMEOUT) {
+        ok = 0;
+    }
+
+    DDS_DomainParticipant_delete_contained_entities(dp);
+    DDS_DomainParticipantFactory_delete_participant(dpf, dp);
+    DDS_free(ts);
+    DDS_free(typeName);
+    return ok ? 0 : 1;
+}